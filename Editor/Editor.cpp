@@ -72,6 +72,7 @@ const Uint8 *g_keyboardStates=NULL;	//Puntero que contendrá los estados de toda
 
 geWorld g_MyWorld;					//This is MY WORLD!
 geGUI *g_pMainGUI = NULL;			//Objeto de control del GUI de la aplicación
+geRenderQueue g_RenderQueue;		//Lista de comandos de dibujo de cada cuadro
 
 geVector2D g_MapMovementSpeed(1024.f,1024.f);	//Indica la velocidad (pixeles por segundo) a la que se desplaza la cámara del mapa (NOTA: Mover esto a opciones del juego)
 
@@ -124,8 +125,8 @@ void TW_CALL LoadMapFromFile(void * /*clientData*/)
 
 	//Revisamos si se debe de cargar un archivo de mapa
 	if( bMustLoad )
-	{//Si debe cargarse, así que mandamos llamar la función del mapa para esto
-		g_MyWorld.getTiledMap()->LoadFromImageFile(g_Renderer, FileName);
+	{//Si debe cargarse, así que pedimos al mundo que lo cargue en segundo plano (el mapa se irá mostrando conforme se carguen sus chunks)
+		g_MyWorld.StreamMapFromImageFile(FileName);
 	}
 
 	//Eliminamos el buffer de nombre de archivo
@@ -226,6 +227,9 @@ bool Init()
 					GEE_ERROR( TEXT("SDL_image no puede ser inicializado! SDL_image Error: ") + s2gs(IMG_GetError()) );
 					bExito = false;
 				}
+
+				//Inicializamos el cache de texturas compartidas con el renderer principal
+				g_TextureManager.Init( g_Renderer );
 			}
 
 			//Obtenemos la resolución de la ventana y la almacenamos globalmente
@@ -270,6 +274,8 @@ void Destroy()
 
 	//Aquí debemos destruir los objetos de la aplicación antes de destruir los objetos de SDL
 	g_MyWorld.Destroy();
+	g_RenderQueue.Clear();
+	g_TextureManager.Destroy();
 
 	//Destruimos el renderer y la ventana de SDL
 	SDL_DestroyRenderer( g_Renderer );
@@ -506,6 +512,9 @@ void Update(float deltaTime)
 	geVector2D numerotres;
 	numerotres = numerouno-numerodos;
 
+	//Subimos al renderer las texturas que el hilo de carga ya decodificó (con límite de tiempo para no detener el cuadro)
+	g_TextureManager.UpdateUploads();
+
 	//Primero actualizamos los datos de los inputs
 	UpdateInput();
 
@@ -571,11 +580,14 @@ void Render()
 	SDL_SetRenderDrawColor( g_Renderer, 0xFF, 0xFF, 0xFF, 0xFF );
 	SDL_RenderClear( g_Renderer );
 
+	//Todos los sistemas agregan sus comandos a la lista y al final se envían a SDL en una sola pasada
+	g_RenderQueue.Clear();
+
 	//Enviamos a renderear el mundo aquí
-	g_MyWorld.Render();
+	g_MyWorld.Render(g_RenderQueue);
 
 	//Pintamos un grid mostrando donde estamos parados en el mapa con el raton
-	SDL_SetRenderDrawColor(g_Renderer, 0xFF, 0xFF, 0x00, 0xFF);
+	SDL_Color cursorColor = { 0xFF, 0xFF, 0x00, 0xFF };
 
 	//Dibujamos el perímetro del tile en el que el ratón está parado actualmente
 	int32 posMapaX=0, posMapaY=0;
@@ -603,18 +615,37 @@ void Render()
 	diamondPoints[4].x = posScreenX+TILEHALFSIZE_X;
 	diamondPoints[4].y = posScreenY;
 
-	SDL_RenderDrawLines(g_Renderer, diamondPoints, 5);
+	g_RenderQueue.AddLines(RL_MAP_OVERLAY, diamondPoints, 5, cursorColor);
 #else	//Para el mapa cuadrado solo pintamos un rectángulo en el perímetro del tile
 	SDL_Rect tmpRect;
 	tmpRect.x = posScreenX;
 	tmpRect.y = posScreenY;
 	tmpRect.w = TILESIZE_X;
 	tmpRect.h = TILESIZE_Y;
-	SDL_RenderDrawRect(g_Renderer, &tmpRect);
+	g_RenderQueue.AddRect(RL_MAP_OVERLAY, tmpRect, cursorColor);
 #endif // MAP_IS_ISOMETRIC
 
 	//Imprimimos el GUI sobre todo lo demás
-	g_pMainGUI->Render();
+	g_pMainGUI->Render(g_RenderQueue);
+
+	//El minimapa va en la esquina inferior derecha del panel, escalado para caber sin deformarse
+	geMinimap* pMinimap = g_MyWorld.getMinimap();
+	if( pMinimap->getWidth() > 0 && pMinimap->getHeight() > 0 )
+	{
+		const int32 minimapMaxSize = 155;
+		float minimapScale = Min( (float)minimapMaxSize/pMinimap->getWidth(), (float)minimapMaxSize/pMinimap->getHeight() );
+		SDL_Rect minimapRect;
+		minimapRect.w = (int32)(pMinimap->getWidth()*minimapScale);
+		minimapRect.h = (int32)(pMinimap->getHeight()*minimapScale);
+		minimapRect.x = g_ResolutionX - minimapRect.w - 10;
+		minimapRect.y = g_ResolutionY - minimapRect.h - 10;
+		pMinimap->Render(g_RenderQueue, minimapRect);
+	}
+
+	//Ordenamos por capa y textura y enviamos todo a SDL
+	g_RenderQueue.Sort();
+	g_RenderQueue.Submit(g_Renderer);
+
 	TwDraw();	//Impresión del manejador de ventanas
 
 	//Actualizamos la pantalla
@@ -632,6 +663,19 @@ void SDL_ProcessEvent(const SDL_Event *e)
 	{//Este es un evento de teclado
 		//TODO: Determinamos si debemos procesar estos eventos ya que las actualizaciones las hacemos con el polling
 		//SDL_Log("KEYDOWN %d ", e->key.keysym.scancode );
+
+		//Atajos de deshacer y rehacer para las ediciones del mapa
+		if( e->key.keysym.mod & KMOD_CTRL )
+		{
+			if( e->key.keysym.sym == SDLK_z )
+			{
+				g_MyWorld.getEditHistory()->Undo();
+			}
+			else if( e->key.keysym.sym == SDLK_y )
+			{
+				g_MyWorld.getEditHistory()->Redo();
+			}
+		}
 	}
 #pragma endregion
 #pragma region SDL_KEYUP
@@ -649,7 +693,8 @@ void SDL_ProcessEvent(const SDL_Event *e)
 #pragma region SDL_MOUSEBUTTONUP
 	else if( e->type ==  SDL_MOUSEBUTTONUP )
 	{
-
+		//Soltar el botón termina el trazo en curso, todo lo que se pintó con él se deshace en un solo paso
+		g_MyWorld.EndMapEdit();
 	}
 #pragma endregion
 #pragma region SDL_WINDOWEVENT
@@ -719,6 +764,22 @@ void SDL_ProcessEvent(const SDL_Event *e)
 		}
 	}
 #pragma endregion
+#if SDL_VERSION_ATLEAST(2,0,2)
+#pragma region SDL_RENDER_TARGETS_RESET
+	else if( e->type == SDL_RENDER_TARGETS_RESET )
+	{//El dispositivo perdió el contenido de las texturas de render target, los chunks del terreno, la visualización del pathfinding y el GUI deben dibujarse de nuevo
+		if( g_MyWorld.getTiledMap() != NULL )
+		{
+			g_MyWorld.getTiledMap()->getChunkCache().Invalidate();
+		}
+		g_MyWorld.getWalkerDebugView()->Invalidate();
+		if( g_pMainGUI != NULL )
+		{
+			g_pMainGUI->InvalidateAll();
+		}
+	}
+#pragma endregion
+#endif
 }
 
 /************************************************************************************************************************/
@@ -21,8 +21,11 @@ geBreadthFirstSearchMapGridWalker::geBreadthFirstSearchMapGridWalker(void)
 	//Limpiamos variables miembro
 	m_n = NULL;
 	m_nodegrid = NULL;
+	m_nodegridSize = 0;
 	m_StartX = m_StartY = 0;
 	m_EndX = m_EndY = 0;
+	m_start = m_end = NULL;
+	m_bGoalReached = false;
 }
 
 geBreadthFirstSearchMapGridWalker::geBreadthFirstSearchMapGridWalker(geTiledMap *pMap) : geMapGridWalker(pMap) 
@@ -30,8 +33,11 @@ geBreadthFirstSearchMapGridWalker::geBreadthFirstSearchMapGridWalker(geTiledMap
 	//Limpiamos variables miembro
 	m_n = NULL;
 	m_nodegrid = NULL;
+	m_nodegridSize = 0;
 	m_StartX = m_StartY = 0;
 	m_EndX = m_EndY = 0;
+	m_start = m_end = NULL;
+	m_bGoalReached = false;
 }
 
 geBreadthFirstSearchMapGridWalker::~geBreadthFirstSearchMapGridWalker(void)
@@ -56,20 +62,25 @@ bool geBreadthFirstSearchMapGridWalker::Init()
 		4.- Reducir la matriz de visitados utilizando máscaras de bits
 	*/
 
-	//Alojamos nuevos nodos para el uso del algoritmo
-	m_nodegrid = GEE_NEW geMapTileNode*[m_pTiledMap->getMapSize()];
-	for(int32 i=0; i<m_pTiledMap->getMapSize(); i++)
+	//Alojamos nuevos nodos para el uso del algoritmo (un solo bloque con el mismo stride que los planos del mapa)
+	m_nodegridSize = m_pTiledMap->getMapHeight()<<m_pTiledMap->getMapStrideShift();
+	m_nodegrid = GEE_NEW geMapTileNode[m_nodegridSize];
+	for(int32 j=0; j<m_pTiledMap->getMapHeight(); j++)
 	{
-		m_nodegrid[i] = GEE_NEW geMapTileNode[m_pTiledMap->getMapSize()];
-		for(int32 j=0; j<m_pTiledMap->getMapSize(); j++)
+		for(int32 i=0; i<m_pTiledMap->getMapWidth(); i++)
 		{
 			//Establecemos posiciones y estado de no visitado a todos los nodos
-			m_nodegrid[i][j].setVisited(false);
-			m_nodegrid[i][j].m_x = i;
-			m_nodegrid[i][j].m_y = j;
+			geMapTileNode &node = m_nodegrid[m_pTiledMap->getTileIndex(i, j)];
+			node.setVisited(false);
+			node.m_x = i;
+			node.m_y = j;
 		}
 	}
 
+	//El plano de estados para la visualización tiene el mismo tamaño que la matriz de nodos
+	ResetTileStates();
+	SyncCostVersion();
+
 	return true;	//Si llegamos a este punto, todo salió bien
 }
 
@@ -78,35 +89,79 @@ void geBreadthFirstSearchMapGridWalker::Destroy()
 	//Destruimos los nodos de la matriz bidimensional
 	if(m_nodegrid != NULL)
 	{
-		for(int32 i = 0; i < m_pTiledMap->getMapSize(); i++)
-		{
-			GEE_DELETE_ARRAY(m_nodegrid[i]);
-		}
 		GEE_DELETE_ARRAY(m_nodegrid);
 	}
 
 	//Limpiamos punteros a los nodos
 	m_nodegrid = NULL;
+	m_nodegridSize = 0;
 	m_n = NULL;
+	m_start = m_end = NULL;
+	m_bGoalReached = false;
+	InvalidateOverlay();
+	ReleaseTileStates();
 }
 
-void geBreadthFirstSearchMapGridWalker::Render()
+void geBreadthFirstSearchMapGridWalker::Render(geRenderQueue& queue)
 {//Función utilizada para renderear información del nodo en pantalla
+	//Las líneas solo se generan otra vez si cambió la búsqueda, la cámara o el mapa
+	geOverlayKey key = m_pTiledMap->getOverlayKey(m_overlayVersion);
+	if( !m_overlay.isValid(key) )
+	{
+		SDL_Color startColor = { 0x00, 0xFF, 0x00, 0xFF };
+		SDL_Color endColor = { 0xFF, 0x00, 0x00, 0xFF };
+		SDL_Color pathColor = { 0xFF, 0xFF, 0x00, 0xFF };
 
+		m_overlay.Begin(key);
+		if( m_pTiledMap->isInside(m_StartX, m_StartY) )
+		{
+			AddTileMarker(m_StartX, m_StartY, startColor);
+		}
+		if( m_pTiledMap->isInside(m_EndX, m_EndY) )
+		{
+			AddTileMarker(m_EndX, m_EndY, endColor);
+		}
+		if( m_bGoalReached )
+		{
+			AddPathLine(m_end, m_start, m_nodegridSize, pathColor);
+		}
+	}
+
+	m_overlay.Submit(queue, RL_DEBUG);
 }
 
 geMapGridWalker::WALKSTATETYPE geBreadthFirstSearchMapGridWalker::Update()
 {//Función de actualización del algoritmo (calcula un paso a la vez del algoritmo)
+	if( m_start != NULL && isCostTableChanged() )
+	{//La tabla de costos de la clase cambió, lo calculado hasta ahora puede usar tiles que ya no son transitables
+		Reset();
+	}
+
 	//Revisamos si hay objetos en la lista abierta
 	if(m_open.size() > 0)
 	{//Hay objetos, por lo que podemos seguir calculando una ruta
 		m_n = (geMapTileNode*)m_open.front();	//Obtenemos el nodo actual para chequeos
 		m_open.pop();							//Sacamos este objeto de la lista abierta
 		m_n->setVisited(true);					//Marcamos este nodo como visitado
+		setTileState(m_pTiledMap->getTileIndex(m_n->m_x, m_n->m_y), WTS_CLOSED);
 
 		//Revisamos si el nodo está en la posición del objetivo
 		if(m_n->Equals(*m_end))
 		{//Este es el objetivo
+			m_bGoalReached = true;
+			InvalidateOverlay();	//La ruta ya se puede dibujar
+
+			//Marcamos los tiles de la ruta siguiendo los padres (no se limpian entre búsquedas, por eso limitamos el recorrido)
+			geMapTileNode* pNode = m_end;
+			for(int32 i=0; pNode != NULL && i<m_nodegridSize; i++)
+			{
+				setTileState(m_pTiledMap->getTileIndex(pNode->m_x, pNode->m_y), WTS_PATH);
+				if( pNode == m_start )
+				{
+					break;
+				}
+				pNode = pNode->m_parent;
+			}
 			return REACHEDGOAL;	//Indicamos que hemos llegado a la ruta pedida
 		}
 
@@ -114,11 +169,13 @@ geMapGridWalker::WALKSTATETYPE geBreadthFirstSearchMapGridWalker::Update()
 		int32 x, y;
 
 		//Agregamos todos los nodos adyacentes a este
+		const int32 lastX = m_pTiledMap->getMapWidth() - 1;
+		const int32 lastY = m_pTiledMap->getMapHeight() - 1;
 		
 		//Agregamos el nodo ESTE
 		x = m_n->m_x+1;
 		y = m_n->m_y;
-		if(m_n->m_x < (m_pTiledMap->getMapSize() - 1))
+		if(m_n->m_x < lastX)
 		{//Si no nos hemos salido del rango del mapa
 			visitGridNode(x, y);	//Visitamos el nodo
 		}
@@ -126,7 +183,7 @@ geMapGridWalker::WALKSTATETYPE geBreadthFirstSearchMapGridWalker::Update()
 		//Agregamos el nodo SUD-ESTE
 		x = m_n->m_x+1;
 		y = m_n->m_y+1;
-		if(m_n->m_x < (m_pTiledMap->getMapSize() - 1) && m_n->m_y < (m_pTiledMap->getMapSize() - 1))
+		if(m_n->m_x < lastX && m_n->m_y < lastY)
 		{//Si no nos hemos salido del rango del mapa
 			visitGridNode(x, y);	//Visitamos el nodo
 		}
@@ -134,7 +191,7 @@ geMapGridWalker::WALKSTATETYPE geBreadthFirstSearchMapGridWalker::Update()
 		//Agregamos el nodo SUR
 		x = m_n->m_x;
 		y = m_n->m_y+1;
-		if(m_n->m_y < (m_pTiledMap->getMapSize() - 1))
+		if(m_n->m_y < lastY)
 		{//Si no nos hemos salido del rango del mapa
 			visitGridNode(x, y);	//Visitamos el nodo
 		}
@@ -142,7 +199,7 @@ geMapGridWalker::WALKSTATETYPE geBreadthFirstSearchMapGridWalker::Update()
 		//Agregamos el nodo SUD-OESTE
 		x = m_n->m_x-1;
 		y = m_n->m_y+1;
-		if(m_n->m_y < (m_pTiledMap->getMapSize() - 1) && m_n->m_x > 0)
+		if(m_n->m_y < lastY && m_n->m_x > 0)
 		{//Si no nos hemos salido del rango del mapa
 			visitGridNode(x, y);	//Visitamos el nodo
 		}
@@ -174,7 +231,7 @@ geMapGridWalker::WALKSTATETYPE geBreadthFirstSearchMapGridWalker::Update()
 		//Agragamos el nodo NOR-ESTE
 		x = m_n->m_x+1;
 		y = m_n->m_y-1;
-		if(m_n->m_y > 0 && m_n->m_x < (m_pTiledMap->getMapSize() - 1))
+		if(m_n->m_y > 0 && m_n->m_x < lastX)
 		{//Si no nos hemos salido del rango del mapa
 			visitGridNode(x, y);	//Visitamos el nodo
 		}
@@ -188,16 +245,20 @@ geMapGridWalker::WALKSTATETYPE geBreadthFirstSearchMapGridWalker::Update()
 void geBreadthFirstSearchMapGridWalker::visitGridNode(int32 x, int32 y)
 {//Esta función "visita" un nodo, esto es para saber si debe agregarse a la lista abierta para su chequeo en el futuro
 	// if the node is blocked or has been visited, early out
-	if( m_pTiledMap->getCost(x, y) == TILENODE_BLOCKED || m_nodegrid[x][y].getVisited() )
-	{//Si este nodo está bloqueado o ya fue visitado
+	geMapTileNode &node = m_nodegrid[m_pTiledMap->getTileIndex(x, y)];
+	//NOTA: Las unidades de un tile se revisan con la transitabilidad de su clase, las más grandes con el clearance de su clase (que ya incluye la transitabilidad del tile)
+	bool bBlocked = (m_unitSize == 1) ? !m_pTiledMap->isPassable(m_movementClass, x, y) : (m_pTiledMap->getClearance(m_movementClass, x, y) < m_unitSize);
+	if( !m_pTiledMap->isTileReady(x, y) || bBlocked || node.getVisited() )
+	{//Si este nodo aún no se carga, no tiene espacio para la unidad o ya fue visitado
 		return;	//Regresamos sin hacer nada
 	}
 
 	//Marcamos este nodo como visitable agregándolo a la lista abierta
-	m_open.push( &m_nodegrid[x][y] );
+	m_open.push( &node );
+	setTileState(m_pTiledMap->getTileIndex(x, y), WTS_OPEN);
 
 	//Tambien marcamos que el nodo en chequeo actual es el padre de este nodo
-	m_nodegrid[x][y].m_parent = m_n;
+	node.m_parent = m_n;
 }
 
 void geBreadthFirstSearchMapGridWalker::Reset()
@@ -210,30 +271,34 @@ void geBreadthFirstSearchMapGridWalker::Reset()
 
 	//Establecemos que no hay un nodo actual en chequeo
 	m_n = NULL;
+	m_bGoalReached = false;
+	InvalidateOverlay();
+	SyncCostVersion();
 
 	//Revisamos que los nodos ya hayan sido creado (Solo en modo Debug)
 	GEE_ASSERT( m_nodegrid );
 
 	//Para este punto los nodos ya están creados, solo limpiamos la bandera de visitado a false en todos
-	for(int32 i=0; i<m_pTiledMap->getMapSize(); i++)
+	for(int32 i=0; i<m_nodegridSize; i++)
 	{
-		for(int j=0; j<m_pTiledMap->getMapSize(); j++)
-		{
-			m_nodegrid[i][j].setVisited(false);
-		}
+		m_nodegrid[i].setVisited(false);
 	}
 
 	//Obtenemos el punto de inicio, lo marcamos como visitado y lo establecemos como el nodo inicial
 	int x, y;
 	getStartPosition(x, y);
-	m_start = &m_nodegrid[x][y];
+	m_start = &m_nodegrid[m_pTiledMap->getTileIndex(x, y)];
 	m_start->setVisited(true);
 
 	//Obtenemos el punto final, obtenemos el nodo y lo marcamos como el nodo final
 	getEndPosition(x, y);
-	m_end = &m_nodegrid[x][y];
+	m_end = &m_nodegrid[m_pTiledMap->getTileIndex(x, y)];
 
 	//Agregamos el nodo inicial a la lista abierta
 	m_open.push(m_start);
+
+	//Empezamos la visualización de cero con el nodo inicial abierto
+	ResetTileStates();
+	setTileState(m_pTiledMap->getTileIndex(m_start->m_x, m_start->m_y), WTS_OPEN);
 }
 
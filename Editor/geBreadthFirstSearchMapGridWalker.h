@@ -32,7 +32,7 @@ public:
 	virtual bool Init();										//Función de inicialización de la clase (crea los objetos para su uso posterior)
 	virtual void Destroy();										//Destruye los objetos de la clase (despues de llamarlo, las llamadas a otras funciones son inválidas)
 	virtual WALKSTATETYPE Update();								//Actualiza el estado del pathfinding (puede hacerse por pasos o recursivamente)
-	virtual void Render();										//Renderea la información necesaria para su uso en pathfinding
+	virtual void Render(geRenderQueue& queue);					//Agrega el inicio, el fin y la ruta encontrada a la capa de depuración
 	virtual void Reset();										//Reinicializa las variables de esta clase para su uso en un nuevo cálculo
 
 	virtual bool weightedGraphSupported(){ return false; }		//Indica si este Walker soporta la asignación y el uso de pesos a los nodos del graph
@@ -46,5 +46,7 @@ protected:
 private:
 	std::queue<geMapTileNode*> m_open;			//Nuestra lista abierta utilizando un queue ordinario
 	geMapTileNode *m_start, *m_n, *m_end;		//Punteros a los nodos de inicio, uso y final
-	geMapTileNode **m_nodegrid;					//Matriz para almacenamiento de los nodos del mapa
+	geMapTileNode *m_nodegrid;					//Matriz para almacenamiento de los nodos del mapa (se indexa igual que los planos del mapa)
+	int32 m_nodegridSize;						//Número de nodos con el que se alojó la matriz (el mapa puede reinicializarse con otro tamaño)
+	bool m_bGoalReached;						//Indica si la última búsqueda llegó al objetivo (la ruta se puede dibujar)
 };
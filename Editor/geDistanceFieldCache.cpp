@@ -0,0 +1,271 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geDistanceFieldCache.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geDistanceFieldCache
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geDistanceFieldCache.h"
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geDistanceFieldCache::geDistanceFieldCache(void)
+{//Constructor standard
+	m_pMap = NULL;
+	m_mapVersion = 0;
+	memset(m_costVersion, 0, sizeof(m_costVersion));
+	m_width = m_height = 0;
+}
+
+geDistanceFieldCache::~geDistanceFieldCache(void)
+{//Destructor
+	Destroy();
+}
+
+bool geDistanceFieldCache::Init(geTiledMap* pMap)
+{//Asocia el cache a un mapa
+	GEE_ASSERT(pMap);
+	Destroy();
+
+	m_pMap = pMap;
+	m_mapVersion = pMap->getVersion();
+	for( int32 mc=0; mc<MC_NUM_CLASSES; ++mc )
+	{
+		m_costVersion[mc] = pMap->getCostVersion((eMovementClass)mc);
+	}
+	m_width = pMap->getMapWidth();
+	m_height = pMap->getMapHeight();
+
+	return true;
+}
+
+void geDistanceFieldCache::Destroy()
+{//Elimina todos los campos
+	m_fields.clear();
+	m_freeFields.clear();
+	for( int32 i=0; i<DISTANCE_NUM_BUCKETS; ++i )
+	{
+		m_buckets[i].clear();
+	}
+	m_pMap = NULL;
+}
+
+void geDistanceFieldCache::Update()
+{//Marca como obsoletos los campos afectados por los cambios del mapa
+	if( m_pMap == NULL )
+	{
+		return;
+	}
+
+	//Un cambio en la tabla de costos de una clase cambia las distancias de todos sus campos
+	for( int32 mc=0; mc<MC_NUM_CLASSES; ++mc )
+	{
+		uint32 costVersion = m_pMap->getCostVersion((eMovementClass)mc);
+		if( costVersion != m_costVersion[mc] )
+		{
+			for( SIZE_T i=0; i<m_fields.size(); ++i )
+			{
+				if( m_fields[i].mc == mc )
+				{
+					m_fields[i].bStale = true;
+				}
+			}
+			m_costVersion[mc] = costVersion;
+		}
+	}
+
+	if( m_pMap->getVersion() == m_mapVersion )
+	{
+		return;
+	}
+
+	std::vector<geMapRegion> regions;
+	if( m_pMap->getMapWidth() != m_width || m_pMap->getMapHeight() != m_height )
+	{//El mapa fue reinicializado, los objetivos ya no tienen sentido con el nuevo tamaño
+		m_width = m_pMap->getMapWidth();
+		m_height = m_pMap->getMapHeight();
+		for( SIZE_T i=0; i<m_fields.size(); ++i )
+		{
+			m_fields[i].targets.clear();
+			m_fields[i].bStale = true;
+		}
+	}
+	else if( !m_pMap->getDirtyRegionsSince(m_mapVersion, regions) )
+	{//Hubo demasiados cambios, recalculamos todos los campos al consultarlos
+		for( SIZE_T i=0; i<m_fields.size(); ++i )
+		{
+			m_fields[i].bStale = true;
+		}
+	}
+	else
+	{//Un cambio solo puede alterar el campo si toca un tile alcanzado o vecino de uno alcanzado
+		for( SIZE_T i=0; i<m_fields.size(); ++i )
+		{
+			Field& field = m_fields[i];
+			for( SIZE_T j=0; j<regions.size() && !field.bStale; ++j )
+			{
+				field.bStale = regions[j].Intersects(field.reached);
+			}
+		}
+	}
+
+	m_mapVersion = m_pMap->getVersion();
+}
+
+int32 geDistanceFieldCache::AddField(const eMovementClass mc)
+{//Crea un campo vacío
+	GEE_ASSERT(m_pMap);
+
+	int32 field;
+	if( !m_freeFields.empty() )
+	{
+		field = m_freeFields.back();
+		m_freeFields.pop_back();
+	}
+	else
+	{
+		field = (int32)m_fields.size();
+		m_fields.push_back( Field() );
+	}
+
+	Field& f = m_fields[field];
+	f.mc = mc;
+	f.bActive = true;
+	f.bStale = true;
+	f.targets.clear();
+	f.reached = geMapRegion();
+
+	return field;
+}
+
+void geDistanceFieldCache::RemoveField(const int32 field)
+{//Elimina un campo
+	GEE_ASSERT( field >= 0 && field < (int32)m_fields.size() && m_fields[field].bActive );
+
+	Field& f = m_fields[field];
+	f.bActive = false;
+	f.bStale = false;
+	f.targets.clear();
+	f.distances.clear();
+	f.reached = geMapRegion();
+	m_freeFields.push_back(field);
+}
+
+void geDistanceFieldCache::AddTarget(const int32 field, const int32 x, const int32 y)
+{//Agrega un tile objetivo al campo
+	GEE_ASSERT( field >= 0 && field < (int32)m_fields.size() && m_fields[field].bActive );
+	GEE_ASSERT( x >= 0 && x < m_width && y >= 0 && y < m_height );
+
+	m_fields[field].targets.push_back( m_pMap->getTileIndex(x, y) );
+	m_fields[field].bStale = true;
+}
+
+void geDistanceFieldCache::RemoveTarget(const int32 field, const int32 x, const int32 y)
+{//Quita un tile objetivo del campo
+	GEE_ASSERT( field >= 0 && field < (int32)m_fields.size() && m_fields[field].bActive );
+
+	std::vector<int32>& targets = m_fields[field].targets;
+	std::vector<int32>::iterator it = std::find(targets.begin(), targets.end(), m_pMap->getTileIndex(x, y));
+	if( it != targets.end() )
+	{
+		*it = targets.back();
+		targets.pop_back();
+		m_fields[field].bStale = true;
+	}
+}
+
+void geDistanceFieldCache::ClearTargets(const int32 field)
+{//Quita todos los objetivos del campo
+	GEE_ASSERT( field >= 0 && field < (int32)m_fields.size() && m_fields[field].bActive );
+
+	m_fields[field].targets.clear();
+	m_fields[field].bStale = true;
+}
+
+const uint16* geDistanceFieldCache::getDistanceRow(const int32 field, const int32 y)
+{//Distancias de una fila completa del campo
+	Field& f = m_fields[field];
+	if( f.bStale )
+	{
+		Refresh(f);
+	}
+	return &f.distances[m_pMap->getTileIndex(0, y)];
+}
+
+void geDistanceFieldCache::Refresh(Field& field)
+{//Recalcula el campo con un Dijkstra de múltiples orígenes
+	//Los costos son enteros pequeños, así que en lugar de un heap usamos una cola circular de cubetas indexada por distancia
+	static const int32 offsetX[8] = { 1, 1, 0,-1,-1,-1, 0, 1 };
+	static const int32 offsetY[8] = { 0, 1, 1, 1, 0,-1,-1,-1 };
+
+	field.distances.assign( m_pMap->getMapStride()*m_height, DISTANCE_UNREACHABLE );
+	field.reached = geMapRegion();
+	field.bStale = false;
+
+	//Sembramos los objetivos (los tiles bloqueados o sin cargar no alcanzan nada, pero su cambio debe invalidar el campo)
+	int32 numPending = 0;
+	for( SIZE_T i=0; i<field.targets.size(); ++i )
+	{
+		int32 index = field.targets[i];
+		int32 x = m_pMap->getTileIndexX(index), y = m_pMap->getTileIndexY(index);
+		field.reached.Merge( geMapRegion(x, y, x, y) );
+		if( field.distances[index] != 0 && m_pMap->isTileReady(x, y) && m_pMap->isPassable(field.mc, x, y) )
+		{
+			field.distances[index] = 0;
+			m_buckets[0].push_back(index);
+			++numPending;
+		}
+	}
+
+	for( uint32 distance=0; numPending > 0; ++distance )
+	{
+		std::vector<int32>& bucket = m_buckets[distance & (DISTANCE_NUM_BUCKETS-1)];
+		for( SIZE_T i=0; i<bucket.size(); ++i )
+		{
+			int32 index = bucket[i];
+			--numPending;
+			if( field.distances[index] != distance )
+			{//Ya se encontró un camino más corto a este tile
+				continue;
+			}
+
+			int32 x = m_pMap->getTileIndexX(index), y = m_pMap->getTileIndexY(index);
+			field.reached.Merge( geMapRegion(x, y, x, y) );
+
+			for( int32 dir=0; dir<8; ++dir )
+			{
+				int32 nx = x+offsetX[dir], ny = y+offsetY[dir];
+				if( nx < 0 || ny < 0 || nx >= m_width || ny >= m_height || !m_pMap->isTileReady(nx, ny) || !m_pMap->isPassable(field.mc, nx, ny) )
+				{
+					continue;
+				}
+
+				//El costo de un paso es el costo de entrar al tile, los pasos diagonales cuestan 1.5 veces más
+				uint32 step = (uint32)Max<int32>(m_pMap->getCost(nx, ny, field.mc), 1);
+				if( dir & 1 )
+				{
+					step += step>>1;
+				}
+
+				uint32 newDistance = distance + step;
+				int32 nIndex = m_pMap->getTileIndex(nx, ny);
+				if( newDistance < field.distances[nIndex] )
+				{//Las distancias que no caben en 16 bits se quedan como inalcanzables
+					field.distances[nIndex] = (uint16)newDistance;
+					m_buckets[newDistance & (DISTANCE_NUM_BUCKETS-1)].push_back(nIndex);
+					++numPending;
+				}
+			}
+		}
+		bucket.clear();
+	}
+
+	//Cualquier cambio en un vecino de los tiles alcanzados también puede alterar el campo
+	field.reached.Expand(1);
+}
@@ -0,0 +1,101 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geDistanceFieldCache.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geDistanceFieldCache
+				Guarda campos de distancia sobre un geTiledMap hacia
+				grupos de objetivos usados con frecuencia (centros de
+				población, recursos, pasos estrechos). Cada campo se
+				calcula con un Dijkstra de múltiples orígenes y solo se
+				recalcula, al consultarlo, si un cambio del mapa tocó el
+				área que alcanza
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geTiledMap.h"
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define DISTANCE_UNREACHABLE	0xFFFF		//Distancia de los tiles que no pueden alcanzar ningún objetivo
+#define DISTANCE_INVALID_FIELD	-1			//Identificador de campo inválido
+#define DISTANCE_NUM_BUCKETS	256			//Cubetas de la cola de Dijkstra (potencia de 2 mayor que el costo máximo de un paso)
+
+/************************************************************************************************************************/
+/* Declaración de la clase geDistanceFieldCache                         												*/
+/************************************************************************************************************************/
+class geDistanceFieldCache : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geDistanceFieldCache(void);					//Constructor standard
+	~geDistanceFieldCache(void);				//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de inicialización y actualización                          												*/
+	/************************************************************************************************************************/
+public:
+	bool Init(geTiledMap* pMap);				//Asocia el cache a un mapa
+	void Destroy();								//Elimina todos los campos
+	void Update();								//Marca como obsoletos los campos afectados por los cambios del mapa (no recalcula nada)
+
+	/************************************************************************************************************************/
+	/* Funciones de control de campos y objetivos                           												*/
+	/************************************************************************************************************************/
+public:
+	int32 AddField(const eMovementClass mc = MC_INFANTRY);					//Crea un campo vacío y regresa su identificador
+	void RemoveField(const int32 field);									//Elimina un campo
+	void AddTarget(const int32 field, const int32 x, const int32 y);		//Agrega un tile objetivo al campo
+	void RemoveTarget(const int32 field, const int32 x, const int32 y);		//Quita un tile objetivo del campo
+	void ClearTargets(const int32 field);									//Quita todos los objetivos del campo
+
+	/************************************************************************************************************************/
+	/* Funciones de consulta (recalculan el campo si está obsoleto)         												*/
+	/* La distancia es la suma de los costos de los tiles recorridos hasta el objetivo más cercano (diagonal = costo*1.5)	*/
+	/************************************************************************************************************************/
+public:
+	FORCEINLINE uint16 getDistance(const int32 field, const int32 x, const int32 y)
+	{
+		Field& f = m_fields[field];
+		if( f.bStale ) Refresh(f);
+		return f.distances[m_pMap->getTileIndex(x, y)];
+	}
+
+	const uint16* getDistanceRow(const int32 field, const int32 y);			//Distancias de una fila completa del campo
+	bool isStale(const int32 field) const { return m_fields[field].bStale; }
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	struct Field
+	{
+		eMovementClass mc;				//Clase de movimiento con la que se calculan los costos
+		bool bActive;					//Indica si este espacio está en uso
+		bool bStale;					//Indica que debe recalcularse antes de la siguiente consulta
+		std::vector<int32> targets;		//Índices de tile de los objetivos
+		std::vector<uint16> distances;	//Distancia de cada tile (indexado con el índice de tile del mapa)
+		geMapRegion reached;			//Área que contiene los objetivos y los tiles alcanzados, más un tile de borde
+	};
+
+	void Refresh(Field& field);			//Recalcula el campo con un Dijkstra de múltiples orígenes (cola de cubetas)
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	geTiledMap *m_pMap;							//Mapa asociado
+	uint32 m_mapVersion;						//Versión del mapa con la que se revisaron los cambios
+	uint32 m_costVersion[MC_NUM_CLASSES];		//Versión de la tabla de costos de cada clase con la que se revisaron los cambios
+	int32 m_width, m_height;					//Tamaño del mapa con el que se alojaron los campos
+
+	std::vector<Field> m_fields;				//Campos (los espacios libres se reutilizan)
+	std::vector<int32> m_freeFields;			//Espacios libres en la lista de campos
+	std::vector<int32> m_buckets[DISTANCE_NUM_BUCKETS];	//Cola de Dijkstra indexada por distancia (compartida por todos los campos)
+};
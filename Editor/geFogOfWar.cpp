@@ -0,0 +1,392 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geFogOfWar.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geFogOfWar
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geFogOfWar.h"
+
+/************************************************************************************************************************/
+/* Transformaciones de los 8 octantes para el shadowcasting (xx, xy, yx, yy)											*/
+/************************************************************************************************************************/
+static const int32 s_octantTransform[8][4] =
+{
+	{ 1,  0,  0,  1}, { 0,  1,  1,  0}, { 0, -1,  1,  0}, {-1,  0,  0,  1},
+	{-1,  0,  0, -1}, { 0, -1, -1,  0}, { 0,  1, -1,  0}, { 1,  0,  0, -1}
+};
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geFogOfWar::geFogOfWar(void)
+{//Constructor standard
+	m_pMap = NULL;
+	m_mapVersion = 0;
+	m_width = m_height = 0;
+	m_rowWords = 0;
+	m_stampValue = 0;
+
+	//Precalculamos las máscaras de círculo de cada radio (se usa r*r+r para que los círculos se vean redondos y no con picos en los ejes)
+	for( int32 radius=0; radius<=FOW_MAX_RADIUS; ++radius )
+	{
+		m_circleSpans[radius].resize(radius+1);
+		for( int32 dy=0; dy<=radius; ++dy )
+		{
+			m_circleSpans[radius][dy] = (uint8)Trunc( sqrtf( (float)((radius*radius)+radius-(dy*dy)) ) );
+		}
+	}
+}
+
+geFogOfWar::~geFogOfWar(void)
+{//Destructor
+	Destroy();
+}
+
+bool geFogOfWar::Init(geTiledMap* pMap, const int32 numPlayers)
+{//Asocia la visibilidad a un mapa
+	GEE_ASSERT(pMap);
+	GEE_ASSERT( numPlayers > 0 && numPlayers <= FOW_MAX_PLAYERS );
+
+	Destroy();
+	m_pMap = pMap;
+	m_players.resize(numPlayers);
+	RebuildGrids();
+	PublishChanges();
+
+	return true;
+}
+
+void geFogOfWar::Destroy()
+{//Libera todos los datos
+	m_players.clear();
+	m_viewers.clear();
+	m_freeViewers.clear();
+	m_opaqueBits.clear();
+	m_stamp.clear();
+	m_width = m_height = 0;
+	m_rowWords = 0;
+	m_pMap = NULL;
+}
+
+void geFogOfWar::RebuildGrids()
+{//Realoja los datos para el tamaño actual del mapa (la visión y lo explorado anterior se pierden)
+	m_width = m_pMap->getMapWidth();
+	m_height = m_pMap->getMapHeight();
+	m_rowWords = (m_width+63)>>6;
+	int32 numTiles = m_height<<m_pMap->getMapStrideShift();
+
+	m_opaqueBits.assign(m_rowWords*m_height, 0);
+	for( SIZE_T i=0; i<m_players.size(); ++i )
+	{
+		m_players[i].refCount.assign(numTiles, 0);
+		m_players[i].explored.assign((numTiles+63)>>6, 0);
+		m_players[i].pendingChange = geMapRegion(0, 0, m_width-1, m_height-1);	//Toda la visión cambió
+	}
+	m_stamp.assign(numTiles, 0);
+	m_stampValue = 0;
+
+	UpdateOpaque( geMapRegion(0, 0, m_width-1, m_height-1) );
+	m_mapVersion = m_pMap->getVersion();
+
+	//Los observadores siguen existiendo, pero su visión debe calcularse otra vez sobre el nuevo mapa
+	for( SIZE_T i=0; i<m_viewers.size(); ++i )
+	{
+		Viewer& viewer = m_viewers[i];
+		viewer.tiles.clear();
+		viewer.lit = geMapRegion();
+		if( viewer.bActive )
+		{
+			viewer.x = Clamp(viewer.x, 0, m_width-1);
+			viewer.y = Clamp(viewer.y, 0, m_height-1);
+			viewer.bDirty = true;
+		}
+	}
+}
+
+void geFogOfWar::UpdateOpaque(const geMapRegion& region)
+{//Recalcula los bits de opacidad de la región
+	for( int32 tmpY=region.minY; tmpY<=region.maxY; ++tmpY )
+	{
+		const uint8* pTypeRow = m_pMap->getTypeRow(tmpY);
+		uint64* pOpaqueRow = &m_opaqueBits[tmpY*m_rowWords];
+		for( int32 tmpX=region.minX; tmpX<=region.maxX; ++tmpX )
+		{
+			uint64 bit = (uint64)1 << (tmpX&63);
+			pOpaqueRow[tmpX>>6] = isTerrainOpaque(pTypeRow[tmpX]) ? (pOpaqueRow[tmpX>>6] | bit) : (pOpaqueRow[tmpX>>6] & ~bit);
+		}
+	}
+}
+
+void geFogOfWar::Update()
+{//Recalcula la visibilidad de los observadores pendientes
+	if( m_pMap == NULL )
+	{
+		return;
+	}
+
+	if( m_pMap->getVersion() != m_mapVersion )
+	{//El mapa cambió, actualizamos la opacidad y marcamos los observadores que pueden ver los tiles modificados
+		std::vector<geMapRegion> regions;
+		if( m_pMap->getMapWidth() != m_width || m_pMap->getMapHeight() != m_height )
+		{//El mapa cambió de tamaño, reconstruimos todo
+			RebuildGrids();
+		}
+		else
+		{
+			if( !m_pMap->getDirtyRegionsSince(m_mapVersion, regions) )
+			{//Hubo demasiados cambios para el journal, revisamos el mapa completo (la visión y lo explorado se conservan)
+				regions.assign( 1, geMapRegion(0, 0, m_width-1, m_height-1) );
+			}
+
+			for( SIZE_T i=0; i<regions.size(); ++i )
+			{
+				UpdateOpaque(regions[i]);
+				for( SIZE_T j=0; j<m_viewers.size(); ++j )
+				{
+					Viewer& viewer = m_viewers[j];
+					if( viewer.bActive && !viewer.bDirty &&
+						regions[i].Intersects( geMapRegion(viewer.x-viewer.radius, viewer.y-viewer.radius, viewer.x+viewer.radius, viewer.y+viewer.radius) ) )
+					{
+						viewer.bDirty = true;
+					}
+				}
+			}
+			m_mapVersion = m_pMap->getVersion();
+		}
+	}
+
+	//Recalculamos solo los observadores que se movieron o que ven tiles modificados
+	for( SIZE_T i=0; i<m_viewers.size(); ++i )
+	{
+		Viewer& viewer = m_viewers[i];
+		if( viewer.bActive && viewer.bDirty )
+		{
+			ClearViewer(viewer);
+			ComputeViewer(viewer);
+			viewer.bDirty = false;
+		}
+	}
+
+	PublishChanges();
+}
+
+void geFogOfWar::PublishChanges()
+{//Los cambios acumulados (incluidos los de observadores retirados fuera de Update()) forman una nueva versión
+	for( SIZE_T i=0; i<m_players.size(); ++i )
+	{
+		PlayerVision& vision = m_players[i];
+		if( !vision.pendingChange.isEmpty() )
+		{
+			++vision.version;
+			vision.lastChange = vision.pendingChange;
+			vision.pendingChange = geMapRegion();
+		}
+	}
+}
+
+bool geFogOfWar::getVisionChangesSince(const int32 player, const uint32 version, geMapRegion& region) const
+{//Solo guardamos el último cambio, un consumidor más atrasado debe revisar todo
+	const PlayerVision& vision = m_players[player];
+	if( version == vision.version )
+	{
+		region = geMapRegion();
+		return true;
+	}
+	if( version+1 == vision.version )
+	{
+		region = vision.lastChange;
+		return true;
+	}
+	return false;
+}
+
+int32 geFogOfWar::AddViewer(const int32 player, const int32 x, const int32 y, const int32 radius)
+{//Agrega un observador
+	GEE_ASSERT( m_pMap != NULL );
+	GEE_ASSERT( player >= 0 && player < (int32)m_players.size() );
+
+	int32 index;
+	if( !m_freeViewers.empty() )
+	{//Reutilizamos un espacio libre
+		index = m_freeViewers.back();
+		m_freeViewers.pop_back();
+	}
+	else
+	{
+		index = (int32)m_viewers.size();
+		m_viewers.push_back( Viewer() );
+	}
+
+	Viewer& viewer = m_viewers[index];
+	viewer.player = player;
+	viewer.x = Clamp(x, 0, m_width-1);
+	viewer.y = Clamp(y, 0, m_height-1);
+	viewer.radius = Clamp(radius, 0, FOW_MAX_RADIUS);
+	viewer.bActive = true;
+	viewer.bDirty = true;
+	viewer.tiles.clear();
+
+	return index;
+}
+
+void geFogOfWar::RemoveViewer(const int32 viewer)
+{//Elimina un observador
+	GEE_ASSERT( viewer >= 0 && viewer < (int32)m_viewers.size() && m_viewers[viewer].bActive );
+
+	ClearViewer(m_viewers[viewer]);
+	m_viewers[viewer].bActive = false;
+	m_freeViewers.push_back(viewer);
+}
+
+void geFogOfWar::MoveViewer(const int32 viewer, const int32 x, const int32 y)
+{//Cambia la posición de un observador
+	GEE_ASSERT( viewer >= 0 && viewer < (int32)m_viewers.size() && m_viewers[viewer].bActive );
+
+	Viewer& v = m_viewers[viewer];
+	int32 newX = Clamp(x, 0, m_width-1);
+	int32 newY = Clamp(y, 0, m_height-1);
+	if( newX != v.x || newY != v.y )
+	{//Solo se recalcula si cambió de tile
+		v.x = newX;
+		v.y = newY;
+		v.bDirty = true;
+	}
+}
+
+void geFogOfWar::setViewerRadius(const int32 viewer, const int32 radius)
+{//Cambia el radio de visión de un observador
+	GEE_ASSERT( viewer >= 0 && viewer < (int32)m_viewers.size() && m_viewers[viewer].bActive );
+
+	Viewer& v = m_viewers[viewer];
+	int32 newRadius = Clamp(radius, 0, FOW_MAX_RADIUS);
+	if( newRadius != v.radius )
+	{
+		v.radius = newRadius;
+		v.bDirty = true;
+	}
+}
+
+void geFogOfWar::ClearViewer(Viewer& viewer)
+{//Retira la visión actual del observador
+	uint16* pRefCount = &m_players[viewer.player].refCount[0];
+	for( SIZE_T i=0; i<viewer.tiles.size(); ++i )
+	{
+		GEE_ASSERT( pRefCount[viewer.tiles[i]] > 0 );
+		--pRefCount[viewer.tiles[i]];
+	}
+	viewer.tiles.clear();
+
+	m_players[viewer.player].pendingChange.Merge(viewer.lit);
+	viewer.lit = geMapRegion();
+}
+
+void geFogOfWar::ComputeViewer(Viewer& viewer)
+{//Calcula la visión del observador con shadowcasting recursivo en los 8 octantes
+	//Cambiamos el valor de marca para este cálculo (si da la vuelta limpiamos las marcas)
+	if( ++m_stampValue == 0 )
+	{
+		std::fill(m_stamp.begin(), m_stamp.end(), 0);
+		m_stampValue = 1;
+	}
+
+	//El tile del observador siempre es visible
+	LightTile(viewer, viewer.x, viewer.y);
+
+	//Todo lo que vea queda dentro de su radio
+	viewer.lit = geMapRegion(viewer.x-viewer.radius, viewer.y-viewer.radius, viewer.x+viewer.radius, viewer.y+viewer.radius);
+	viewer.lit.Clip(m_width, m_height);
+	m_players[viewer.player].pendingChange.Merge(viewer.lit);
+
+	for( int32 octant=0; octant<8; ++octant )
+	{
+		CastLight(viewer, 1, 1.0f, 0.0f, s_octantTransform[octant][0], s_octantTransform[octant][1], s_octantTransform[octant][2], s_octantTransform[octant][3]);
+	}
+}
+
+void geFogOfWar::CastLight(Viewer& viewer, const int32 row, float start, const float end, const int32 xx, const int32 xy, const int32 yx, const int32 yy)
+{//Recorre un octante fila por fila, las pendientes start y end limitan la parte del octante que aún no está tapada
+	if( start < end )
+	{
+		return;
+	}
+
+	const uint8* pSpans = &m_circleSpans[viewer.radius][0];
+	float newStart = 0.0f;
+	for( int32 j=row; j<=viewer.radius; ++j )
+	{
+		bool bBlocked = false;
+		int32 dy = -j;
+		for( int32 dx=-j; dx<=0; ++dx )
+		{
+			//Pendientes de las esquinas del tile respecto al centro del observador
+			float leftSlope = (dx-0.5f)/(dy+0.5f);
+			float rightSlope = (dx+0.5f)/(dy-0.5f);
+			if( start < rightSlope )
+			{
+				continue;
+			}
+			else if( end > leftSlope )
+			{
+				break;
+			}
+
+			int32 mapX = viewer.x + (dx*xx) + (dy*xy);
+			int32 mapY = viewer.y + (dx*yx) + (dy*yy);
+
+			//Fuera del mapa todo se considera opaco
+			bool bInside = m_pMap->isInside(mapX, mapY);
+			bool bOpaque = !bInside || isOpaque(mapX, mapY);
+
+			if( bInside && (-dx) <= pSpans[j] )
+			{//El tile está dentro del círculo de visión
+				LightTile(viewer, mapX, mapY);
+			}
+
+			if( bBlocked )
+			{//Estamos recorriendo una sección de tiles opacos
+				if( bOpaque )
+				{
+					newStart = rightSlope;
+					continue;
+				}
+				else
+				{
+					bBlocked = false;
+					start = newStart;
+				}
+			}
+			else if( bOpaque && j < viewer.radius )
+			{//Empieza una sección opaca, la parte visible anterior continúa en la siguiente fila
+				bBlocked = true;
+				CastLight(viewer, j+1, start, leftSlope, xx, xy, yx, yy);
+				newStart = rightSlope;
+			}
+		}
+
+		if( bBlocked )
+		{//La fila terminó tapada, no hay más que ver en este octante
+			break;
+		}
+	}
+}
+
+void geFogOfWar::LightTile(Viewer& viewer, const int32 x, const int32 y)
+{//Marca un tile como visto por el observador (los tiles en las diagonales se recorren desde dos octantes, la marca evita contarlos doble)
+	int32 index = m_pMap->getTileIndex(x, y);
+	if( m_stamp[index] == m_stampValue )
+	{
+		return;
+	}
+	m_stamp[index] = m_stampValue;
+
+	PlayerVision& vision = m_players[viewer.player];
+	++vision.refCount[index];
+	vision.explored[index>>6] |= (uint64)1 << (index&63);
+	viewer.tiles.push_back(index);
+}
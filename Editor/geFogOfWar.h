@@ -0,0 +1,122 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geFogOfWar.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geFogOfWar
+				Mantiene la visibilidad por jugador sobre un geTiledMap
+				usando shadowcasting recursivo. Cada tile guarda el
+				número de observadores que lo ven y un bit de explorado,
+				y solo se recalculan los observadores que se movieron
+				o cuya área de visión contiene tiles modificados
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geTiledMap.h"
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define FOW_MAX_PLAYERS		8			//Número máximo de jugadores con visibilidad propia
+#define FOW_MAX_RADIUS		32			//Radio de visión máximo de un observador (en tiles)
+#define FOW_INVALID_VIEWER	-1			//Identificador de observador inválido
+
+/************************************************************************************************************************/
+/* Declaración de la clase geFogOfWar                                   												*/
+/************************************************************************************************************************/
+class geFogOfWar : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geFogOfWar(void);							//Constructor standard
+	~geFogOfWar(void);							//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de inicialización y actualización                          												*/
+	/************************************************************************************************************************/
+public:
+	bool Init(geTiledMap* pMap, const int32 numPlayers);	//Asocia la visibilidad a un mapa y aloja los datos de cada jugador
+	void Destroy();											//Libera todos los datos
+	void Update();											//Recalcula la visibilidad de los observadores pendientes (debe llamarse cada ciclo despues de actualizar el mapa)
+
+	/************************************************************************************************************************/
+	/* Funciones de control de observadores (unidades o edificios que revelan el mapa)										*/
+	/************************************************************************************************************************/
+public:
+	int32 AddViewer(const int32 player, const int32 x, const int32 y, const int32 radius);	//Agrega un observador y regresa su identificador
+	void RemoveViewer(const int32 viewer);													//Elimina un observador y retira su visión
+	void MoveViewer(const int32 viewer, const int32 x, const int32 y);						//Cambia la posición de un observador (solo se recalcula si cambia de tile)
+	void setViewerRadius(const int32 viewer, const int32 radius);							//Cambia el radio de visión de un observador
+
+	/************************************************************************************************************************/
+	/* Funciones de consulta                                                												*/
+	/************************************************************************************************************************/
+public:
+	FORCEINLINE bool isVisible(const int32 player, const int32 x, const int32 y) const { return m_players[player].refCount[m_pMap->getTileIndex(x, y)] != 0; }
+	FORCEINLINE bool isExplored(const int32 player, const int32 x, const int32 y) const { int32 index = m_pMap->getTileIndex(x, y); return ((m_players[player].explored[index>>6] >> (index&63)) & 1) != 0; }
+	FORCEINLINE bool isOpaque(const int32 x, const int32 y) const { return ((m_opaqueBits[(y*m_rowWords)+(x>>6)] >> (x&63)) & 1) != 0; }
+	const uint16* getVisibilityRow(const int32 player, const int32 y) const { return &m_players[player].refCount[m_pMap->getTileIndex(0, y)]; }	//Número de observadores que ven cada tile de la fila
+	int32 getNumPlayers() const { return (int32)m_players.size(); }
+
+	uint32 getVisionVersion(const int32 player) const { return m_players[player].version; }	//Cambia cada Update() en el que la visión del jugador cambió
+	bool getVisionChangesSince(const int32 player, const uint32 version, geMapRegion& region) const;	//Región donde pudo cambiar la visión desde la versión indicada, regresa false si hay que revisar todo el mapa
+
+	static FORCEINLINE bool isTerrainOpaque(const uint8 idtype) { return idtype == TT_OBSTACLE; }	//Indica si un tipo de terreno bloquea la visión
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	struct Viewer
+	{
+		int32 player;
+		int32 x, y;
+		int32 radius;
+		bool bActive;						//Indica si este espacio está en uso
+		bool bDirty;						//Indica si debe recalcularse su visión en el siguiente Update()
+		std::vector<int32> tiles;			//Índices de los tiles que este observador está viendo (para retirarlos sin recalcular)
+		geMapRegion lit;					//Rectángulo que contiene los tiles que está viendo
+	};
+
+	struct PlayerVision
+	{
+		std::vector<uint16> refCount;		//Número de observadores que ven cada tile (indexado con el índice de tile del mapa)
+		std::vector<uint64> explored;		//Bit por tile que indica si alguna vez fue visto
+		uint32 version;						//Versión de la visión (cambia cuando se publica un cambio)
+		geMapRegion lastChange;				//Región que cambió en la última versión
+		geMapRegion pendingChange;			//Región que ha cambiado desde la última versión
+
+		PlayerVision() : version(0) {}
+	};
+
+	void RebuildGrids();																//Realoja los datos para el tamaño actual del mapa
+	void UpdateOpaque(const geMapRegion& region);										//Recalcula los bits de opacidad de la región
+	void ClearViewer(Viewer& viewer);													//Retira la visión actual del observador
+	void ComputeViewer(Viewer& viewer);													//Calcula la visión del observador y la agrega a su jugador
+	void CastLight(Viewer& viewer, const int32 row, float start, const float end, const int32 xx, const int32 xy, const int32 yx, const int32 yy);	//Shadowcasting recursivo de un octante
+	void LightTile(Viewer& viewer, const int32 x, const int32 y);						//Marca un tile como visto por el observador
+	void PublishChanges();																//Crea una nueva versión de la visión de los jugadores que cambiaron
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	geTiledMap *m_pMap;						//Mapa asociado
+	uint32 m_mapVersion;					//Versión del mapa con la que están actualizados los datos
+	int32 m_width, m_height;				//Tamaño del mapa con el que se alojaron los datos
+	int32 m_rowWords;						//Palabras de 64 bits por fila en el plano de opacidad
+
+	std::vector<uint64> m_opaqueBits;		//Plano de bits de tiles que bloquean la visión
+	std::vector<PlayerVision> m_players;	//Datos de visibilidad de cada jugador
+	std::vector<Viewer> m_viewers;			//Observadores (los espacios libres se reutilizan)
+	std::vector<int32> m_freeViewers;		//Espacios libres en la lista de observadores
+
+	std::vector<uint8> m_circleSpans[FOW_MAX_RADIUS+1];	//Por radio, la mitad del ancho del círculo en cada distancia vertical |dy|
+	std::vector<uint32> m_stamp;			//Marca por tile para no contar dos veces un tile visto desde dos octantes
+	uint32 m_stampValue;					//Valor de marca del cálculo actual
+};
@@ -18,7 +18,10 @@
 geGUI::geGUI(void)
 {//Constructor
 	m_pRenderer = NULL;
-	m_pMainGUITexture = NULL;
+	m_pTarget = NULL;
+	m_width = m_height = 0;
+	m_bSupported = false;
+	m_numRedrawnRects = 0;
 }
 
 geGUI::~geGUI(void)
@@ -34,31 +37,191 @@ bool geGUI::Init(SDL_Renderer* pRenderer)
 	//Copiamos localmente la referencia al renderer al que estaremos asociado
 	m_pRenderer = pRenderer;
 
-	//Cargamos las texturas requeridas por este objeto
-	m_pMainGUITexture = GEE_NEW geTexture();
-	if( !m_pMainGUITexture->LoadFromFile(m_pRenderer, TEXT("Textures\\GUI\\GUI.png")) )
+	//El GUI cubre toda la salida del renderer
+	if( SDL_GetRendererOutputSize(pRenderer, &m_width, &m_height) != 0 )
+	{
+		GEE_WARNING( TEXT("geGUI::Init: No se pudo obtener el tamaño de la salida del renderer! SDL Error: ") + s2gs(SDL_GetError()) );
+	}
+	m_bSupported = (SDL_RenderTargetSupported(pRenderer) == SDL_TRUE);
+
+	//Cargamos las texturas requeridas por este objeto (si otro GUI ya la cargó la compartimos, si no se decodifica en el hilo de carga)
+	m_mainGUITexture = g_TextureManager.LoadAsync(TEXT("Textures\\GUI\\GUI.png"));
+	if( !m_mainGUITexture.isValid() )
 	{
 		GEE_ERROR(TEXT("Falló al cargar la imagen del GUI"));
 		return false;
 	}
 
+	//La imagen principal es el fondo de todo el GUI (su región se invalida cuando termine de cargarse)
+	AddObject( GEE_NEW geGUIImage(m_mainGUITexture, 0, 0) );
+
 	return true;
 }
 
 void geGUI::Destroy()
 {
+	//Destruimos los objetos en orden inverso al que se agregaron
+	while( m_objects.size() > 0 )
+	{
+		GEE_DELETE m_objects.back();
+		m_objects.pop_back();
+	}
+
+	if( m_pTarget != NULL )
+	{
+		SDL_DestroyTexture(m_pTarget);
+		m_pTarget = NULL;
+	}
+	m_dirtyRects.clear();
+	m_rasterQueue.Clear();
+
 	m_pRenderer = NULL;
-	SAFE_DELETE(m_pMainGUITexture);
+	m_mainGUITexture.Release();
 }
 
-void geGUI::Update(float)
+void geGUI::AddObject(geGUIObject* pObject)
+{//Agrega un objeto al final del orden de dibujo
+	GEE_ASSERT(pObject && pObject->m_pOwner == NULL);
+	pObject->m_pOwner = this;
+	m_objects.push_back(pObject);
+	pObject->Invalidate();
+}
+
+void geGUI::Invalidate(const SDL_Rect& rect)
+{//Agrega la región a la lista, uniéndola con la primera que toque
+	SDL_Rect bounds = { 0, 0, m_width, m_height };
+	SDL_Rect clipped;
+	if( !SDL_IntersectRect(&rect, &bounds, &clipped) )
+	{
+		return;
+	}
+
+	for( SIZE_T i=0; i<m_dirtyRects.size(); ++i )
+	{
+		if( SDL_HasIntersection(&m_dirtyRects[i], &clipped) )
+		{
+			SDL_Rect merged;
+			SDL_UnionRect(&m_dirtyRects[i], &clipped, &merged);
+			m_dirtyRects[i] = merged;
+			return;
+		}
+	}
+
+	if( m_dirtyRects.size() >= GUI_MAX_DIRTY_RECTS )
+	{//Demasiadas regiones, las unimos todas en una sola
+		SDL_Rect merged = clipped;
+		for( SIZE_T i=0; i<m_dirtyRects.size(); ++i )
+		{
+			SDL_UnionRect(&merged, &m_dirtyRects[i], &merged);
+		}
+		m_dirtyRects.clear();
+		m_dirtyRects.push_back(merged);
+		return;
+	}
+
+	m_dirtyRects.push_back(clipped);
+}
+
+void geGUI::InvalidateAll()
+{//Todo el GUI debe redibujarse
+	m_dirtyRects.clear();
+	if( m_width > 0 && m_height > 0 )
+	{
+		SDL_Rect bounds = { 0, 0, m_width, m_height };
+		m_dirtyRects.push_back(bounds);
+	}
+}
+
+void geGUI::Update(float deltaTime)
 {
-	//De momento no necesitamos hacer nada para actualizar este objeto
+	//Los objetos invalidan sus regiones si cambia su aspecto
+	for( SIZE_T i=0; i<m_objects.size(); ++i )
+	{
+		m_objects[i]->Update(deltaTime);
+	}
+}
+
+bool geGUI::CheckTarget()
+{//Crea la textura de composición la primera vez
+	if( m_pTarget != NULL )
+	{
+		return true;
+	}
+	if( m_width <= 0 || m_height <= 0 )
+	{
+		return false;
+	}
+
+	m_pTarget = SDL_CreateTexture(m_pRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, m_width, m_height);
+	if( m_pTarget == NULL )
+	{
+		GEE_WARNING( TEXT("No se pudo crear la textura del GUI, se imprimirá completo cada cuadro! SDL Error: ") + s2gs(SDL_GetError()) );
+		m_bSupported = false;
+		return false;
+	}
+
+	SDL_SetTextureBlendMode(m_pTarget, SDL_BLENDMODE_BLEND);	//Donde no hay objetos se ve el mapa
+	InvalidateAll();
+	return true;
 }
 
-void geGUI::Render()
+void geGUI::RedrawDirtyRects()
+{//Limpia las regiones sucias y vuelve a imprimir solo los objetos que las tocan, recortados a cada región
+	SDL_Texture* pPrevTarget = SDL_GetRenderTarget(m_pRenderer);
+	SDL_SetRenderTarget(m_pRenderer, m_pTarget);
+
+	//SDL_RenderClear ignora el recorte, así que limpiamos cada región con un rectángulo sin mezcla
+	SDL_BlendMode prevBlendMode;
+	SDL_GetRenderDrawBlendMode(m_pRenderer, &prevBlendMode);
+	SDL_SetRenderDrawBlendMode(m_pRenderer, SDL_BLENDMODE_NONE);
+	SDL_SetRenderDrawColor(m_pRenderer, 0, 0, 0, 0);
+	SDL_RenderFillRects(m_pRenderer, &m_dirtyRects[0], (int32)m_dirtyRects.size());
+	SDL_SetRenderDrawBlendMode(m_pRenderer, prevBlendMode);
+
+	m_rasterQueue.Clear();
+	for( SIZE_T iterRect=0; iterRect<m_dirtyRects.size(); ++iterRect )
+	{
+		const SDL_Rect& dirtyRect = m_dirtyRects[iterRect];
+		m_rasterQueue.setClipRect(&dirtyRect);
+		for( SIZE_T iterObj=0; iterObj<m_objects.size(); ++iterObj )
+		{
+			geGUIObject* pObject = m_objects[iterObj];
+			if( pObject->isVisible() && SDL_HasIntersection(&pObject->getRect(), &dirtyRect) )
+			{
+				pObject->Render(m_rasterQueue);
+			}
+		}
+	}
+	m_rasterQueue.setClipRect(NULL);
+	m_rasterQueue.Submit(m_pRenderer);
+
+	SDL_SetRenderTarget(m_pRenderer, pPrevTarget);
+	m_numRedrawnRects = (int32)m_dirtyRects.size();
+	m_dirtyRects.clear();
+}
+
+void geGUI::Render(geRenderQueue& queue)
 {
-	//Rendereamos la imagen del GUI
-	GEE_ASSERT(m_pMainGUITexture);
-	m_pMainGUITexture->Render(0,0);
+	m_numRedrawnRects = 0;
+	if( !m_bSupported || !CheckTarget() )
+	{//Sin render targets imprimimos todos los objetos cada cuadro
+		for( SIZE_T i=0; i<m_objects.size(); ++i )
+		{
+			if( m_objects[i]->isVisible() )
+			{
+				m_objects[i]->Render(queue);
+			}
+		}
+		m_dirtyRects.clear();
+		return;
+	}
+
+	//Solo redibujamos lo que cambió, el resto del GUI ya está en la textura
+	if( !m_dirtyRects.empty() )
+	{
+		RedrawDirtyRects();
+	}
+
+	SDL_Rect dstRect = { 0, 0, m_width, m_height };
+	queue.AddCopy(RL_GUI, m_pTarget, NULL, dstRect);
 }
@@ -5,16 +5,22 @@
 
 	Purpose:	Declaración de la clase y objetos para el manejo de
 				interface gráfica de la aplicación
+				Los objetos se componen en una textura de render target
+				que se conserva entre cuadros; solo se redibujan las
+				regiones que los objetos invalidan y cada cuadro se
+				imprime la textura con una sola copia
 *********************************************************************/
 #pragma once
 
 /************************************************************************************************************************/
 /* Inclusión de cabeceras necesarias para la compilación              												*/
 /************************************************************************************************************************/
+#include "geGUIObject.h"
 
 /************************************************************************************************************************/
 /* Definición de constantes                                             												*/
 /************************************************************************************************************************/
+#define GUI_MAX_DIRTY_RECTS		16		//Regiones sucias que se mantienen separadas (al rebasarlas se unen en una sola)
 
 /************************************************************************************************************************/
 /* Declaración de la clase geGUI para el manejo de la interface gráfica de la aplicación								*/
@@ -36,12 +42,31 @@ public:
 	void Destroy();
 
 	void Update(float deltaTime);
-	void Render();
+	void Render(geRenderQueue& queue);	//Redibuja las regiones sucias en la textura del GUI y agrega su copia a la lista
+
+	void AddObject(geGUIObject* pObject);	//Agrega un objeto al GUI (el GUI se vuelve dueño del objeto y lo destruye)
+
+	void Invalidate(const SDL_Rect& rect);	//Marca una región para redibujarse en el siguiente Render()
+	void InvalidateAll();					//Marca todo el GUI (ej. el dispositivo perdió el contenido de los render targets)
+	int32 getNumRedrawnRects() const { return m_numRedrawnRects; }	//Regiones redibujadas en el último Render()
+
+private:
+	bool CheckTarget();						//Crea la textura de composición (regresa false si no se pudo)
+	void RedrawDirtyRects();				//Limpia y redibuja las regiones sucias en la textura
 
 	/************************************************************************************************************************/
 	/* Declaración de variables de la clase                                 												*/
 	/************************************************************************************************************************/
 public:
 	SDL_Renderer *m_pRenderer;			//Renderer asociado con este objeto
-	geTexture* m_pMainGUITexture;		//Textura principal del GUI
+	geTextureHandle m_mainGUITexture;	//Textura principal del GUI (compartida por el cache de texturas)
+
+private:
+	std::vector<geGUIObject*> m_objects;	//Objetos del GUI en orden de dibujo
+	std::vector<SDL_Rect> m_dirtyRects;		//Regiones que deben redibujarse
+	SDL_Texture *m_pTarget;					//Textura con el GUI compuesto
+	int32 m_width, m_height;				//Tamaño del GUI (el de la salida del renderer)
+	bool m_bSupported;						//El renderer soporta render targets (si no, cada cuadro se imprimen todos los objetos)
+	geRenderQueue m_rasterQueue;			//Comandos que se envían a la textura
+	int32 m_numRedrawnRects;				//Regiones redibujadas en el último Render()
 };
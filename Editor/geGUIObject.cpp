@@ -17,9 +17,84 @@
 /************************************************************************************************************************/
 geGUIObject::geGUIObject(void)
 {//Constructor standard
+	m_pOwner = NULL;
+	m_rect.x = m_rect.y = m_rect.w = m_rect.h = 0;
+	m_bVisible = true;
 }
 
 
 geGUIObject::~geGUIObject(void)
 {//Destructor virtual
+	m_pOwner = NULL;
+}
+
+void geGUIObject::setRect(const SDL_Rect& rect)
+{//El área anterior debe redibujarse sin el objeto y la nueva con él
+	Invalidate();
+	m_rect = rect;
+	Invalidate();
+}
+
+void geGUIObject::setVisible(const bool bVisible)
+{
+	if( bVisible != m_bVisible )
+	{
+		m_bVisible = bVisible;
+		Invalidate();
+	}
+}
+
+void geGUIObject::Invalidate()
+{//Agrega el área del objeto a las regiones sucias del GUI
+	if( m_pOwner != NULL )
+	{
+		m_pOwner->Invalidate(m_rect);
+	}
+}
+
+/************************************************************************************************************************/
+/* Implementación de funciones de geGUIImage                            												*/
+/************************************************************************************************************************/
+geGUIImage::geGUIImage(void)
+{//Constructor standard
+	m_bWasReady = false;
+}
+
+geGUIImage::geGUIImage(const geTextureHandle& texture, const int32 x, const int32 y)
+{//Constructor con la textura y la posición
+	m_rect.x = x;
+	m_rect.y = y;
+	m_bWasReady = false;
+	setTexture(texture);
+}
+
+geGUIImage::~geGUIImage(void)
+{//Destructor
+	m_texture.Release();
+}
+
+void geGUIImage::setTexture(const geTextureHandle& texture)
+{//Cambia la textura (el tamaño se actualiza cuando esté lista)
+	Invalidate();
+	m_texture = texture;
+	m_bWasReady = false;
+	Update(0.0f);
+}
+
+void geGUIImage::Update(float)
+{//Una carga asíncrona termina en algún cuadro posterior, en ese momento tomamos el tamaño y pedimos que se dibuje
+	if( !m_bWasReady && m_texture.isReady() )
+	{
+		m_bWasReady = true;
+		SDL_Rect rect = { m_rect.x, m_rect.y, m_texture->GetWidth(), m_texture->GetHeight() };
+		setRect(rect);
+	}
+}
+
+void geGUIImage::Render(geRenderQueue& queue)
+{
+	if( m_texture.isReady() )
+	{
+		m_texture->Render(queue, RL_GUI, m_rect.x, m_rect.y);
+	}
 }
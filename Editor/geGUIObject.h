@@ -9,15 +9,66 @@
 *********************************************************************/
 #pragma once
 
+class geGUI;
+
 /************************************************************************************************************************/
 /* Declaración de la clase base geGUIObject																				*/
 /************************************************************************************************************************/
 class geGUIObject
 {
+	friend class geGUI;
+
 	/************************************************************************************************************************/
 	/* Constructor y destructor virtual                                     												*/
 	/************************************************************************************************************************/
 public:
 	geGUIObject(void);
 	virtual ~geGUIObject(void);
+
+	/************************************************************************************************************************/
+	/* Funciones virtuales de los objetos                                   												*/
+	/************************************************************************************************************************/
+public:
+	virtual void Update(float) {}				//Actualiza el objeto (si cambia su aspecto debe llamar a Invalidate())
+	virtual void Render(geRenderQueue& queue) = 0;	//Agrega los comandos de dibujo del objeto (solo se llama cuando su área necesita redibujarse)
+
+	/************************************************************************************************************************/
+	/* Funciones de acceso                                                  												*/
+	/************************************************************************************************************************/
+public:
+	void setRect(const SDL_Rect& rect);			//Mueve o cambia el tamaño del objeto (invalida el área anterior y la nueva)
+	const SDL_Rect& getRect() const { return m_rect; }
+	void setVisible(const bool bVisible);
+	bool isVisible() const { return m_bVisible; }
+
+	void Invalidate();							//Indica que el área del objeto debe redibujarse
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+protected:
+	geGUI *m_pOwner;							//GUI que compone este objeto (NULL si no se ha agregado)
+	SDL_Rect m_rect;							//Área que ocupa el objeto en el GUI
+	bool m_bVisible;							//Indica si el objeto se dibuja
+};
+
+/************************************************************************************************************************/
+/* Declaración de la clase geGUIImage (imagen o región de una textura)													*/
+/************************************************************************************************************************/
+class geGUIImage : public geGUIObject
+{
+public:
+	geGUIImage(void);
+	geGUIImage(const geTextureHandle& texture, const int32 x, const int32 y);	//Imagen completa en la posición indicada (el tamaño se toma cuando la textura esté lista)
+	virtual ~geGUIImage(void);
+
+	virtual void Update(float deltaTime);		//Invalida su área cuando la textura termina de cargarse
+	virtual void Render(geRenderQueue& queue);
+
+	void setTexture(const geTextureHandle& texture);
+	const geTextureHandle& getTexture() const { return m_texture; }
+
+private:
+	geTextureHandle m_texture;					//Textura que se imprime
+	bool m_bWasReady;							//La textura ya estaba lista en el último Update()
 };
@@ -0,0 +1,555 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geInfluenceMap.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geInfluenceMap
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geInfluenceMap.h"
+#include <xmmintrin.h>
+
+/************************************************************************************************************************/
+/* Declaración e implementación de la clase geInfluenceWorker (hilo que procesa una banda de filas por encargo)			*/
+/************************************************************************************************************************/
+class geInfluenceWorker : public geThread
+{
+public:
+	geInfluenceWorker(geInfluenceMap* pOwner, const int32 band)
+	{
+		m_pOwner = pOwner;
+		m_band = band;
+		m_pLayer = NULL;
+		m_iniY = m_finY = 0;
+
+		//Eventos con reinicio automático para indicar trabajo nuevo y trabajo terminado
+		m_hStartEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+		m_hDoneEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+		GEE_ASSERT(m_hStartEvent && m_hDoneEvent);
+	}
+
+	virtual ~geInfluenceWorker()
+	{
+		Stop();
+		CloseHandle(m_hStartEvent);
+		CloseHandle(m_hDoneEvent);
+	}
+
+	void Dispatch(geInfluenceMap::Layer* pLayer, const int32 iniY, const int32 finY)
+	{//Encarga al hilo el procesamiento de un rango de filas
+		m_pLayer = pLayer;
+		m_iniY = iniY;
+		m_finY = finY;
+		SetEvent(m_hStartEvent);
+	}
+
+	HANDLE getDoneEvent() const { return m_hDoneEvent; }
+
+	void Stop()
+	{//Detiene el hilo y espera a que termine
+		RequestStop();
+		SetEvent(m_hStartEvent);
+		Join();
+	}
+
+protected:
+	virtual uint32 Run()
+	{
+		for(;;)
+		{
+			WaitForSingleObject(m_hStartEvent, INFINITE);
+			if( IsStopRequested() )
+			{
+				break;
+			}
+
+			m_pOwner->ProcessRows(*m_pLayer, m_iniY, m_finY, m_pOwner->getScratch(m_band));
+			SetEvent(m_hDoneEvent);
+		}
+
+		return 0;
+	}
+
+private:
+	geInfluenceMap *m_pOwner;
+	int32 m_band;							//Banda de este hilo (determina su área de filas temporales)
+	geInfluenceMap::Layer *m_pLayer;		//Capa a procesar
+	int32 m_iniY, m_finY;					//Rango de filas a procesar [iniY, finY)
+	HANDLE m_hStartEvent;
+	HANDLE m_hDoneEvent;
+};
+
+/************************************************************************************************************************/
+/* Funciones de ayuda para procesar filas                               												*/
+/************************************************************************************************************************/
+static void KernelRow(const geInfluenceLayerDesc& desc, const float* pUp, const float* pCur, const float* pDown, float* pDst, const int32 width)
+{//Aplica el kernel a una fila completa, 4 tiles a la vez
+	//NOTA: Las filas tienen relleno de ceros a los lados, así que leer x-1 y x+1 en los bordes es seguro
+	const __m128 vDecay = _mm_set1_ps(desc.decay);
+	int32 x = 0;
+
+	switch( desc.kernel )
+	{
+	case IK_DECAY:
+		for( ; x<width; x+=4 )
+		{
+			_mm_storeu_ps( &pDst[x], _mm_mul_ps(_mm_loadu_ps(&pCur[x]), vDecay) );
+		}
+		break;
+
+	case IK_BLUR:
+		{
+			const __m128 vFour = _mm_set1_ps(4.0f);
+			const __m128 vScale = _mm_set1_ps(desc.decay*0.125f);
+			for( ; x<width; x+=4 )
+			{
+				__m128 vSum = _mm_mul_ps(_mm_loadu_ps(&pCur[x]), vFour);
+				vSum = _mm_add_ps(vSum, _mm_add_ps(_mm_loadu_ps(&pCur[x-1]), _mm_loadu_ps(&pCur[x+1])));
+				vSum = _mm_add_ps(vSum, _mm_add_ps(_mm_loadu_ps(&pUp[x]), _mm_loadu_ps(&pDown[x])));
+				_mm_storeu_ps( &pDst[x], _mm_mul_ps(vSum, vScale) );
+			}
+		}
+		break;
+
+	case IK_PROPAGATE:
+		{
+			const __m128 vMomentum = _mm_set1_ps(desc.momentum);
+			for( ; x<width; x+=4 )
+			{
+				__m128 vCur = _mm_loadu_ps(&pCur[x]);
+				__m128 vMax = _mm_max_ps( _mm_max_ps(_mm_loadu_ps(&pCur[x-1]), _mm_loadu_ps(&pCur[x+1])), _mm_max_ps(_mm_loadu_ps(&pUp[x]), _mm_loadu_ps(&pDown[x])) );
+				__m128 vTarget = _mm_mul_ps(vMax, vDecay);
+				_mm_storeu_ps( &pDst[x], _mm_add_ps(vCur, _mm_mul_ps(_mm_sub_ps(vTarget, vCur), vMomentum)) );
+			}
+		}
+		break;
+	}
+
+	//El último grupo de 4 pudo escribir fuera del ancho, restauramos el relleno a cero
+	for( x=width; x<((width+3)&~3); ++x )
+	{
+		pDst[x] = 0.0f;
+	}
+}
+
+static void LoadHalfRow(const geFloat16* pSrc, float* pDst, const int32 width)
+{//Convierte una fila de geFloat16 a float
+	for( int32 x=0; x<width; ++x )
+	{
+		pDst[x] = pSrc[x].GetFloat();
+	}
+}
+
+static void StoreHalfRow(const float* pSrc, geFloat16* pDst, const int32 width)
+{//Convierte una fila de float a geFloat16
+	for( int32 x=0; x<width; ++x )
+	{
+		pDst[x].Set(pSrc[x]);
+	}
+}
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geInfluenceMap::geInfluenceMap(void)
+{//Constructor standard
+	m_pMap = NULL;
+	m_width = m_height = 0;
+	m_rowFloats = 0;
+	m_currentLayer = 0;
+	m_currentRow = 0;
+	m_pZeroRow = NULL;
+}
+
+geInfluenceMap::~geInfluenceMap(void)
+{//Destructor
+	Destroy();
+}
+
+bool geInfluenceMap::Init(geTiledMap* pMap, const int32 numWorkers)
+{//Asocia las capas a un mapa y crea los hilos de trabajo
+	GEE_ASSERT(pMap);
+	Destroy();
+
+	m_pMap = pMap;
+	m_width = pMap->getMapWidth();
+	m_height = pMap->getMapHeight();
+	m_rowFloats = ((m_width+3)&~3) + (2*INFLUENCE_ROW_PADDING);
+
+	m_pZeroRow = GEE_NEW float[m_rowFloats];
+	GEE_ASSERT(m_pZeroRow);
+	memset(m_pZeroRow, 0, m_rowFloats*sizeof(float));
+
+	//Creamos un hilo por procesador disponible (el hilo principal procesa la primera banda)
+	int32 workers = numWorkers;
+	if( workers < 0 )
+	{
+		SYSTEM_INFO sysInfo;
+		GetSystemInfo(&sysInfo);
+		workers = (int32)sysInfo.dwNumberOfProcessors-1;
+	}
+	workers = Clamp(workers, 0, INFLUENCE_MAX_WORKERS);
+
+	m_scratch.assign((workers+1)*m_rowFloats*4, 0.0f);
+	for( int32 i=0; i<workers; ++i )
+	{
+		geInfluenceWorker* pWorker = GEE_NEW geInfluenceWorker(this, i+1);
+		if( !pWorker->Start() )
+		{//Si no pudimos crear el hilo, el trabajo se repartirá entre menos hilos
+			GEE_WARNING(TEXT("geInfluenceMap::Init: Falló al crear un hilo de trabajo"));
+			GEE_DELETE pWorker;
+			break;
+		}
+		m_workers.push_back(pWorker);
+	}
+
+	return true;
+}
+
+void geInfluenceMap::Destroy()
+{//Destruye las capas y detiene los hilos de trabajo
+	while( !m_workers.empty() )
+	{
+		GEE_DELETE m_workers.back();
+		m_workers.pop_back();
+	}
+
+	for( SIZE_T i=0; i<m_layers.size(); ++i )
+	{
+		FreeLayer(m_layers[i]);
+	}
+	m_layers.clear();
+	m_scratch.clear();
+	SAFE_DELETE_ARRAY( m_pZeroRow );
+
+	m_pMap = NULL;
+	m_width = m_height = 0;
+	m_rowFloats = 0;
+	m_currentLayer = 0;
+	m_currentRow = 0;
+}
+
+int32 geInfluenceMap::AddLayer(const geInfluenceLayerDesc& desc)
+{//Crea una capa nueva
+	GEE_ASSERT(m_pMap);
+
+	Layer layer;
+	layer.desc = desc;
+	layer.bPendingClear = false;
+	AllocateLayer(layer);
+	m_layers.push_back(layer);
+
+	return (int32)m_layers.size()-1;
+}
+
+void geInfluenceMap::AllocateLayer(Layer& layer)
+{//Aloja los buffers de una capa (todos los valores comienzan en cero)
+	layer.current = 0;
+	for( int32 i=0; i<2; ++i )
+	{
+		layer.pValues[i] = NULL;
+		layer.pHalfValues[i] = NULL;
+		if( layer.desc.bHalfPrecision )
+		{
+			layer.pHalfValues[i] = GEE_NEW geFloat16[m_width*m_height];
+			GEE_ASSERT(layer.pHalfValues[i]);
+		}
+		else
+		{
+			layer.pValues[i] = GEE_NEW float[m_rowFloats*m_height];
+			GEE_ASSERT(layer.pValues[i]);
+			memset(layer.pValues[i], 0, m_rowFloats*m_height*sizeof(float));
+		}
+	}
+
+	for( int32 level=0; level<INFLUENCE_CASCADE_LEVELS; ++level )
+	{
+		int32 shift = level+1;
+		layer.cascade[level].assign( ((m_width+(1<<shift)-1)>>shift) * ((m_height+(1<<shift)-1)>>shift), 0.0f );
+	}
+}
+
+void geInfluenceMap::FreeLayer(Layer& layer)
+{//Libera los buffers de una capa
+	for( int32 i=0; i<2; ++i )
+	{
+		SAFE_DELETE_ARRAY( layer.pValues[i] );
+		SAFE_DELETE_ARRAY( layer.pHalfValues[i] );
+	}
+}
+
+void geInfluenceMap::Resize()
+{//Los hilos de trabajo siguen esperando su siguiente encargo, solo cambian los buffers que se les entregan
+	for( SIZE_T i=0; i<m_layers.size(); ++i )
+	{
+		FreeLayer(m_layers[i]);
+	}
+	SAFE_DELETE_ARRAY( m_pZeroRow );
+
+	m_width = m_pMap->getMapWidth();
+	m_height = m_pMap->getMapHeight();
+	m_rowFloats = ((m_width+3)&~3) + (2*INFLUENCE_ROW_PADDING);
+
+	m_pZeroRow = GEE_NEW float[m_rowFloats];
+	GEE_ASSERT(m_pZeroRow);
+	memset(m_pZeroRow, 0, m_rowFloats*sizeof(float));
+	m_scratch.assign((m_workers.size()+1)*m_rowFloats*4, 0.0f);
+
+	//Las capas conservan su configuración pero comienzan en cero, las escrituras pendientes eran del tamaño anterior
+	ScopedCriticalSection lock(m_writeLock);
+	for( SIZE_T i=0; i<m_layers.size(); ++i )
+	{
+		AllocateLayer(m_layers[i]);
+		m_layers[i].pendingWrites.clear();
+		m_layers[i].bPendingClear = false;
+	}
+	m_currentLayer = 0;
+	m_currentRow = 0;
+}
+
+void geInfluenceMap::QueueWrite(const int32 layer, const int32 x, const int32 y, const float value, const bool bAdd)
+{
+	GEE_ASSERT( layer >= 0 && layer < (int32)m_layers.size() );
+	GEE_ASSERT( x >= 0 && x < m_width && y >= 0 && y < m_height );
+
+	PendingWrite write;
+	write.x = x;
+	write.y = y;
+	write.value = value;
+	write.bAdd = bAdd;
+
+	ScopedCriticalSection lock(m_writeLock);
+	m_layers[layer].pendingWrites.push_back(write);
+}
+
+void geInfluenceMap::ApplyPendingWrites(Layer& layer)
+{//Solo se llama entre pasos, cuando ningún hilo de trabajo lee los buffers de la capa
+	ScopedCriticalSection lock(m_writeLock);
+	if( layer.bPendingClear )
+	{
+		for( int32 i=0; i<2; ++i )
+		{
+			if( layer.desc.bHalfPrecision )
+			{
+				memset(layer.pHalfValues[i], 0, m_width*m_height*sizeof(geFloat16));
+			}
+			else
+			{
+				memset(layer.pValues[i], 0, m_rowFloats*m_height*sizeof(float));
+			}
+		}
+		layer.bPendingClear = false;
+	}
+
+	for( SIZE_T i=0; i<layer.pendingWrites.size(); ++i )
+	{
+		const PendingWrite& write = layer.pendingWrites[i];
+		if( layer.desc.bHalfPrecision )
+		{
+			geFloat16& half = layer.pHalfValues[layer.current][(write.y*m_width)+write.x];
+			half.Set( write.bAdd ? half.GetFloat()+write.value : write.value );
+		}
+		else
+		{
+			float& value = layer.pValues[layer.current][(write.y*m_rowFloats)+INFLUENCE_ROW_PADDING+write.x];
+			value = write.bAdd ? value+write.value : write.value;
+		}
+	}
+	layer.pendingWrites.clear();
+}
+
+void geInfluenceMap::Update(const int32 rowBudget)
+{//Avanza la propagación de las capas
+	if( m_pMap == NULL || m_layers.empty() )
+	{
+		return;
+	}
+
+	if( m_pMap->getMapWidth() != m_width || m_pMap->getMapHeight() != m_height )
+	{//El mapa cambió de tamaño, realojamos las capas aquí donde los hilos de trabajo están esperando encargo (no se vuelven a crear)
+		Resize();
+	}
+
+	//Procesamos como máximo un paso completo por capa en cada ciclo
+	int32 budget = rowBudget;
+	int32 numLayersFinished = 0;
+	while( budget > 0 && numLayersFinished < (int32)m_layers.size() )
+	{
+		Layer& layer = m_layers[m_currentLayer];
+		if( m_currentRow == 0 )
+		{//Comienza un paso de la capa, las escrituras pendientes entran antes de repartir las filas
+			ApplyPendingWrites(layer);
+		}
+		int32 numRows = Min(budget, m_height-m_currentRow);
+
+		//Repartimos las filas en bandas entre el hilo principal y los hilos de trabajo (con pocas filas no vale la pena despertar a los hilos)
+		int32 numBands = (numRows >= 32) ? (int32)m_workers.size()+1 : 1;
+		int32 rowsPerBand = (numRows+numBands-1)/numBands;
+		int32 numDispatched = 0;
+		HANDLE doneEvents[INFLUENCE_MAX_WORKERS];
+		for( int32 band=1; band<numBands; ++band )
+		{
+			int32 iniY = m_currentRow + (band*rowsPerBand);
+			int32 finY = Min(iniY+rowsPerBand, m_currentRow+numRows);
+			if( iniY >= finY )
+			{
+				break;
+			}
+			m_workers[band-1]->Dispatch(&layer, iniY, finY);
+			doneEvents[numDispatched++] = m_workers[band-1]->getDoneEvent();
+		}
+
+		ProcessRows(layer, m_currentRow, Min(m_currentRow+rowsPerBand, m_currentRow+numRows), getScratch(0));
+		if( numDispatched > 0 )
+		{
+			WaitForMultipleObjects(numDispatched, doneEvents, TRUE, INFINITE);
+		}
+
+		m_currentRow += numRows;
+		budget -= numRows;
+
+		if( m_currentRow >= m_height )
+		{//Terminamos el paso de esta capa, seguimos con la siguiente
+			FinishStep(layer);
+			m_currentRow = 0;
+			m_currentLayer = (m_currentLayer+1) % (int32)m_layers.size();
+			++numLayersFinished;
+		}
+	}
+}
+
+void geInfluenceMap::ProcessRows(Layer& layer, const int32 iniY, const int32 finY, float* pScratch)
+{//Aplica el kernel de la capa a las filas [iniY, finY)
+	const float* pZero = m_pZeroRow + INFLUENCE_ROW_PADDING;
+
+	if( !layer.desc.bHalfPrecision )
+	{//Capa de precisión completa, leemos y escribimos directo en los buffers
+		const float* pSrc = layer.pValues[layer.current] + INFLUENCE_ROW_PADDING;
+		float* pDst = layer.pValues[1-layer.current] + INFLUENCE_ROW_PADDING;
+		for( int32 tmpY=iniY; tmpY<finY; ++tmpY )
+		{
+			const float* pCur = &pSrc[tmpY*m_rowFloats];
+			const float* pUp = (tmpY > 0) ? pCur-m_rowFloats : pZero;
+			const float* pDown = (tmpY+1 < m_height) ? pCur+m_rowFloats : pZero;
+			KernelRow(layer.desc, pUp, pCur, pDown, &pDst[tmpY*m_rowFloats], m_width);
+		}
+		return;
+	}
+
+	//Capa de media precisión: convertimos las filas a float en un anillo de 3 filas temporales (la cuarta es el destino)
+	float* pRows[4];
+	for( int32 i=0; i<4; ++i )
+	{
+		pRows[i] = pScratch + (i*m_rowFloats) + INFLUENCE_ROW_PADDING;
+	}
+
+	const geFloat16* pSrc = layer.pHalfValues[layer.current];
+	geFloat16* pDst = layer.pHalfValues[1-layer.current];
+	if( iniY > 0 ) LoadHalfRow(&pSrc[(iniY-1)*m_width], pRows[0], m_width);
+	LoadHalfRow(&pSrc[iniY*m_width], pRows[1], m_width);
+
+	for( int32 tmpY=iniY; tmpY<finY; ++tmpY )
+	{
+		if( tmpY+1 < m_height )
+		{
+			LoadHalfRow(&pSrc[(tmpY+1)*m_width], pRows[2], m_width);
+		}
+
+		const float* pUp = (tmpY > 0) ? pRows[0] : pZero;
+		const float* pDown = (tmpY+1 < m_height) ? pRows[2] : pZero;
+		KernelRow(layer.desc, pUp, pRows[1], pDown, pRows[3], m_width);
+		StoreHalfRow(pRows[3], &pDst[tmpY*m_width], m_width);
+
+		//Rotamos el anillo
+		float* pTemp = pRows[0];
+		pRows[0] = pRows[1];
+		pRows[1] = pRows[2];
+		pRows[2] = pTemp;
+	}
+}
+
+void geInfluenceMap::FinishStep(Layer& layer)
+{//Intercambia los buffers y reconstruye la cascada
+	layer.current = 1-layer.current;
+	int32 layerIndex = (int32)(&layer - &m_layers[0]);
+
+	//El primer nivel se arma desde la resolución completa con bloques de 2x2, los siguientes desde el nivel anterior
+	int32 srcWidth = m_width;
+	int32 srcHeight = m_height;
+	for( int32 level=0; level<INFLUENCE_CASCADE_LEVELS; ++level )
+	{
+		int32 dstWidth = (srcWidth+1)>>1;
+		int32 dstHeight = (srcHeight+1)>>1;
+		float* pDst = &layer.cascade[level][0];
+		const float* pPrev = (level > 0) ? &layer.cascade[level-1][0] : NULL;
+
+		for( int32 cy=0; cy<dstHeight; ++cy )
+		{
+			for( int32 cx=0; cx<dstWidth; ++cx )
+			{
+				float sum = 0.0f;
+				int32 count = 0;
+				for( int32 sy=(cy<<1); sy<Min((cy<<1)+2, srcHeight); ++sy )
+				{
+					for( int32 sx=(cx<<1); sx<Min((cx<<1)+2, srcWidth); ++sx )
+					{
+						sum += (pPrev != NULL) ? pPrev[(sy*srcWidth)+sx] : getValue(layerIndex, sx, sy);
+						++count;
+					}
+				}
+				pDst[(cy*dstWidth)+cx] = sum/(float)count;
+			}
+		}
+
+		srcWidth = dstWidth;
+		srcHeight = dstHeight;
+	}
+}
+
+float geInfluenceMap::getValue(const int32 layer, const int32 x, const int32 y) const
+{//Valor de la capa en un tile
+	GEE_ASSERT( layer >= 0 && layer < (int32)m_layers.size() );
+	GEE_ASSERT( x >= 0 && x < m_width && y >= 0 && y < m_height );
+
+	const Layer& l = m_layers[layer];
+	if( l.desc.bHalfPrecision )
+	{
+		return l.pHalfValues[l.current][(y*m_width)+x].GetFloat();
+	}
+
+	return l.pValues[l.current][(y*m_rowFloats)+INFLUENCE_ROW_PADDING+x];
+}
+
+void geInfluenceMap::setValue(const int32 layer, const int32 x, const int32 y, const float value)
+{//Establece el valor de la capa en un tile
+	QueueWrite(layer, x, y, value, false);
+}
+
+void geInfluenceMap::addValue(const int32 layer, const int32 x, const int32 y, const float value)
+{//Suma un valor a la capa en un tile
+	QueueWrite(layer, x, y, value, true);
+}
+
+void geInfluenceMap::Clear(const int32 layer)
+{//Pone en 0 todos los valores de la capa al comenzar su siguiente paso
+	GEE_ASSERT( layer >= 0 && layer < (int32)m_layers.size() );
+
+	ScopedCriticalSection lock(m_writeLock);
+	Layer& l = m_layers[layer];
+	l.pendingWrites.clear();
+	l.bPendingClear = true;
+}
+
+float geInfluenceMap::getCoarseValue(const int32 layer, const int32 level, const int32 x, const int32 y) const
+{//Promedio del bloque de la cascada que contiene al tile
+	GEE_ASSERT( layer >= 0 && layer < (int32)m_layers.size() );
+	GEE_ASSERT( level >= 0 && level < INFLUENCE_CASCADE_LEVELS );
+
+	int32 shift = level+1;
+	int32 levelWidth = (m_width+(1<<shift)-1)>>shift;
+	return m_layers[layer].cascade[level][((y>>shift)*levelWidth)+(x>>shift)];
+}
@@ -0,0 +1,134 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geInfluenceMap.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geInfluenceMap
+				Mapas de influencia para la IA (amenaza, territorio,
+				etc.) sobre el grid de un geTiledMap. Cada capa se
+				propaga con un kernel vectorizado por filas, con un
+				límite de filas por ciclo repartido en bandas entre
+				hilos de trabajo, y mantiene una cascada de menor
+				resolución para consultas de grano grueso
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geTiledMap.h"
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define INFLUENCE_CASCADE_LEVELS	4		//Niveles de la cascada (cada uno con la mitad de resolución del anterior, el último coincide con los chunks del mapa)
+#define INFLUENCE_MAX_WORKERS		4		//Número máximo de hilos de trabajo para la propagación
+#define INFLUENCE_ROW_PADDING		4		//Flotantes de relleno a cada lado de una fila (permiten leer los vecinos del borde sin condiciones)
+#define INFLUENCE_DEFAULT_ROW_BUDGET 64		//Filas que se procesan por ciclo por default
+
+//Kernels de actualización de una capa
+enum eInfluenceKernel
+{
+	IK_DECAY = 0,		//v = v*decay
+	IK_BLUR,			//v = (4v + izquierda + derecha + arriba + abajo)/8 * decay
+	IK_PROPAGATE		//v = lerp(v, max(vecinos)*decay, momentum)
+};
+
+//Descripción de una capa de influencia
+struct geInfluenceLayerDesc
+{
+	eInfluenceKernel kernel;	//Kernel que se aplica en cada paso
+	float decay;				//Factor de decaimiento por paso
+	float momentum;				//Qué tanto se acerca el valor al de sus vecinos en cada paso (solo IK_PROPAGATE)
+	bool bHalfPrecision;		//Guarda los valores como geFloat16 (mitad de memoria, se convierten a float al procesarlos)
+
+	geInfluenceLayerDesc() : kernel(IK_PROPAGATE), decay(0.9f), momentum(0.5f), bHalfPrecision(false) {}
+};
+
+class geInfluenceWorker;
+
+/************************************************************************************************************************/
+/* Declaración de la clase geInfluenceMap                               												*/
+/************************************************************************************************************************/
+class geInfluenceMap : public GEE_noncopyable
+{
+	friend class geInfluenceWorker;
+
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geInfluenceMap(void);						//Constructor standard
+	~geInfluenceMap(void);						//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de inicialización y actualización                          												*/
+	/************************************************************************************************************************/
+public:
+	bool Init(geTiledMap* pMap, const int32 numWorkers = -1);	//Asocia las capas a un mapa y crea los hilos de trabajo (-1 usa los procesadores disponibles)
+	void Destroy();											//Destruye las capas y detiene los hilos de trabajo
+	void Update(const int32 rowBudget);						//Avanza la propagación de las capas procesando como máximo rowBudget filas en este ciclo
+
+	int32 AddLayer(const geInfluenceLayerDesc& desc);		//Crea una capa y regresa su índice
+	int32 getNumLayers() const { return (int32)m_layers.size(); }
+
+	/************************************************************************************************************************/
+	/* Funciones de acceso a los valores                                    												*/
+	/************************************************************************************************************************/
+public:
+	//NOTA: Las escrituras se guardan como pendientes y se aplican al comenzar el siguiente paso de la capa, antes de despertar a los hilos de trabajo
+	float getValue(const int32 layer, const int32 x, const int32 y) const;				//Valor de la capa en un tile
+	void setValue(const int32 layer, const int32 x, const int32 y, const float value);	//Establece el valor de la capa en un tile
+	void addValue(const int32 layer, const int32 x, const int32 y, const float value);	//Suma un valor a la capa en un tile (ej. la posición de una unidad)
+	void Clear(const int32 layer);															//Pone en 0 todos los valores de la capa (descarta las escrituras pendientes anteriores)
+
+	float getCoarseValue(const int32 layer, const int32 level, const int32 x, const int32 y) const;	//Promedio del bloque de 2^(level+1) tiles que contiene al tile x,y (level en [0, INFLUENCE_CASCADE_LEVELS))
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	struct PendingWrite
+	{
+		int32 x, y;
+		float value;
+		bool bAdd;									//Suma el valor en lugar de reemplazarlo
+	};
+
+	struct Layer
+	{
+		geInfluenceLayerDesc desc;
+		float *pValues[2];							//Buffers de valores float (actual y destino), filas de m_rowFloats con relleno a los lados
+		geFloat16 *pHalfValues[2];					//Buffers de valores geFloat16 si la capa es de media precisión (filas de m_width)
+		int32 current;								//Índice del buffer con los valores actuales
+		std::vector<float> cascade[INFLUENCE_CASCADE_LEVELS];	//Niveles de menor resolución (se reconstruyen al terminar cada paso)
+		std::vector<PendingWrite> pendingWrites;	//Escrituras que se aplican al comenzar el siguiente paso
+		bool bPendingClear;							//La capa se pone en 0 antes de aplicar las escrituras pendientes
+	};
+
+	void AllocateLayer(Layer& layer);				//Aloja los buffers de una capa con el tamaño actual
+	void FreeLayer(Layer& layer);					//Libera los buffers de una capa
+	void Resize();									//Realoja los buffers con el tamaño actual del mapa (los hilos de trabajo deben estar detenidos esperando trabajo)
+	void QueueWrite(const int32 layer, const int32 x, const int32 y, const float value, const bool bAdd);
+	void ApplyPendingWrites(Layer& layer);			//Aplica las escrituras pendientes al buffer actual de la capa (hilo principal, entre pasos)
+	void ProcessRows(Layer& layer, const int32 iniY, const int32 finY, float* pScratch);	//Aplica el kernel de la capa a un rango de filas (puede llamarse desde los hilos de trabajo)
+	void FinishStep(Layer& layer);					//Intercambia los buffers y reconstruye la cascada
+	float* getScratch(const int32 band) { return &m_scratch[band*m_rowFloats*4]; }
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	geTiledMap *m_pMap;								//Mapa asociado
+	int32 m_width, m_height;						//Tamaño de las capas (igual al del mapa)
+	int32 m_rowFloats;								//Flotantes por fila en los buffers float (incluye relleno, múltiplo de 4)
+
+	std::vector<Layer> m_layers;					//Capas de influencia
+	CriticalSection m_writeLock;					//Protege las escrituras pendientes de todas las capas
+	int32 m_currentLayer;							//Capa cuyo paso está en proceso
+	int32 m_currentRow;								//Siguiente fila a procesar de la capa actual
+
+	std::vector<geInfluenceWorker*> m_workers;		//Hilos de trabajo para las bandas de filas
+	std::vector<float> m_scratch;					//Filas temporales por banda (para convertir capas de media precisión)
+	float *m_pZeroRow;								//Fila de ceros que se usa como vecino fuera del mapa
+};
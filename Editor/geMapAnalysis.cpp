@@ -0,0 +1,574 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geMapAnalysis.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geMapAnalysis
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geMapAnalysis.h"
+
+/************************************************************************************************************************/
+/* Formato del archivo de cache                                         												*/
+/************************************************************************************************************************/
+#define ANALYSIS_CACHE_MAGIC	0x414D4547	//'GEMA'
+#define ANALYSIS_CACHE_VERSION	1
+
+struct geMapAnalysisCacheHeader
+{
+	uint32 magic;
+	uint32 version;
+	int32 width, height;
+	int32 mc;
+	uint64 passabilityHash;
+	int32 numRegions;
+	int32 numChokes;
+	int32 numChokeListEntries;
+};
+
+template<class T>
+static bool WriteCacheArray(FILE* pFile, const std::vector<T>& data)
+{//Escribe un arreglo completo en el archivo
+	return data.empty() || fwrite(&data[0], sizeof(T), data.size(), pFile) == data.size();
+}
+
+template<class T>
+static bool ReadCacheArray(FILE* pFile, std::vector<T>& data, const SIZE_T count)
+{//Lee un arreglo del tamaño indicado desde el archivo
+	data.resize(count);
+	return count == 0 || fread(&data[0], sizeof(T), count, pFile) == count;
+}
+
+/************************************************************************************************************************/
+/* Implementación de geMapPassabilitySnapshot                           												*/
+/************************************************************************************************************************/
+void geMapPassabilitySnapshot::Capture(const geTiledMap* pMap, const eMovementClass movementClass)
+{//Las filas de una clase son contiguas en el mapa, la copia es un solo bloque
+	GEE_ASSERT(pMap);
+	width = pMap->getMapWidth();
+	height = pMap->getMapHeight();
+	rowWords = pMap->getPassabilityRowWords();
+	mc = movementClass;
+	mapVersion = pMap->getVersion();
+	costVersion = pMap->getCostVersion(mc);
+
+	bits.resize(rowWords*height);
+	if( !bits.empty() )
+	{
+		memcpy(&bits[0], pMap->getPassabilityRow(mc, 0), bits.size()*sizeof(uint64));
+	}
+}
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geMapAnalysis::geMapAnalysis(void)
+{//Constructor standard
+	m_width = m_height = 0;
+	m_rowWords = 0;
+	m_mc = MC_VEHICLE;
+	m_passabilityHash = 0;
+	m_mapVersion = 0;
+	m_costVersion = 0;
+}
+
+geMapAnalysis::~geMapAnalysis(void)
+{//Destructor
+	Destroy();
+}
+
+void geMapAnalysis::Destroy()
+{//Libera todos los datos
+	m_width = m_height = 0;
+	m_rowWords = 0;
+	m_altitude.clear();
+	m_region.clear();
+	m_skeletonBits.clear();
+	m_regions.clear();
+	m_chokes.clear();
+	m_regionChokeStart.clear();
+	m_regionChokeList.clear();
+}
+
+void geMapAnalysis::Swap(geMapAnalysis& other)
+{//Solo se intercambian los resultados, los datos temporales siempre quedan vacíos al terminar un análisis
+	std::swap(m_width, other.m_width);
+	std::swap(m_height, other.m_height);
+	std::swap(m_rowWords, other.m_rowWords);
+	std::swap(m_mc, other.m_mc);
+	std::swap(m_passabilityHash, other.m_passabilityHash);
+	std::swap(m_mapVersion, other.m_mapVersion);
+	std::swap(m_costVersion, other.m_costVersion);
+	m_altitude.swap(other.m_altitude);
+	m_region.swap(other.m_region);
+	m_skeletonBits.swap(other.m_skeletonBits);
+	m_regions.swap(other.m_regions);
+	m_chokes.swap(other.m_chokes);
+	m_regionChokeStart.swap(other.m_regionChokeStart);
+	m_regionChokeList.swap(other.m_regionChokeList);
+}
+
+bool geMapAnalysis::Analyze(const geTiledMap* pMap, const eMovementClass mc)
+{//Analiza la transitabilidad actual del mapa
+	geMapPassabilitySnapshot snapshot;
+	snapshot.Capture(pMap, mc);
+	return Analyze(snapshot);
+}
+
+bool geMapAnalysis::Analyze(const geMapPassabilitySnapshot& snapshot)
+{//Analiza la copia de la transitabilidad (no toca el mapa)
+	Destroy();
+
+	if( snapshot.width <= 0 || snapshot.height <= 0 )
+	{
+		return false;
+	}
+
+	m_width = snapshot.width;
+	m_height = snapshot.height;
+	m_rowWords = (m_width+63)>>6;
+	m_mc = snapshot.mc;
+	m_passabilityHash = HashPassability(snapshot);
+	m_mapVersion = snapshot.mapVersion;
+	m_costVersion = snapshot.costVersion;
+
+	ComputeAltitude(snapshot);
+	ComputeSkeleton();
+	ComputeRegions();
+	BuildGraph();
+
+	//Liberamos los datos temporales
+	std::vector<int32>().swap(m_labelParent);
+	std::vector<int32>().swap(m_labelSize);
+	std::vector<uint16>().swap(m_labelTop);
+	std::vector<Frontier>().swap(m_frontier);
+
+	return true;
+}
+
+void geMapAnalysis::ComputeAltitude(const geMapPassabilitySnapshot& snapshot)
+{//Transformada de distancia con chamfer 2-3 (los tiles fuera del mapa cuentan como obstáculos)
+	m_altitude.resize(m_width*m_height);
+	for( int32 tmpY=0; tmpY<m_height; ++tmpY )
+	{
+		for( int32 tmpX=0; tmpX<m_width; ++tmpX )
+		{
+			m_altitude[(tmpY*m_width)+tmpX] = snapshot.isPassable(tmpX, tmpY) ? 0xFFFE : 0;
+		}
+	}
+
+	#define ALTITUDE_AT(x, y) ( ((x) < 0 || (y) < 0 || (x) >= m_width || (y) >= m_height) ? 0 : (int32)m_altitude[((y)*m_width)+(x)] )
+
+	//Pasada hacia adelante (vecinos de arriba y de la izquierda)
+	for( int32 tmpY=0; tmpY<m_height; ++tmpY )
+	{
+		for( int32 tmpX=0; tmpX<m_width; ++tmpX )
+		{
+			uint16& altitude = m_altitude[(tmpY*m_width)+tmpX];
+			if( altitude == 0 ) continue;
+
+			int32 value = altitude;
+			value = Min( value, ALTITUDE_AT(tmpX-1, tmpY) + ANALYSIS_ALTITUDE_ORTHO );
+			value = Min( value, ALTITUDE_AT(tmpX, tmpY-1) + ANALYSIS_ALTITUDE_ORTHO );
+			value = Min( value, ALTITUDE_AT(tmpX-1, tmpY-1) + ANALYSIS_ALTITUDE_DIAG );
+			value = Min( value, ALTITUDE_AT(tmpX+1, tmpY-1) + ANALYSIS_ALTITUDE_DIAG );
+			altitude = (uint16)value;
+		}
+	}
+
+	//Pasada hacia atrás (vecinos de abajo y de la derecha)
+	for( int32 tmpY=m_height-1; tmpY>=0; --tmpY )
+	{
+		for( int32 tmpX=m_width-1; tmpX>=0; --tmpX )
+		{
+			uint16& altitude = m_altitude[(tmpY*m_width)+tmpX];
+			if( altitude == 0 ) continue;
+
+			int32 value = altitude;
+			value = Min( value, ALTITUDE_AT(tmpX+1, tmpY) + ANALYSIS_ALTITUDE_ORTHO );
+			value = Min( value, ALTITUDE_AT(tmpX, tmpY+1) + ANALYSIS_ALTITUDE_ORTHO );
+			value = Min( value, ALTITUDE_AT(tmpX+1, tmpY+1) + ANALYSIS_ALTITUDE_DIAG );
+			value = Min( value, ALTITUDE_AT(tmpX-1, tmpY+1) + ANALYSIS_ALTITUDE_DIAG );
+			altitude = (uint16)value;
+		}
+	}
+
+	#undef ALTITUDE_AT
+}
+
+void geMapAnalysis::ComputeSkeleton()
+{//Un tile está en el esqueleto si es una cresta de la altitud en alguna de las cuatro direcciones
+	static const int32 pairX[4] = { 1, 0, 1, 1 };
+	static const int32 pairY[4] = { 0, 1, 1,-1 };
+
+	m_skeletonBits.assign(m_rowWords*m_height, 0);
+	for( int32 tmpY=0; tmpY<m_height; ++tmpY )
+	{
+		for( int32 tmpX=0; tmpX<m_width; ++tmpX )
+		{
+			int32 altitude = m_altitude[(tmpY*m_width)+tmpX];
+			if( altitude == 0 ) continue;
+
+			for( int32 dir=0; dir<4; ++dir )
+			{
+				int32 x0 = tmpX-pairX[dir], y0 = tmpY-pairY[dir];
+				int32 x1 = tmpX+pairX[dir], y1 = tmpY+pairY[dir];
+				int32 a0 = (x0 < 0 || y0 < 0 || x0 >= m_width || y0 >= m_height) ? 0 : m_altitude[(y0*m_width)+x0];
+				int32 a1 = (x1 < 0 || y1 < 0 || x1 >= m_width || y1 >= m_height) ? 0 : m_altitude[(y1*m_width)+x1];
+				if( altitude >= a0 && altitude >= a1 && (altitude > a0 || altitude > a1) )
+				{
+					m_skeletonBits[(tmpY*m_rowWords)+(tmpX>>6)] |= (uint64)1 << (tmpX&63);
+					break;
+				}
+			}
+		}
+	}
+}
+
+int32 geMapAnalysis::FindRoot(int32 label)
+{//Raíz de una etiqueta (con compresión de camino)
+	while( m_labelParent[label] != label )
+	{
+		m_labelParent[label] = m_labelParent[m_labelParent[label]];
+		label = m_labelParent[label];
+	}
+	return label;
+}
+
+void geMapAnalysis::ComputeRegions()
+{//Crece las regiones desde las cimas de altitud hacia abajo, los pasos quedan donde se encuentran dos regiones grandes
+	static const int32 offsetX[4] = { 1, 0,-1, 0 };
+	static const int32 offsetY[4] = { 0, 1, 0,-1 };
+	int32 numTiles = m_width*m_height;
+
+	//Ordenamos los tiles transitables por altitud descendente (counting sort)
+	int32 maxAltitude = 0;
+	for( int32 i=0; i<numTiles; ++i )
+	{
+		maxAltitude = Max<int32>(maxAltitude, m_altitude[i]);
+	}
+
+	std::vector<int32> altitudeStart(maxAltitude+2, 0);
+	for( int32 i=0; i<numTiles; ++i )
+	{
+		if( m_altitude[i] ) ++altitudeStart[maxAltitude-m_altitude[i]+1];
+	}
+	for( int32 i=0; i<=maxAltitude; ++i )
+	{
+		altitudeStart[i+1] += altitudeStart[i];
+	}
+
+	std::vector<int32> order(altitudeStart[maxAltitude+1]);
+	for( int32 i=0; i<numTiles; ++i )
+	{
+		if( m_altitude[i] ) order[altitudeStart[maxAltitude-m_altitude[i]]++] = i;
+	}
+
+	//Crecemos las regiones
+	std::vector<int32> labels(numTiles, -1);
+	m_labelParent.clear();
+	m_labelSize.clear();
+	m_labelTop.clear();
+	m_frontier.clear();
+
+	for( SIZE_T i=0; i<order.size(); ++i )
+	{
+		int32 index = order[i];
+		int32 tmpX = index % m_width, tmpY = index / m_width;
+		uint16 altitude = m_altitude[index];
+
+		int32 label = -1;
+		for( int32 dir=0; dir<4; ++dir )
+		{
+			int32 nx = tmpX+offsetX[dir], ny = tmpY+offsetY[dir];
+			if( nx < 0 || ny < 0 || nx >= m_width || ny >= m_height || labels[(ny*m_width)+nx] < 0 )
+			{
+				continue;
+			}
+
+			int32 other = FindRoot( labels[(ny*m_width)+nx] );
+			if( label < 0 )
+			{
+				label = other;
+				continue;
+			}
+
+			label = FindRoot(label);
+			if( other == label )
+			{
+				continue;
+			}
+
+			//Dos regiones se encontraron, las unimos si alguna es pequeña o si sus cimas no son mucho más altas que este punto
+			if( Min(m_labelSize[label], m_labelSize[other]) < ANALYSIS_MIN_REGION_TILES ||
+				(float)Min(m_labelTop[label], m_labelTop[other]) < (float)altitude * ANALYSIS_MERGE_RATIO )
+			{
+				int32 bigLabel = (m_labelSize[label] >= m_labelSize[other]) ? label : other;
+				int32 smallLabel = (bigLabel == label) ? other : label;
+				m_labelParent[smallLabel] = bigLabel;
+				m_labelSize[bigLabel] += m_labelSize[smallLabel];
+				m_labelTop[bigLabel] = Max(m_labelTop[bigLabel], m_labelTop[smallLabel]);
+				label = bigLabel;
+			}
+			else
+			{//Este tile es parte de un paso estrecho
+				Frontier frontier;
+				frontier.index = index;
+				frontier.labelA = label;
+				frontier.labelB = other;
+				m_frontier.push_back(frontier);
+			}
+		}
+
+		if( label < 0 )
+		{//Ningún vecino tiene región, es una cima nueva
+			label = (int32)m_labelParent.size();
+			m_labelParent.push_back(label);
+			m_labelSize.push_back(0);
+			m_labelTop.push_back(altitude);
+		}
+
+		labels[index] = label;
+		++m_labelSize[FindRoot(label)];
+	}
+
+	//Asignamos identificadores compactos a las regiones finales
+	std::vector<int32> compact(m_labelParent.size(), -1);
+	m_region.assign(numTiles, ANALYSIS_NO_REGION);
+	m_regions.clear();
+	for( int32 i=0; i<numTiles; ++i )
+	{
+		if( labels[i] < 0 ) continue;
+
+		int32 root = FindRoot(labels[i]);
+		if( compact[root] < 0 )
+		{
+			if( m_regions.size() >= ANALYSIS_NO_REGION )
+			{//No caben más regiones en 16 bits, los tiles restantes se quedan sin región
+				GEE_WARNING( TEXT("geMapAnalysis: el mapa tiene demasiadas regiones aisladas") );
+				continue;
+			}
+
+			compact[root] = (int32)m_regions.size();
+			geMapAnalysisRegion region;
+			region.numTiles = 0;
+			region.topX = region.topY = 0;
+			region.topAltitude = 0;
+			m_regions.push_back(region);
+		}
+
+		int32 tmpX = i % m_width, tmpY = i / m_width;
+		geMapAnalysisRegion& region = m_regions[compact[root]];
+		++region.numTiles;
+		region.bounds.Merge( geMapRegion(tmpX, tmpY, tmpX, tmpY) );
+		if( m_altitude[i] > region.topAltitude )
+		{
+			region.topAltitude = m_altitude[i];
+			region.topX = tmpX;
+			region.topY = tmpY;
+		}
+		m_region[i] = (uint16)compact[root];
+	}
+
+	//Traducimos las etiquetas de las fronteras a regiones finales (descartamos las que terminaron dentro de una misma región)
+	SIZE_T numValid = 0;
+	for( SIZE_T i=0; i<m_frontier.size(); ++i )
+	{
+		Frontier frontier = m_frontier[i];
+		int32 regionA = compact[FindRoot(frontier.labelA)];
+		int32 regionB = compact[FindRoot(frontier.labelB)];
+		if( regionA < 0 || regionB < 0 || regionA == regionB )
+		{
+			continue;
+		}
+
+		frontier.labelA = Min(regionA, regionB);
+		frontier.labelB = Max(regionA, regionB);
+		m_frontier[numValid++] = frontier;
+	}
+	m_frontier.resize(numValid);
+}
+
+void geMapAnalysis::BuildGraph()
+{//Agrupa los tiles de frontera conectados entre el mismo par de regiones en un solo paso estrecho
+	std::vector<int32> frontierAt(m_width*m_height, -1);
+	for( SIZE_T i=0; i<m_frontier.size(); ++i )
+	{
+		frontierAt[m_frontier[i].index] = (int32)i;
+	}
+
+	m_chokes.clear();
+	std::vector<int32> stack;
+	for( SIZE_T i=0; i<m_frontier.size(); ++i )
+	{
+		if( frontierAt[m_frontier[i].index] < 0 )
+		{//Ya pertenece a un paso
+			continue;
+		}
+
+		geMapChokePoint choke;
+		choke.regionA = (uint16)m_frontier[i].labelA;
+		choke.regionB = (uint16)m_frontier[i].labelB;
+		choke.x = choke.y = 0;
+		choke.altitude = 0;
+		choke.numTiles = 0;
+
+		stack.push_back(m_frontier[i].index);
+		frontierAt[m_frontier[i].index] = -1;
+		while( !stack.empty() )
+		{
+			int32 index = stack.back();
+			stack.pop_back();
+
+			int32 tmpX = index % m_width, tmpY = index / m_width;
+			++choke.numTiles;
+			if( m_altitude[index] > choke.altitude )
+			{
+				choke.altitude = m_altitude[index];
+				choke.x = tmpX;
+				choke.y = tmpY;
+			}
+
+			for( int32 ny=Max(tmpY-1, 0); ny<=Min(tmpY+1, m_height-1); ++ny )
+			{
+				for( int32 nx=Max(tmpX-1, 0); nx<=Min(tmpX+1, m_width-1); ++nx )
+				{
+					int32 other = frontierAt[(ny*m_width)+nx];
+					if( other >= 0 && m_frontier[other].labelA == choke.regionA && m_frontier[other].labelB == choke.regionB )
+					{
+						frontierAt[(ny*m_width)+nx] = -1;
+						stack.push_back((ny*m_width)+nx);
+					}
+				}
+			}
+		}
+
+		m_chokes.push_back(choke);
+	}
+
+	//Armamos las listas de pasos de cada región
+	int32 numRegions = (int32)m_regions.size();
+	m_regionChokeStart.assign(numRegions+1, 0);
+	for( SIZE_T i=0; i<m_chokes.size(); ++i )
+	{
+		++m_regionChokeStart[m_chokes[i].regionA+1];
+		++m_regionChokeStart[m_chokes[i].regionB+1];
+	}
+	for( int32 i=0; i<numRegions; ++i )
+	{
+		m_regionChokeStart[i+1] += m_regionChokeStart[i];
+	}
+
+	std::vector<int32> cursor(m_regionChokeStart.begin(), m_regionChokeStart.end()-1);
+	m_regionChokeList.resize(m_regionChokeStart[numRegions]);
+	for( SIZE_T i=0; i<m_chokes.size(); ++i )
+	{
+		m_regionChokeList[cursor[m_chokes[i].regionA]++] = (int32)i;
+		m_regionChokeList[cursor[m_chokes[i].regionB]++] = (int32)i;
+	}
+}
+
+uint64 geMapAnalysis::HashPassability(const geMapPassabilitySnapshot& snapshot)
+{//Hash FNV-1a de los bits de transitabilidad
+	uint64 hash = 14695981039346656037ULL;
+	for( SIZE_T i=0; i<snapshot.bits.size(); ++i )
+	{
+		hash ^= snapshot.bits[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+bool geMapAnalysis::SaveCache(const geString& fileName) const
+{//Guarda el análisis actual
+	if( !isValid() )
+	{
+		return false;
+	}
+
+	FILE* pFile = NULL;
+	_tfopen_s(&pFile, fileName.c_str(), TEXT("wb"));
+	if( !pFile )
+	{
+		GEE_WARNING( TEXT("geMapAnalysis: no se pudo escribir el archivo de cache") );
+		return false;
+	}
+
+	geMapAnalysisCacheHeader header;
+	header.magic = ANALYSIS_CACHE_MAGIC;
+	header.version = ANALYSIS_CACHE_VERSION;
+	header.width = m_width;
+	header.height = m_height;
+	header.mc = m_mc;
+	header.passabilityHash = m_passabilityHash;
+	header.numRegions = (int32)m_regions.size();
+	header.numChokes = (int32)m_chokes.size();
+	header.numChokeListEntries = (int32)m_regionChokeList.size();
+
+	bool bResult = fwrite(&header, sizeof(header), 1, pFile) == 1 &&
+		WriteCacheArray(pFile, m_altitude) &&
+		WriteCacheArray(pFile, m_region) &&
+		WriteCacheArray(pFile, m_skeletonBits) &&
+		WriteCacheArray(pFile, m_regions) &&
+		WriteCacheArray(pFile, m_chokes) &&
+		WriteCacheArray(pFile, m_regionChokeStart) &&
+		WriteCacheArray(pFile, m_regionChokeList);
+
+	fclose(pFile);
+	return bResult;
+}
+
+bool geMapAnalysis::LoadCache(const geString& fileName, const geTiledMap* pMap, const eMovementClass mc)
+{//Lee un análisis guardado y verifica que corresponda a la transitabilidad actual del mapa
+	geMapPassabilitySnapshot snapshot;
+	snapshot.Capture(pMap, mc);
+	return LoadCache(fileName, snapshot);
+}
+
+bool geMapAnalysis::LoadCache(const geString& fileName, const geMapPassabilitySnapshot& snapshot)
+{//Lee un análisis guardado y verifica que corresponda a la copia de la transitabilidad
+	FILE* pFile = NULL;
+	_tfopen_s(&pFile, fileName.c_str(), TEXT("rb"));
+	if( !pFile )
+	{//No hay cache para este mapa
+		return false;
+	}
+
+	geMapAnalysisCacheHeader header;
+	if( fread(&header, sizeof(header), 1, pFile) != 1 ||
+		header.magic != ANALYSIS_CACHE_MAGIC || header.version != ANALYSIS_CACHE_VERSION ||
+		header.width != snapshot.width || header.height != snapshot.height || header.mc != snapshot.mc ||
+		header.passabilityHash != HashPassability(snapshot) )
+	{//El cache es de otra versión o de otro mapa
+		fclose(pFile);
+		return false;
+	}
+
+	Destroy();
+	m_width = header.width;
+	m_height = header.height;
+	m_rowWords = (m_width+63)>>6;
+	m_mc = snapshot.mc;
+	m_passabilityHash = header.passabilityHash;
+	m_mapVersion = snapshot.mapVersion;
+	m_costVersion = snapshot.costVersion;
+
+	bool bResult = ReadCacheArray(pFile, m_altitude, m_width*m_height) &&
+		ReadCacheArray(pFile, m_region, m_width*m_height) &&
+		ReadCacheArray(pFile, m_skeletonBits, m_rowWords*m_height) &&
+		ReadCacheArray(pFile, m_regions, header.numRegions) &&
+		ReadCacheArray(pFile, m_chokes, header.numChokes) &&
+		ReadCacheArray(pFile, m_regionChokeStart, header.numRegions+1) &&
+		ReadCacheArray(pFile, m_regionChokeList, header.numChokeListEntries);
+
+	fclose(pFile);
+	if( !bResult )
+	{//El archivo está incompleto
+		Destroy();
+	}
+	return bResult;
+}
@@ -0,0 +1,158 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geMapAnalysis.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geMapAnalysis
+				Análisis del terreno de un geTiledMap para la IA y el
+				pathfinding jerárquico: transformada de distancia a los
+				obstáculos (altitud), esqueleto del eje medio y división
+				del mapa en regiones separadas por pasos estrechos,
+				guardada como un grafo compacto de regiones. El resultado
+				puede guardarse en un archivo junto al mapa para no
+				repetir el análisis en la siguiente carga. El análisis
+				trabaja sobre una copia de la transitabilidad, así que
+				puede hacerse fuera del hilo principal
+				(geMapAnalysisWorker)
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geTiledMap.h"
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define ANALYSIS_NO_REGION			0xFFFF		//Región de los tiles intransitables
+#define ANALYSIS_ALTITUDE_ORTHO		2			//Altitud que agrega un paso ortogonal en la transformada de distancia
+#define ANALYSIS_ALTITUDE_DIAG		3			//Altitud que agrega un paso diagonal en la transformada de distancia
+#define ANALYSIS_MIN_REGION_TILES	64			//Las regiones más pequeñas que esto se unen a su vecina en lugar de separarse por un paso
+#define ANALYSIS_MERGE_RATIO		1.5f		//Dos regiones se separan si sus cimas son al menos este múltiplo más altas que el paso entre ellas
+#define ANALYSIS_CACHE_EXTENSION	TEXT(".analysis")	//Extensión del archivo de cache que se guarda junto al mapa
+
+//Copia de la transitabilidad de una clase de movimiento (lo único del mapa que lee el análisis)
+struct geMapPassabilitySnapshot
+{
+	int32 width, height;		//Tamaño del mapa
+	int32 rowWords;				//Palabras de 64 bits por fila (igual que en el mapa)
+	eMovementClass mc;			//Clase de movimiento copiada
+	uint32 mapVersion;			//Versión del mapa al hacer la copia
+	uint32 costVersion;			//Versión de la tabla de costos de la clase al hacer la copia
+	std::vector<uint64> bits;	//Plano de transitabilidad de la clase
+
+	geMapPassabilitySnapshot() : width(0), height(0), rowWords(0), mc(MC_VEHICLE), mapVersion(0), costVersion(0) {}
+	void Capture(const geTiledMap* pMap, const eMovementClass movementClass);	//Copia el plano actual del mapa (hilo principal)
+	FORCEINLINE bool isPassable(const int32 x, const int32 y) const { return ((bits[(y*rowWords)+(x>>6)] >> (x&63)) & 1) != 0; }
+};
+
+//Región del mapa (área abierta delimitada por obstáculos y pasos estrechos)
+struct geMapAnalysisRegion
+{
+	int32 numTiles;				//Número de tiles de la región
+	int32 topX, topY;			//Tile de mayor altitud (el punto más alejado de los obstáculos)
+	uint16 topAltitude;			//Altitud de ese tile
+	geMapRegion bounds;			//Rectángulo que contiene la región
+};
+
+//Paso estrecho entre dos regiones
+struct geMapChokePoint
+{
+	uint16 regionA, regionB;	//Regiones que conecta (regionA < regionB)
+	int32 x, y;					//Tile central del paso (el de mayor altitud sobre la frontera)
+	uint16 altitude;			//Altitud del tile central (la mitad del ancho del paso, en unidades de altitud)
+	int32 numTiles;				//Número de tiles de la frontera
+};
+
+/************************************************************************************************************************/
+/* Declaración de la clase geMapAnalysis                                												*/
+/************************************************************************************************************************/
+class geMapAnalysis : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geMapAnalysis(void);						//Constructor standard
+	~geMapAnalysis(void);						//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de análisis y cache                                        												*/
+	/************************************************************************************************************************/
+public:
+	bool Analyze(const geTiledMap* pMap, const eMovementClass mc = MC_VEHICLE);		//Analiza la transitabilidad actual del mapa para la clase de movimiento indicada
+	bool Analyze(const geMapPassabilitySnapshot& snapshot);							//Analiza una copia de la transitabilidad (puede llamarse desde otro hilo)
+	bool LoadCache(const geString& fileName, const geTiledMap* pMap, const eMovementClass mc = MC_VEHICLE);	//Lee un análisis guardado, regresa false si no existe o no corresponde al mapa actual
+	bool LoadCache(const geString& fileName, const geMapPassabilitySnapshot& snapshot);	//Igual, validando contra una copia de la transitabilidad
+	bool SaveCache(const geString& fileName) const;									//Guarda el análisis actual
+	void Destroy();																	//Libera todos los datos
+	void Swap(geMapAnalysis& other);												//Intercambia los resultados con otro análisis (para publicar uno hecho en otro hilo)
+
+	bool isValid() const { return m_width > 0; }
+	uint32 getMapVersion() const { return m_mapVersion; }		//Versión del mapa con la que se hizo el análisis (para saber si ya está obsoleto)
+	uint32 getCostVersion() const { return m_costVersion; }		//Versión de la tabla de costos de la clase con la que se hizo el análisis
+	eMovementClass getMovementClass() const { return m_mc; }
+
+	/************************************************************************************************************************/
+	/* Funciones de consulta                                                												*/
+	/************************************************************************************************************************/
+public:
+	FORCEINLINE uint16 getAltitude(const int32 x, const int32 y) const { return m_altitude[(y*m_width)+x]; }
+	FORCEINLINE uint16 getRegion(const int32 x, const int32 y) const { return m_region[(y*m_width)+x]; }
+	FORCEINLINE bool isSkeleton(const int32 x, const int32 y) const { return ((m_skeletonBits[(y*m_rowWords)+(x>>6)] >> (x&63)) & 1) != 0; }
+
+	int32 getNumRegions() const { return (int32)m_regions.size(); }
+	const geMapAnalysisRegion& getRegionInfo(const int32 region) const { return m_regions[region]; }
+	int32 getNumChokePoints() const { return (int32)m_chokes.size(); }
+	const geMapChokePoint& getChokePoint(const int32 choke) const { return m_chokes[choke]; }
+
+	const int32* getRegionChokePoints(const int32 region, int32& numChokes) const	//Pasos estrechos de una región (aristas del grafo)
+	{
+		numChokes = m_regionChokeStart[region+1] - m_regionChokeStart[region];
+		return numChokes ? &m_regionChokeList[m_regionChokeStart[region]] : NULL;
+	}
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	void ComputeAltitude(const geMapPassabilitySnapshot& snapshot);		//Transformada de distancia con chamfer 2-3 en dos pasadas
+	void ComputeSkeleton();													//Marca las crestas de la altitud (eje medio)
+	void ComputeRegions();													//Divide los tiles en regiones creciendo desde las cimas hacia los pasos
+	void BuildGraph();														//Agrupa las fronteras en pasos estrechos y arma las listas de cada región
+	static uint64 HashPassability(const geMapPassabilitySnapshot& snapshot);	//Hash de la transitabilidad para validar el cache
+
+	int32 FindRoot(int32 label);				//Raíz de una etiqueta en el union-find del crecimiento de regiones
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	int32 m_width, m_height;					//Tamaño del mapa analizado
+	int32 m_rowWords;							//Palabras de 64 bits por fila en el plano del esqueleto
+	eMovementClass m_mc;						//Clase de movimiento analizada
+	uint64 m_passabilityHash;					//Hash de la transitabilidad analizada
+	uint32 m_mapVersion;						//Versión del mapa con la que se hizo el análisis
+	uint32 m_costVersion;						//Versión de la tabla de costos con la que se hizo el análisis
+
+	std::vector<uint16> m_altitude;				//Distancia de cada tile al obstáculo más cercano (0 en los obstáculos)
+	std::vector<uint16> m_region;				//Región de cada tile (ANALYSIS_NO_REGION en los obstáculos)
+	std::vector<uint64> m_skeletonBits;			//Bit por tile que indica si está en el esqueleto
+
+	std::vector<geMapAnalysisRegion> m_regions;	//Nodos del grafo
+	std::vector<geMapChokePoint> m_chokes;		//Aristas del grafo
+	std::vector<int32> m_regionChokeStart;		//Inicio de la lista de pasos de cada región en m_regionChokeList (con una entrada extra al final)
+	std::vector<int32> m_regionChokeList;		//Pasos estrechos de todas las regiones, agrupados por región
+
+	//Datos temporales del crecimiento de regiones
+	struct Frontier
+	{
+		int32 index;							//Tile de la frontera
+		int32 labelA, labelB;					//Etiquetas de las regiones que se encontraron en él
+	};
+	std::vector<int32> m_labelParent;			//Padre de cada etiqueta en el union-find
+	std::vector<int32> m_labelSize;				//Número de tiles de cada etiqueta raíz
+	std::vector<uint16> m_labelTop;				//Altitud máxima de cada etiqueta raíz
+	std::vector<Frontier> m_frontier;			//Tiles donde se encontraron dos regiones que no se unieron
+};
@@ -0,0 +1,97 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geMapAnalysisWorker.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geMapAnalysisWorker
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geMapAnalysisWorker.h"
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geMapAnalysisWorker::geMapAnalysisWorker(void)
+{//Constructor standard
+	m_state = AS_IDLE;
+}
+
+geMapAnalysisWorker::~geMapAnalysisWorker(void)
+{//Destructor
+	Cancel();
+}
+
+bool geMapAnalysisWorker::Begin(const geTiledMap* pMap, const geString& cacheFileName, const eMovementClass mc)
+{//Comienza el análisis de la transitabilidad actual del mapa
+	GEE_ASSERT(pMap);
+
+	//Si había un análisis en proceso lo descartamos primero
+	Cancel();
+
+	m_snapshot.Capture(pMap, mc);
+	m_cacheFileName = cacheFileName;
+	setState(AS_RUNNING);
+
+	if( !Start() )
+	{//No pudimos crear el hilo de trabajo
+		GEE_WARNING(TEXT("geMapAnalysisWorker::Begin: Falló al crear el hilo de análisis para ") + cacheFileName);
+		setState(AS_FAILED);
+		return false;
+	}
+
+	return true;
+}
+
+void geMapAnalysisWorker::Cancel()
+{//Esperamos al hilo y descartamos lo que haya calculado
+	RequestStop();
+	Join();
+
+	m_result.Destroy();
+	setState(AS_IDLE);
+}
+
+bool geMapAnalysisWorker::Publish(geMapAnalysis& target)
+{//Pasa el resultado al hilo principal cuando el hilo de trabajo termina
+	if( m_state == AS_RUNNING )
+	{
+		return false;
+	}
+
+	//El hilo ya terminó su trabajo, liberamos su manejador
+	Join();
+	if( m_state != AS_FINISHED )
+	{
+		return false;
+	}
+
+	target.Swap(m_result);
+	m_result.Destroy();
+	setState(AS_IDLE);
+	return true;
+}
+
+uint32 geMapAnalysisWorker::Run()
+{//Función del hilo de trabajo
+	//Leemos el análisis del cache, o lo calculamos y lo guardamos si no existe o ya no corresponde al mapa
+	if( !m_result.LoadCache(m_cacheFileName, m_snapshot) )
+	{
+		if( !m_result.Analyze(m_snapshot) )
+		{
+			setState(AS_FAILED);
+			return 1;
+		}
+
+		if( !IsStopRequested() )
+		{//Un análisis cancelado no se guarda (el mapa pudo haber cambiado)
+			m_result.SaveCache(m_cacheFileName);
+		}
+	}
+
+	setState(AS_FINISHED);
+	return 0;
+}
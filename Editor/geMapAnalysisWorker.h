@@ -0,0 +1,70 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geMapAnalysisWorker.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geMapAnalysisWorker
+				Hilo de trabajo que lee del cache o calcula el análisis
+				de regiones de un mapa. La transitabilidad se copia en
+				el hilo principal al comenzar, así que el mapa puede
+				seguir editándose mientras se analiza; el resultado se
+				publica en el hilo principal con Publish()
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geMapAnalysis.h"
+
+/************************************************************************************************************************/
+/* Declaración de la clase geMapAnalysisWorker                          												*/
+/************************************************************************************************************************/
+class geMapAnalysisWorker : public geThread
+{
+	/************************************************************************************************************************/
+	/* Tipo definido enumerador para reconocer los estados del análisis														*/
+	/************************************************************************************************************************/
+public:
+	typedef enum ANALYSISSTATE
+	{
+		AS_IDLE,					//No hay ningún análisis en proceso
+		AS_RUNNING,					//El hilo de trabajo está leyendo el cache o analizando
+		AS_FINISHED,				//El resultado está listo para publicarse
+		AS_FAILED					//El mapa no pudo analizarse
+	}ANALYSISSTATETYPE;
+
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geMapAnalysisWorker(void);					//Constructor standard
+	virtual ~geMapAnalysisWorker(void);			//Destructor (espera a que termine el análisis en proceso)
+
+	/************************************************************************************************************************/
+	/* Funciones de control del análisis                                    												*/
+	/************************************************************************************************************************/
+public:
+	bool Begin(const geTiledMap* pMap, const geString& cacheFileName, const eMovementClass mc = MC_VEHICLE);	//Copia la transitabilidad y comienza el análisis (el resultado se guarda en el cache al terminar)
+	void Cancel();																			//Descarta el análisis actual (espera a que termine el hilo, el análisis no puede interrumpirse)
+	bool Publish(geMapAnalysis& target);													//Debe llamarse cada ciclo desde el hilo principal, regresa true si el resultado se pasó a target en esta llamada
+
+	ANALYSISSTATETYPE getState() const { return (ANALYSISSTATETYPE)m_state; }
+	bool isBusy() const { return m_state == AS_RUNNING; }
+
+protected:
+	virtual uint32 Run();						//Función del hilo de trabajo
+
+private:
+	void setState(const ANALYSISSTATETYPE state) { InterlockedExchange(&m_state, state); }
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	geMapPassabilitySnapshot m_snapshot;		//Copia de la transitabilidad que se analiza (pertenece al hilo de trabajo mientras corre)
+	geMapAnalysis m_result;						//Análisis calculado por el hilo de trabajo
+	geString m_cacheFileName;					//Archivo de cache que se lee o se escribe
+
+	volatile LONG m_state;						//Estado actual del análisis (ANALYSISSTATETYPE)
+};
@@ -0,0 +1,320 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geMapEditHistory.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geMapEditHistory
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geMapEditHistory.h"
+
+/************************************************************************************************************************/
+/* Formato de una edición codificada																					*/
+/*																														*/
+/* Los datos de una edición son una secuencia de tramos, cada tramo es:													*/
+/*     - Delta del índice inicial respecto al final del tramo anterior (varint con zigzag, ya que puede ser negativo)	*/
+/*     - Longitud del tramo (varint)																					*/
+/*     - Tipos anteriores, tipos nuevos, costos especiales anteriores y nuevos, cada uno comprimido con RLE				*/
+/*       como pares (longitud de la corrida en varint, valor)															*/
+/************************************************************************************************************************/
+#define EDITHISTORY_DEFAULT_BUDGET (16*MEGABYTE)
+
+static void WriteVarUInt(std::vector<uint8>& data, uint32 value)
+{//Escribe un entero sin signo usando 7 bits por byte
+	while( value >= 0x80 )
+	{
+		data.push_back( (uint8)(value | 0x80) );
+		value >>= 7;
+	}
+	data.push_back( (uint8)value );
+}
+
+static uint32 ReadVarUInt(const uint8*& pData)
+{//Lee un entero escrito con WriteVarUInt
+	uint32 value = 0;
+	uint32 shift = 0;
+	uint8 byte;
+	do
+	{
+		byte = *pData++;
+		value |= (uint32)(byte & 0x7F) << shift;
+		shift += 7;
+	}while( byte & 0x80 );
+
+	return value;
+}
+
+static void WriteRLE(std::vector<uint8>& data, const uint8* pValues, const int32 count)
+{//Escribe los valores como corridas (longitud, valor)
+	int32 i = 0;
+	while( i < count )
+	{
+		int32 run = 1;
+		while( i+run < count && pValues[i+run] == pValues[i] ) ++run;
+		WriteVarUInt(data, (uint32)run);
+		data.push_back(pValues[i]);
+		i += run;
+	}
+}
+
+static void ReadRLE(const uint8*& pData, uint8* pValues, const int32 count)
+{//Decodifica corridas escritas con WriteRLE (si pValues es NULL solo las salta)
+	int32 i = 0;
+	while( i < count )
+	{
+		int32 run = (int32)ReadVarUInt(pData);
+		uint8 value = *pData++;
+		if( pValues != NULL )
+		{
+			memset(&pValues[i], value, run);
+		}
+		i += run;
+	}
+}
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geMapEditHistory::geMapEditHistory(void)
+{//Constructor standard
+	m_pMap = NULL;
+	m_mapVersion = 0;
+	m_width = m_height = 0;
+	m_memoryUsed = 0;
+	m_memoryBudget = EDITHISTORY_DEFAULT_BUDGET;
+}
+
+geMapEditHistory::~geMapEditHistory(void)
+{//Destructor
+}
+
+void geMapEditHistory::Attach(geTiledMap* pMap)
+{//Asocia el historial a un mapa
+	m_pMap = pMap;
+	Reset();
+}
+
+void geMapEditHistory::Reset()
+{//Descarta el historial y copia el estado actual del mapa
+	m_undoStack.clear();
+	m_redoStack.clear();
+	m_memoryUsed = 0;
+
+	if( m_pMap == NULL )
+	{
+		return;
+	}
+
+	m_width = m_pMap->getMapWidth();
+	m_height = m_pMap->getMapHeight();
+	m_shadowTypes.resize(m_width*m_height);
+	m_shadowCosts.resize(m_width*m_height);
+	for( int32 tmpY=0; tmpY<m_height; ++tmpY )
+	{
+		memcpy(&m_shadowTypes[tmpY*m_width], m_pMap->getTypeRow(tmpY), m_width);
+		m_pMap->ReadCostOverrides(0, tmpY, m_width, &m_shadowCosts[tmpY*m_width]);
+	}
+
+	m_mapVersion = m_pMap->getVersion();
+}
+
+bool geMapEditHistory::CommitEdit()
+{//Guarda como una sola edición los cambios hechos desde la última llamada
+	GEE_ASSERT(m_pMap);
+	if( m_pMap->getVersion() == m_mapVersion )
+	{//El mapa no ha cambiado
+		return false;
+	}
+
+	if( m_pMap->getMapWidth() != m_width || m_pMap->getMapHeight() != m_height || !m_pMap->isFullyLoaded() )
+	{//El mapa fue reinicializado o se está cargando, el historial anterior ya no aplica
+		Reset();
+		return false;
+	}
+
+	//Solo comparamos las regiones que el journal del mapa marca como modificadas (si el journal ya no las cubre, comparamos todo el mapa)
+	std::vector<geMapRegion> regions;
+	if( !m_pMap->getDirtyRegionsSince(m_mapVersion, regions) )
+	{
+		regions.clear();
+		regions.push_back( geMapRegion(0, 0, m_width-1, m_height-1) );
+	}
+
+	EditRecord record;
+	int32 lastIndex = 0;
+	for( SIZE_T i=0; i<regions.size(); ++i )
+	{
+		DiffRegion(regions[i], record, lastIndex);
+	}
+	m_mapVersion = m_pMap->getVersion();
+
+	if( record.data.empty() )
+	{//Los cambios dejaron el mapa igual
+		return false;
+	}
+
+	//Una nueva edición invalida lo que se había deshecho
+	for( SIZE_T i=0; i<m_redoStack.size(); ++i )
+	{
+		m_memoryUsed -= m_redoStack[i].data.size();
+	}
+	m_redoStack.clear();
+
+	m_memoryUsed += record.data.size();
+	m_undoStack.push_back(record);
+	TrimToBudget();
+
+	return true;
+}
+
+bool geMapEditHistory::Undo()
+{//Deshace la última edición
+	if( !m_pMap->isEditable() )
+	{//El mapa se está cargando, no puede escribirse
+		return false;
+	}
+
+	//Primero guardamos los cambios pendientes para que la copia coincida con el mapa
+	CommitEdit();
+	if( m_undoStack.empty() )
+	{
+		return false;
+	}
+
+	ApplyRecord(m_undoStack.back(), true);
+	m_redoStack.push_back(m_undoStack.back());
+	m_undoStack.pop_back();
+	return true;
+}
+
+bool geMapEditHistory::Redo()
+{//Rehace la última edición deshecha
+	if( !m_pMap->isEditable() )
+	{//El mapa se está cargando, no puede escribirse
+		return false;
+	}
+
+	//NOTA: Si hubo cambios nuevos, CommitEdit() vacía la pila de redo
+	CommitEdit();
+	if( m_redoStack.empty() )
+	{
+		return false;
+	}
+
+	ApplyRecord(m_redoStack.back(), false);
+	m_undoStack.push_back(m_redoStack.back());
+	m_redoStack.pop_back();
+	return true;
+}
+
+void geMapEditHistory::DiffRegion(const geMapRegion& region, EditRecord& record, int32& lastIndex)
+{//Compara una región del mapa con la copia, codifica los tramos diferentes y actualiza la copia
+	geMapRegion clipped = region;
+	clipped.Clip(m_width, m_height);
+	if( clipped.isEmpty() )
+	{
+		return;
+	}
+
+	//Los costos especiales del mapa son dispersos, así que los copiamos fila por fila a un buffer para compararlos
+	std::vector<int8> costRow(m_width);
+	const int8* pCostRow = &costRow[0];
+
+	for( int32 tmpY=clipped.minY; tmpY<=clipped.maxY; ++tmpY )
+	{
+		const uint8* pTypeRow = m_pMap->getTypeRow(tmpY);
+		m_pMap->ReadCostOverrides(0, tmpY, m_width, &costRow[0]);
+		uint8* pShadowTypes = &m_shadowTypes[tmpY*m_width];
+		int8* pShadowCosts = &m_shadowCosts[tmpY*m_width];
+
+		int32 tmpX = clipped.minX;
+		while( tmpX <= clipped.maxX )
+		{
+			//Buscamos el inicio del siguiente tramo diferente
+			if( pTypeRow[tmpX] == pShadowTypes[tmpX] && pCostRow[tmpX] == pShadowCosts[tmpX] )
+			{
+				++tmpX;
+				continue;
+			}
+
+			int32 iniX = tmpX;
+			while( tmpX <= clipped.maxX && (pTypeRow[tmpX] != pShadowTypes[tmpX] || pCostRow[tmpX] != pShadowCosts[tmpX]) ) ++tmpX;
+			int32 length = tmpX-iniX;
+
+			//Codificamos el tramo
+			int32 index = (tmpY*m_width)+iniX;
+			int32 delta = index-lastIndex;
+			WriteVarUInt(record.data, ((uint32)delta<<1) ^ (uint32)(delta>>31));
+			WriteVarUInt(record.data, (uint32)length);
+			WriteRLE(record.data, &pShadowTypes[iniX], length);
+			WriteRLE(record.data, &pTypeRow[iniX], length);
+			WriteRLE(record.data, (const uint8*)&pShadowCosts[iniX], length);
+			WriteRLE(record.data, (const uint8*)&pCostRow[iniX], length);
+			lastIndex = index+length;
+
+			//Actualizamos la copia para que las regiones que se traslapan no repitan el tramo
+			memcpy(&pShadowTypes[iniX], &pTypeRow[iniX], length);
+			memcpy(&pShadowCosts[iniX], &pCostRow[iniX], length);
+
+			record.bounds.Merge( geMapRegion(iniX, tmpY, tmpX-1, tmpY) );
+		}
+	}
+}
+
+void geMapEditHistory::ApplyRecord(const EditRecord& record, const bool bUndo)
+{//Escribe los valores anteriores (undo) o nuevos (redo) de la edición
+	//Decodificamos los tramos sobre la copia
+	const uint8* pData = &record.data[0];
+	const uint8* pEnd = pData+record.data.size();
+	int32 lastIndex = 0;
+	while( pData < pEnd )
+	{
+		uint32 zigzag = ReadVarUInt(pData);
+		int32 index = lastIndex + (int32)((zigzag>>1) ^ (0-(zigzag&1)));
+		int32 length = (int32)ReadVarUInt(pData);
+
+		uint8* pTypes = &m_shadowTypes[index];
+		uint8* pCosts = (uint8*)&m_shadowCosts[index];
+		ReadRLE(pData, bUndo ? pTypes : NULL, length);
+		ReadRLE(pData, bUndo ? NULL : pTypes, length);
+		ReadRLE(pData, bUndo ? pCosts : NULL, length);
+		ReadRLE(pData, bUndo ? NULL : pCosts, length);
+		lastIndex = index+length;
+	}
+
+	//La copia coincide con el mapa fuera de la edición, así que pegamos el área de la edición como una sola operación en bloque
+	geMapBlock block;
+	block.width = record.bounds.getWidth();
+	block.height = record.bounds.getHeight();
+	block.types.resize(block.width*block.height);
+	block.costs.resize(block.width*block.height);
+	for( int32 tmpY=0; tmpY<block.height; ++tmpY )
+	{
+		int32 index = ((record.bounds.minY+tmpY)*m_width)+record.bounds.minX;
+		memcpy(&block.types[tmpY*block.width], &m_shadowTypes[index], block.width);
+		memcpy(&block.costs[tmpY*block.width], &m_shadowCosts[index], block.width);
+	}
+	m_pMap->PasteBlock(record.bounds.minX, record.bounds.minY, block);
+
+	//El cambio que acabamos de hacer no es una edición nueva
+	m_mapVersion = m_pMap->getVersion();
+}
+
+void geMapEditHistory::TrimToBudget()
+{//Descarta las ediciones más antiguas hasta estar dentro del límite de memoria
+	SIZE_T numToErase = 0;
+	while( m_memoryUsed > m_memoryBudget && numToErase < m_undoStack.size() )
+	{
+		m_memoryUsed -= m_undoStack[numToErase].data.size();
+		++numToErase;
+	}
+
+	if( numToErase > 0 )
+	{
+		m_undoStack.erase(m_undoStack.begin(), m_undoStack.begin()+numToErase);
+	}
+}
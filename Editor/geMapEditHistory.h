@@ -0,0 +1,77 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geMapEditHistory.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geMapEditHistory
+				Guarda el historial de ediciones de un geTiledMap para
+				poder deshacerlas y rehacerlas. Cada edición se guarda
+				solo como los tramos de tiles que cambiaron, con sus
+				valores anteriores y nuevos comprimidos con RLE
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geTiledMap.h"
+
+/************************************************************************************************************************/
+/* Declaración de la clase geMapEditHistory                             												*/
+/************************************************************************************************************************/
+class geMapEditHistory : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geMapEditHistory(void);						//Constructor standard
+	~geMapEditHistory(void);					//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de control del historial                                   												*/
+	/************************************************************************************************************************/
+public:
+	void Attach(geTiledMap* pMap);				//Asocia el historial a un mapa (descarta el historial anterior)
+	void Reset();								//Descarta el historial y toma el estado actual del mapa como punto de partida
+	bool CommitEdit();							//Guarda como una sola edición todos los cambios hechos al mapa desde la última llamada, regresa true si se guardó algo
+
+	bool Undo();								//Deshace la última edición
+	bool Redo();								//Rehace la última edición deshecha
+
+	bool canUndo() const { return !m_undoStack.empty(); }
+	bool canRedo() const { return !m_redoStack.empty(); }
+	SIZE_T getMemoryUsed() const { return m_memoryUsed; }				//Memoria utilizada por las ediciones guardadas (sin contar la copia del mapa)
+	void setMemoryBudget(const SIZE_T bytes) { m_memoryBudget = bytes; TrimToBudget(); }	//Límite de memoria, las ediciones más antiguas se descartan al rebasarlo
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	struct EditRecord
+	{
+		geMapRegion bounds;						//Región que contiene todos los tiles modificados
+		std::vector<uint8> data;				//Tramos codificados (ver geMapEditHistory.cpp)
+	};
+
+	void DiffRegion(const geMapRegion& region, EditRecord& record, int32& lastIndex);	//Compara una región del mapa con la copia y codifica los tramos diferentes
+	void ApplyRecord(const EditRecord& record, const bool bUndo);						//Escribe los valores anteriores o nuevos de una edición en la copia y en el mapa
+	void TrimToBudget();																//Descarta ediciones antiguas hasta estar dentro del límite de memoria
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	geTiledMap *m_pMap;							//Mapa asociado
+	uint32 m_mapVersion;						//Versión del mapa que corresponde a la copia
+
+	//Copia del mapa en la última edición guardada (filas sin relleno de longitud m_width), de aquí se obtienen los valores anteriores de cada cambio
+	std::vector<uint8> m_shadowTypes;
+	std::vector<int8> m_shadowCosts;			//Costos especiales (MAP_COST_NO_OVERRIDE donde no hay)
+	int32 m_width, m_height;
+
+	std::vector<EditRecord> m_undoStack;		//Ediciones que pueden deshacerse (la última es la más reciente)
+	std::vector<EditRecord> m_redoStack;		//Ediciones deshechas que pueden rehacerse
+	SIZE_T m_memoryUsed;						//Memoria utilizada por los tramos de ambas pilas
+	SIZE_T m_memoryBudget;						//Límite de memoria para los tramos
+};
@@ -4,9 +4,101 @@
 
 geMapGridWalker::geMapGridWalker(void)
 {
+	m_pTiledMap = NULL;
+	m_unitSize = 1;
+	m_movementClass = MC_INFANTRY;
+	m_overlayVersion = 0;
+	m_changedHead = 0;
+	m_tileStatesSerial = 0;
+	m_costVersion = 0;
 }
 
 
 geMapGridWalker::~geMapGridWalker(void)
 {
 }
+
+void geMapGridWalker::AddTileMarker(const int32 x, const int32 y, const SDL_Color& color)
+{//Perímetro del tile como una línea continua (el diamante en mapas isométricos)
+	int32 scrX, scrY;
+	m_pTiledMap->getMapToScreenCoords(x, y, scrX, scrY);
+
+	SDL_Point points[5];
+#ifdef MAP_IS_ISOMETRIC
+	points[0].x = scrX+TILEHALFSIZE_X;	points[0].y = scrY;
+	points[1].x = scrX+TILESIZE_X;		points[1].y = scrY+TILEHALFSIZE_Y;
+	points[2].x = scrX+TILEHALFSIZE_X;	points[2].y = scrY+TILESIZE_Y;
+	points[3].x = scrX;					points[3].y = scrY+TILEHALFSIZE_Y;
+#else
+	points[0].x = scrX;					points[0].y = scrY;
+	points[1].x = scrX+TILESIZE_X;		points[1].y = scrY;
+	points[2].x = scrX+TILESIZE_X;		points[2].y = scrY+TILESIZE_Y;
+	points[3].x = scrX;					points[3].y = scrY+TILESIZE_Y;
+#endif // MAP_IS_ISOMETRIC
+	points[4] = points[0];
+
+	m_overlay.AddLines(points, 5, color);
+}
+
+void geMapGridWalker::AddPathLine(const geMapTileNode* pEnd, const geMapTileNode* pStart, const int32 maxNodes, const SDL_Color& color)
+{//Une los centros de los tiles de la ruta en una sola línea continua
+	//NOTA: Los padres no se limpian entre búsquedas, por eso limitamos el recorrido al número de nodos
+	std::vector<SDL_Point> points;
+	const geMapTileNode* pNode = pEnd;
+	for( int32 i=0; pNode != NULL && i<maxNodes; ++i )
+	{
+		SDL_Point point;
+		m_pTiledMap->getMapToScreenCoords(pNode->m_x, pNode->m_y, point.x, point.y);
+		point.x += TILEHALFSIZE_X;
+		point.y += TILEHALFSIZE_Y;
+		points.push_back(point);
+
+		if( pNode == pStart )
+		{
+			break;
+		}
+		pNode = pNode->m_parent;
+	}
+
+	if( points.size() >= 2 )
+	{
+		m_overlay.AddLines(&points[0], (int32)points.size(), color);
+	}
+}
+
+void geMapGridWalker::ResetTileStates()
+{//Limpia el plano (y lo realoja si el mapa cambió de tamaño), quien lo dibuje debe empezar de cero
+	SIZE_T numTiles = (SIZE_T)(m_pTiledMap->getMapHeight()<<m_pTiledMap->getMapStrideShift());
+	m_tileStates.assign(numTiles, WTS_NONE);
+	m_changedTiles.clear();
+	m_changedHead = 0;
+	++m_tileStatesSerial;
+}
+
+void geMapGridWalker::ReleaseTileStates()
+{//Libera el plano de estados
+	m_tileStates.clear();
+	m_changedTiles.clear();
+	m_changedHead = 0;
+	++m_tileStatesSerial;
+}
+
+int32 geMapGridWalker::PopChangedTiles(std::vector<int32>& tiles, const int32 maxTiles)
+{//Saca los cambios más antiguos, el resto queda para la siguiente llamada
+	tiles.clear();
+	int32 count = Min(maxTiles, getNumChangedTiles());
+	for( int32 i=0; i<count; ++i )
+	{
+		int32 index = m_changedTiles[m_changedHead+i];
+		m_tileStates[index] &= WALKER_TILE_STATE_MASK;	//Si vuelve a cambiar se agrega otra vez
+		tiles.push_back(index);
+	}
+	m_changedHead += count;
+
+	if( m_changedHead == (int32)m_changedTiles.size() )
+	{//Ya no quedan cambios, reutilizamos la memoria
+		m_changedTiles.clear();
+		m_changedHead = 0;
+	}
+	return count;
+}
@@ -16,6 +16,22 @@
 #include "geTiledMap.h"
 #include "geMapTileNode.h"
 
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+//Estado de un tile durante la búsqueda (para la visualización de depuración)
+enum eWalkerTileState
+{
+	WTS_NONE = 0,		//No se ha tocado
+	WTS_OPEN,			//Está en la lista abierta
+	WTS_CLOSED,			//Ya se procesó
+	WTS_PATH,			//Forma parte de la ruta encontrada
+	WTS_NUM_STATES
+};
+
+#define WALKER_TILE_STATE_MASK		0x7F	//Bits del estado dentro del plano
+#define WALKER_TILE_STATE_QUEUED	0x80	//Bit que indica que el tile ya está en la lista de cambios
+
 /************************************************************************************************************************/
 /* Declaración de la clase geMapGridWalker                              												*/
 /************************************************************************************************************************/
@@ -37,7 +53,7 @@ public:
 	/************************************************************************************************************************/
 public:
 	geMapGridWalker(void);
-	geMapGridWalker(geTiledMap *pMap) { m_pTiledMap = pMap; }
+	geMapGridWalker(geTiledMap *pMap) { m_pTiledMap = pMap; m_unitSize = 1; m_movementClass = MC_INFANTRY; m_overlayVersion = 0; m_changedHead = 0; m_tileStatesSerial = 0; m_costVersion = 0; }
 	virtual ~geMapGridWalker(void);
 
 	/************************************************************************************************************************/
@@ -48,7 +64,7 @@ public:
 	virtual bool Init(){return false;}									//Función de inicialización de la clase (por default en este aspecto regresamos false porque no estamos haciendo nada)
 	virtual void Destroy()=0;											//Destruye los objetos de la clase
 	virtual WALKSTATETYPE Update()=0;									//Actualiza el estado del pathfinding (puede hacerse por pasos o recursivamente)
-	virtual void Render()=0;											//Renderea la información necesaria para su uso en pathfinding
+	virtual void Render(geRenderQueue& queue)=0;						//Agrega los comandos de dibujo de la información de depuración del pathfinding
 	virtual void Reset()=0;												//Reinicializa las variables de esta clase para su uso en un nuevo cálculo
 
 	virtual bool weightedGraphSupported(){ return false; }				//Indica si este Walker soporta la asignación y el uso de pesos a los nodos del graph
@@ -57,15 +73,50 @@ public:
 	void setTiledMap(geTiledMap *pMap){ m_pTiledMap = pMap; }			//Establecemos un puntero al mapa que será utilizado para todos los cálculos
 	geTiledMap *getMapGrid() { return m_pTiledMap; }					//Regresa el puntero al mapa que se está utilizando para todos los cálculos
 
-	void setStartPosition(const int32 x, const int32 y) {m_StartX = x; m_StartY = y;}	//Esta función se utiliza para establecer el punto inicial de búsqueda
-	void setEndPosition(const int32 x, const int32 y) {m_EndX = x; m_EndY = y;}			//Esta función se utiliza para establecer el punto final de la búsqueda
+	void setStartPosition(const int32 x, const int32 y) {m_StartX = x; m_StartY = y; InvalidateOverlay();}	//Esta función se utiliza para establecer el punto inicial de búsqueda
+	void setEndPosition(const int32 x, const int32 y) {m_EndX = x; m_EndY = y; InvalidateOverlay();}			//Esta función se utiliza para establecer el punto final de la búsqueda
 
 	void getStartPosition(int32 & x, int32 & y){x=m_StartX; y=m_StartY;}				//Función de ayuda para obtener el punto inicial de búsqueda
 	void getEndPosition(int32 & x, int32 & y){x=m_EndX; y=m_EndY;}						//Función de ayuda para obtener el punto final de búsqueda
 
+	void setUnitSize(const uint8 size) { GEE_ASSERT(size >= 1 && size <= MAP_MAX_CLEARANCE); m_unitSize = size; }	//Establece el tamaño en tiles de la unidad que buscará la ruta (la unidad ocupa un cuadro de size x size a partir de su tile)
+	uint8 getUnitSize() const { return m_unitSize; }
+
+	void setMovementClass(const eMovementClass mc) { m_movementClass = mc; }	//Establece la clase de movimiento de la unidad (determina por que terrenos puede pasar)
+	eMovementClass getMovementClass() const { return m_movementClass; }
+
+	//Plano de estados de los tiles para la visualización (un byte por tile, indexado igual que los planos del mapa)
+	bool hasTileStates() const { return !m_tileStates.empty(); }
+	uint8 getTileState(const int32 index) const { return m_tileStates[index] & WALKER_TILE_STATE_MASK; }
+	uint32 getTileStatesSerial() const { return m_tileStatesSerial; }	//Cambia cuando el plano completo se limpia o se realoja (hay que redibujar todo)
+	int32 getNumChangedTiles() const { return (int32)m_changedTiles.size() - m_changedHead; }
+	int32 PopChangedTiles(std::vector<int32>& tiles, const int32 maxTiles);	//Saca de la lista hasta maxTiles índices de tiles cuyo estado cambió (en el orden en que cambiaron), regresa cuántos sacó
+
 protected:
 	virtual void visitGridNode(int32 x, int32 y) = 0;					//Marca un nodo de mapa como visitado (esto lo procesa según el algoritmo utilizado)
 
+	void InvalidateOverlay() { ++m_overlayVersion; }					//Indica que las líneas de depuración deben generarse otra vez
+	void SyncCostVersion() { m_costVersion = m_pTiledMap->getCostVersion(m_movementClass); }			//Guarda la versión de la tabla de costos con la que comienza la búsqueda
+	bool isCostTableChanged() const { return m_pTiledMap->getCostVersion(m_movementClass) != m_costVersion; }	//Indica si la tabla de costos de la clase cambió desde que comenzó la búsqueda
+	void AddTileMarker(const int32 x, const int32 y, const SDL_Color& color);	//Agrega al overlay el perímetro de un tile
+	void AddPathLine(const geMapTileNode* pEnd, const geMapTileNode* pStart, const int32 maxNodes, const SDL_Color& color);	//Agrega al overlay la ruta siguiendo los padres desde el nodo final
+
+	void ResetTileStates();												//Ajusta el plano de estados al mapa y lo limpia
+	void ReleaseTileStates();											//Libera el plano de estados
+	FORCEINLINE void setTileState(const int32 index, const uint8 state)
+	{//Cambia el estado de un tile y lo agrega a la lista de cambios si no estaba ya
+		uint8& tileState = m_tileStates[index];
+		if( (tileState & WALKER_TILE_STATE_MASK) == state )
+		{
+			return;
+		}
+		if( !(tileState & WALKER_TILE_STATE_QUEUED) )
+		{
+			m_changedTiles.push_back(index);
+		}
+		tileState = state | WALKER_TILE_STATE_QUEUED;
+	}
+
 	/************************************************************************************************************************/
 	/* Declaración de variables miembro de la clase                                 										*/
 	/************************************************************************************************************************/
@@ -73,4 +124,13 @@ protected:
 	geTiledMap *m_pTiledMap;									//Puntero al mapa que estamos usando para calcular
 	int32 m_StartX, m_StartY;									//Variables que contendrán la posición de inicio de búsqueda
 	int32 m_EndX, m_EndY;										//Variables que contendrán la posición de destino a buscar
+	uint8 m_unitSize;											//Tamaño de la unidad en tiles (se descartan los tiles con clearance menor)
+	eMovementClass m_movementClass;								//Clase de movimiento de la unidad
+	geOverlayBatch m_overlay;									//Líneas de depuración en pantalla (ruta, inicio y fin)
+	uint32 m_overlayVersion;									//Cambia cada vez que el contenido del overlay cambia
+	std::vector<uint8> m_tileStates;							//Estado de cada tile en la búsqueda actual (eWalkerTileState más el bit de cambio pendiente)
+	std::vector<int32> m_changedTiles;							//Tiles cuyo estado cambió y no se han dibujado
+	int32 m_changedHead;										//Primer elemento de m_changedTiles que no se ha sacado
+	uint32 m_tileStatesSerial;									//Número de serie del plano de estados
+	uint32 m_costVersion;										//Versión de la tabla de costos de la clase con la que se hizo la búsqueda actual
 };
@@ -0,0 +1,121 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geMapViewSpans.h
+	Author:		Samuel Prince
+
+	Purpose:	Cálculo exacto de los tiles visibles de un mapa como
+				rangos [iniX, finX] por fila. En un mapa isométrico el
+				rectángulo de la pantalla es un rombo en coordenadas de
+				mapa, así que recorrer el rectángulo que lo contiene
+				visita casi el doble de tiles de los que se ven.
+				Solo depende de geCore para poder probarse sin SDL
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Declaración de estructuras                                           												*/
+/************************************************************************************************************************/
+//Parámetros de la vista (todas las coordenadas de pantalla son inclusivas)
+struct geMapView
+{
+	int32 startX, startY;		//Esquina superior izquierda del área de impresión
+	int32 endX, endY;			//Esquina inferior derecha del área de impresión
+	int32 defaceX, defaceY;		//Posición en pantalla del tile 0,0 (m_PreCalc_ScreenDeface)
+	int32 mapWidth, mapHeight;	//Tamaño del mapa en tiles
+	int32 tileShiftX;			//Log2 del ancho de un tile en pixeles
+	int32 tileShiftY;			//Log2 del alto de un tile en pixeles
+	bool bIsometric;			//Indica si el mapa es isométrico
+};
+
+//Rango de tiles visibles de una fila del mapa
+struct geMapRowSpan
+{
+	int32 y;
+	int32 iniX, finX;
+};
+
+/************************************************************************************************************************/
+/* Funciones                                                            												*/
+/************************************************************************************************************************/
+static FORCEINLINE int32 FloorShift(const int32 value, const int32 shift) { return value >> shift; }			//floor(value / 2^shift)
+static FORCEINLINE int32 CeilShift(const int32 value, const int32 shift) { return -((-value) >> shift); }		//ceil(value / 2^shift)
+
+static FORCEINLINE void getMapViewTileScreenPos(const geMapView& view, const int32 x, const int32 y, int32& scrX, int32& scrY)
+{//Posición en pantalla de la esquina superior izquierda de un tile (igual que geTiledMap::getMapToScreenCoords)
+	if( view.bIsometric )
+	{
+		scrX = ((x - y) << (view.tileShiftX-1)) + view.defaceX;
+		scrY = ((x + y) << (view.tileShiftY-1)) + view.defaceY;
+	}
+	else
+	{
+		scrX = (x << view.tileShiftX) + view.defaceX;
+		scrY = (y << view.tileShiftY) + view.defaceY;
+	}
+}
+
+static FORCEINLINE bool isMapViewTileVisible(const geMapView& view, const int32 x, const int32 y)
+{//Prueba directa: el rectángulo del tile toca el área de impresión
+	int32 scrX, scrY;
+	getMapViewTileScreenPos(view, x, y, scrX, scrY);
+	return scrX <= view.endX && scrY <= view.endY &&
+		scrX + (1<<view.tileShiftX) - 1 >= view.startX && scrY + (1<<view.tileShiftY) - 1 >= view.startY;
+}
+
+static inline int32 ComputeMapViewSpans(const geMapView& view, std::vector<geMapRowSpan>& spans)
+{//Llena la lista con los tiles visibles de cada fila (solo filas con al menos un tile), regresa el número de tiles visibles
+	spans.clear();
+	if( view.mapWidth <= 0 || view.mapHeight <= 0 || view.endX < view.startX || view.endY < view.startY )
+	{
+		return 0;
+	}
+
+	//Las condiciones de isMapViewTileVisible despejadas para la coordenada que avanza en cada eje de pantalla:
+	//	scrX <= endX  y  scrX + anchoTile-1 >= startX  ->  uMin <= u <= uMax
+	//	scrY <= endY  y  scrY + altoTile-1 >= startY   ->  vMin <= v <= vMax
+	//En un mapa isométrico u = x-y y v = x+y (la mitad del tamaño del tile por unidad), en uno cuadrado u = x y v = y
+	int32 shiftU = view.bIsometric ? view.tileShiftX-1 : view.tileShiftX;
+	int32 shiftV = view.bIsometric ? view.tileShiftY-1 : view.tileShiftY;
+	int32 uMin = CeilShift( view.startX - view.defaceX - ((1<<view.tileShiftX)-1), shiftU );
+	int32 uMax = FloorShift( view.endX - view.defaceX, shiftU );
+	int32 vMin = CeilShift( view.startY - view.defaceY - ((1<<view.tileShiftY)-1), shiftV );
+	int32 vMax = FloorShift( view.endY - view.defaceY, shiftV );
+
+	//Filas que pueden tener algún tile visible
+	int32 iniY = 0, finY = view.mapHeight-1;
+	if( view.bIsometric )
+	{
+		iniY = Max( iniY, Max(-uMax, vMin-(view.mapWidth-1)) );
+		finY = Min( finY, Min(vMax, (view.mapWidth-1)-uMin) );
+	}
+	else
+	{
+		iniY = Max(iniY, vMin);
+		finY = Min(finY, vMax);
+	}
+
+	int32 numTiles = 0;
+	for( int32 y=iniY; y<=finY; ++y )
+	{
+		geMapRowSpan span;
+		span.y = y;
+		if( view.bIsometric )
+		{//x = u+y = v-y
+			span.iniX = Max( Max(uMin+y, vMin-y), 0 );
+			span.finX = Min( Min(uMax+y, vMax-y), view.mapWidth-1 );
+		}
+		else
+		{
+			span.iniX = Max(uMin, 0);
+			span.finX = Min(uMax, view.mapWidth-1);
+		}
+
+		if( span.iniX <= span.finX )
+		{
+			spans.push_back(span);
+			numTiles += span.finX-span.iniX+1;
+		}
+	}
+
+	return numTiles;
+}
@@ -0,0 +1,420 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geMinimap.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geMinimap
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geMinimap.h"
+#include <emmintrin.h>
+
+/************************************************************************************************************************/
+/* Colores de los terrenos (ARGB8888)                                   												*/
+/************************************************************************************************************************/
+static const uint32 s_terrainColors[TT_NUM_OBJECTS] =
+{
+	0xFF2050C0,		//TT_WATER
+	0xFF40A040,		//TT_WALKABLE
+	0xFF6B7A30,		//TT_MARSH
+	0xFF707070		//TT_OBSTACLE
+};
+
+static FORCEINLINE uint32 ShadeColor(const uint32 color, const uint32 shade)
+{//Multiplica los canales de color por shade/256 (el alpha queda opaco)
+	uint32 rb = (((color & 0x00FF00FF) * shade) >> 8) & 0x00FF00FF;
+	uint32 g = (((color & 0x0000FF00) * shade) >> 8) & 0x0000FF00;
+	return 0xFF000000 | rb | g;
+}
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geMinimap::geMinimap(void)
+{//Constructor standard
+	m_pMap = NULL;
+	m_pFog = NULL;
+	m_pRenderer = NULL;
+	m_pTexture = NULL;
+	m_player = 0;
+	m_shift = MINIMAP_DEFAULT_SHIFT;
+	m_width = m_height = 0;
+	m_mapWidth = m_mapHeight = 0;
+	m_mapVersion = m_fogVersion = 0;
+	m_bTextureStale = true;
+}
+
+geMinimap::~geMinimap(void)
+{//Destructor
+	Destroy();
+}
+
+bool geMinimap::Init(SDL_Renderer* pRenderer, geTiledMap* pMap, geFogOfWar* pFog, const int32 player, const int32 scaleShift)
+{//Asocia el minimapa a un mapa y construye la imagen completa
+	GEE_ASSERT(pMap);
+	GEE_ASSERT( scaleShift >= 0 && scaleShift <= MINIMAP_MAX_SHIFT );
+
+	Destroy();
+	m_pRenderer = pRenderer;
+	m_pMap = pMap;
+	m_pFog = pFog;
+	m_player = player;
+	m_shift = scaleShift;
+
+	Resize();
+	Rebuild();
+	return true;
+}
+
+void geMinimap::Destroy()
+{//Libera la imagen y la textura
+	if( m_pTexture != NULL )
+	{
+		SDL_DestroyTexture(m_pTexture);
+		m_pTexture = NULL;
+	}
+
+	m_terrain.clear();
+	m_pixels.clear();
+	m_columnSums.clear();
+	m_rowColors.clear();
+	m_blockSums.clear();
+	m_dirtyPixels = geMapRegion();
+	m_width = m_height = 0;
+	m_mapWidth = m_mapHeight = 0;
+	m_pMap = NULL;
+	m_pFog = NULL;
+	m_pRenderer = NULL;
+}
+
+void geMinimap::Resize()
+{//Ajusta la imagen al tamaño actual del mapa
+	m_mapWidth = m_pMap->getMapWidth();
+	m_mapHeight = m_pMap->getMapHeight();
+
+	int32 blockMask = (1<<m_shift)-1;
+	int32 width = (m_mapWidth+blockMask)>>m_shift;
+	int32 height = (m_mapHeight+blockMask)>>m_shift;
+	if( (width != m_width || height != m_height) && m_pTexture != NULL )
+	{//La textura ya no tiene el tamaño de la imagen
+		SDL_DestroyTexture(m_pTexture);
+		m_pTexture = NULL;
+	}
+
+	m_width = width;
+	m_height = height;
+	m_terrain.assign(m_width*m_height, MINIMAP_UNEXPLORED_COLOR);
+	m_pixels.assign(m_width*m_height, MINIMAP_UNEXPLORED_COLOR);
+	m_bTextureStale = true;
+}
+
+uint32 geMinimap::getTerrainColor(const uint8 idtype)
+{//Color de un tipo de terreno (los tipos desconocidos se pintan en magenta para que se noten)
+	return (idtype < TT_NUM_OBJECTS) ? s_terrainColors[idtype] : 0xFFFF00FF;
+}
+
+geMapRegion geMinimap::TilesToPixels(const geMapRegion& tiles) const
+{//Pixeles cuyos bloques tocan la región de tiles
+	return geMapRegion( tiles.minX>>m_shift, tiles.minY>>m_shift, tiles.maxX>>m_shift, tiles.maxY>>m_shift );
+}
+
+void geMinimap::Rebuild(const bool bUseSIMD)
+{//Recalcula la imagen completa
+	if( m_pMap == NULL || m_width == 0 || m_height == 0 )
+	{
+		return;
+	}
+
+	m_mapVersion = m_pMap->getVersion();
+	if( m_pFog != NULL && m_player < m_pFog->getNumPlayers() )
+	{
+		m_fogVersion = m_pFog->getVisionVersion(m_player);
+	}
+
+	geMapRegion allPixels(0, 0, m_width-1, m_height-1);
+	if( bUseSIMD )
+	{
+		DownsampleSSE2(allPixels);
+	}
+	else
+	{
+		DownsampleScalar(allPixels);
+	}
+	ComposeFog(allPixels);
+}
+
+bool geMinimap::Update()
+{//Recalcula solo los pixeles que cubren los cambios
+	if( m_pMap == NULL )
+	{
+		return false;
+	}
+
+	if( m_pMap->getMapWidth() != m_mapWidth || m_pMap->getMapHeight() != m_mapHeight )
+	{//El mapa fue reinicializado con otro tamaño
+		Resize();
+		Rebuild();
+		return true;
+	}
+
+	bool bChanged = false;
+	if( m_pMap->getVersion() != m_mapVersion )
+	{//Recalculamos el terreno de los bloques que tocan las regiones modificadas
+		std::vector<geMapRegion> regions;
+		if( !m_pMap->getDirtyRegionsSince(m_mapVersion, regions) )
+		{//El journal ya no cubre nuestra versión
+			Rebuild();
+			return true;
+		}
+		m_mapVersion = m_pMap->getVersion();
+
+		for( SIZE_T i=0; i<regions.size(); ++i )
+		{
+			geMapRegion region = regions[i];
+			region.Clip(m_mapWidth, m_mapHeight);
+			if( region.isEmpty() )
+			{
+				continue;
+			}
+
+			geMapRegion pixels = TilesToPixels(region);
+			DownsampleSSE2(pixels);
+			ComposeFog(pixels);
+			bChanged = true;
+		}
+	}
+
+	if( m_pFog != NULL && m_player < m_pFog->getNumPlayers() && m_pFog->getVisionVersion(m_player) != m_fogVersion )
+	{//Aplicamos otra vez la niebla donde cambió la visión
+		geMapRegion region;
+		if( !m_pFog->getVisionChangesSince(m_player, m_fogVersion, region) )
+		{
+			region = geMapRegion(0, 0, m_mapWidth-1, m_mapHeight-1);
+		}
+		m_fogVersion = m_pFog->getVisionVersion(m_player);
+
+		region.Clip(m_mapWidth, m_mapHeight);
+		if( !region.isEmpty() )
+		{
+			ComposeFog( TilesToPixels(region) );
+			bChanged = true;
+		}
+	}
+
+	return bChanged;
+}
+
+void geMinimap::setPlayer(const int32 player)
+{//Cambia el jugador cuya niebla se muestra
+	m_player = player;
+	if( m_pMap != NULL && m_width > 0 && m_height > 0 )
+	{
+		if( m_pFog != NULL && m_player < m_pFog->getNumPlayers() )
+		{
+			m_fogVersion = m_pFog->getVisionVersion(m_player);
+		}
+		ComposeFog( geMapRegion(0, 0, m_width-1, m_height-1) );
+	}
+}
+
+void geMinimap::DownsampleSSE2(const geMapRegion& pixels)
+{//Filtro de caja: sumamos en vertical los canales de cada columna de tiles con SSE2 (8 canales de 16 bits por registro) y despues cada bloque en horizontal
+	const int32 blockSize = 1<<m_shift;
+	const int32 tileMinX = pixels.minX<<m_shift;
+	const int32 tileMaxX = Min( (pixels.maxX+1)<<m_shift, m_mapWidth )-1;
+	const int32 numTiles = tileMaxX-tileMinX+1;
+	const int32 numTilesPadded = (numTiles+3) & ~3;	//Los tiles de relleno quedan en 0 y no se leen al sumar los bloques
+
+	m_rowColors.assign(numTilesPadded, 0);
+	m_columnSums.resize(numTilesPadded*4);
+	m_blockSums.resize((pixels.maxX-pixels.minX+1)*4);
+	const __m128i vZero = _mm_setzero_si128();
+
+	for( int32 py=pixels.minY; py<=pixels.maxY; ++py )
+	{
+		const int32 tileMinY = py<<m_shift;
+		const int32 tileMaxY = Min(tileMinY+blockSize, m_mapHeight)-1;
+		memset(&m_columnSums[0], 0, m_columnSums.size()*sizeof(uint16));
+
+		for( int32 ty=tileMinY; ty<=tileMaxY; ++ty )
+		{
+			const uint8* pTypes = m_pMap->getTypeRow(ty)+tileMinX;
+			for( int32 i=0; i<numTiles; ++i )
+			{
+				m_rowColors[i] = getTerrainColor(pTypes[i]);
+			}
+
+			//Cada registro tiene 4 tiles, se expanden a 16 bits (2 tiles por mitad) y se acumulan
+			for( int32 i=0; i<numTilesPadded; i+=4 )
+			{
+				__m128i vColors = _mm_loadu_si128( (const __m128i*)&m_rowColors[i] );
+				__m128i* pSumsLo = (__m128i*)&m_columnSums[i*4];
+				__m128i* pSumsHi = (__m128i*)&m_columnSums[(i*4)+8];
+				_mm_storeu_si128( pSumsLo, _mm_add_epi16( _mm_loadu_si128(pSumsLo), _mm_unpacklo_epi8(vColors, vZero) ) );
+				_mm_storeu_si128( pSumsHi, _mm_add_epi16( _mm_loadu_si128(pSumsHi), _mm_unpackhi_epi8(vColors, vZero) ) );
+			}
+		}
+
+		//Sumamos las columnas de cada bloque (los bloques del borde pueden tener menos columnas)
+		for( int32 px=pixels.minX; px<=pixels.maxX; ++px )
+		{
+			const int32 first = (px<<m_shift)-tileMinX;
+			const int32 last = Min(first+blockSize, numTiles);
+			uint32* pBlock = &m_blockSums[(px-pixels.minX)*4];
+			pBlock[0] = pBlock[1] = pBlock[2] = pBlock[3] = 0;
+			for( int32 i=first; i<last; ++i )
+			{
+				const uint16* pColumn = &m_columnSums[i*4];
+				pBlock[0] += pColumn[0];
+				pBlock[1] += pColumn[1];
+				pBlock[2] += pColumn[2];
+				pBlock[3] += pColumn[3];
+			}
+		}
+
+		ResolveRow(py, pixels.minX, pixels.maxX, &m_blockSums[0], tileMaxY-tileMinY+1);
+	}
+}
+
+void geMinimap::DownsampleScalar(const geMapRegion& pixels)
+{//Filtro de caja sin SIMD (referencia para comparar resultados)
+	const int32 blockSize = 1<<m_shift;
+	m_blockSums.resize((pixels.maxX-pixels.minX+1)*4);
+
+	for( int32 py=pixels.minY; py<=pixels.maxY; ++py )
+	{
+		const int32 tileMinY = py<<m_shift;
+		const int32 tileMaxY = Min(tileMinY+blockSize, m_mapHeight)-1;
+		for( int32 px=pixels.minX; px<=pixels.maxX; ++px )
+		{
+			const int32 tileMinX = px<<m_shift;
+			const int32 tileMaxX = Min(tileMinX+blockSize, m_mapWidth)-1;
+			uint32* pBlock = &m_blockSums[(px-pixels.minX)*4];
+			pBlock[0] = pBlock[1] = pBlock[2] = pBlock[3] = 0;
+			for( int32 ty=tileMinY; ty<=tileMaxY; ++ty )
+			{
+				const uint8* pTypes = m_pMap->getTypeRow(ty);
+				for( int32 tx=tileMinX; tx<=tileMaxX; ++tx )
+				{
+					uint32 color = getTerrainColor(pTypes[tx]);
+					pBlock[0] += color & 0xFF;
+					pBlock[1] += (color>>8) & 0xFF;
+					pBlock[2] += (color>>16) & 0xFF;
+					pBlock[3] += color>>24;
+				}
+			}
+		}
+
+		ResolveRow(py, pixels.minX, pixels.maxX, &m_blockSums[0], tileMaxY-tileMinY+1);
+	}
+}
+
+void geMinimap::ResolveRow(const int32 py, const int32 minX, const int32 maxX, const uint32* pSums, const int32 numRows)
+{//Promedia las sumas de cada bloque con redondeo
+	uint32* pTerrain = &m_terrain[py*m_width];
+	for( int32 px=minX; px<=maxX; ++px )
+	{
+		const uint32 count = (uint32)( numRows * (Min((px+1)<<m_shift, m_mapWidth) - (px<<m_shift)) );
+		const uint32* pBlock = &pSums[(px-minX)*4];
+		uint32 color = 0;
+		for( int32 channel=0; channel<4; ++channel )
+		{
+			color |= ((pBlock[channel] + (count>>1)) / count) << (channel<<3);
+		}
+		pTerrain[px] = color;
+	}
+}
+
+void geMinimap::ComposeFog(const geMapRegion& pixels)
+{//Un pixel se ve completo si algún tile del bloque es visible, oscurecido si alguno fue explorado, y negro si no
+	m_dirtyPixels.Merge(pixels);
+
+	const bool bHasFog = (m_pFog != NULL) && (m_player < m_pFog->getNumPlayers());
+	const int32 blockSize = 1<<m_shift;
+	for( int32 py=pixels.minY; py<=pixels.maxY; ++py )
+	{
+		const uint32* pTerrain = &m_terrain[py*m_width];
+		uint32* pPixels = &m_pixels[py*m_width];
+		if( !bHasFog )
+		{
+			memcpy(&pPixels[pixels.minX], &pTerrain[pixels.minX], (pixels.maxX-pixels.minX+1)*sizeof(uint32));
+			continue;
+		}
+
+		const int32 tileMinY = py<<m_shift;
+		const int32 tileMaxY = Min(tileMinY+blockSize, m_mapHeight)-1;
+		for( int32 px=pixels.minX; px<=pixels.maxX; ++px )
+		{
+			const int32 tileMinX = px<<m_shift;
+			const int32 tileMaxX = Min(tileMinX+blockSize, m_mapWidth)-1;
+			bool bVisible = false, bExplored = false;
+			for( int32 ty=tileMinY; ty<=tileMaxY && !bVisible; ++ty )
+			{
+				const uint16* pVisibility = m_pFog->getVisibilityRow(m_player, ty);
+				for( int32 tx=tileMinX; tx<=tileMaxX; ++tx )
+				{
+					if( pVisibility[tx] != 0 )
+					{
+						bVisible = true;
+						break;
+					}
+					bExplored = bExplored || m_pFog->isExplored(m_player, tx, ty);
+				}
+			}
+
+			if( bVisible )
+			{
+				pPixels[px] = pTerrain[px];
+			}
+			else if( bExplored )
+			{
+				pPixels[px] = ShadeColor(pTerrain[px], MINIMAP_EXPLORED_SHADE);
+			}
+			else
+			{
+				pPixels[px] = MINIMAP_UNEXPLORED_COLOR;
+			}
+		}
+	}
+}
+
+void geMinimap::Render(geRenderQueue& queue, const SDL_Rect& dst)
+{//Sube los pixeles modificados y agrega la copia al GUI
+	if( m_pRenderer == NULL || m_width == 0 || m_height == 0 )
+	{
+		return;
+	}
+
+	if( m_pTexture == NULL )
+	{
+		m_pTexture = SDL_CreateTexture(m_pRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, m_width, m_height);
+		if( m_pTexture == NULL )
+		{
+			GEE_WARNING( TEXT("geMinimap::Render: Falló al crear la textura del minimapa: ") + s2gs(SDL_GetError()) );
+			return;
+		}
+		m_bTextureStale = true;
+	}
+
+	if( m_bTextureStale )
+	{
+		m_dirtyPixels = geMapRegion(0, 0, m_width-1, m_height-1);
+		m_bTextureStale = false;
+	}
+
+	if( !m_dirtyPixels.isEmpty() )
+	{//Solo copiamos el rectángulo que cambió
+		SDL_Rect rect = { m_dirtyPixels.minX, m_dirtyPixels.minY, m_dirtyPixels.getWidth(), m_dirtyPixels.getHeight() };
+		if( SDL_UpdateTexture(m_pTexture, &rect, &m_pixels[(m_dirtyPixels.minY*m_width)+m_dirtyPixels.minX], getPitch()) != 0 )
+		{
+			GEE_WARNING( TEXT("geMinimap::Render: Falló al actualizar la textura del minimapa: ") + s2gs(SDL_GetError()) );
+		}
+		ClearDirtyPixels();
+	}
+
+	queue.AddCopy(RL_GUI, m_pTexture, NULL, dst);
+}
@@ -0,0 +1,103 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geMinimap.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geMinimap
+				Imagen reducida del mapa (un pixel por bloque cuadrado
+				de tiles) con el color promedio de los terrenos y la
+				niebla de guerra de un jugador encima. La imagen se
+				construye una vez con un filtro de caja en SSE2 y
+				despues solo se recalculan los pixeles que cubren las
+				regiones modificadas del mapa o de la visión. Los
+				pixeles se pueden leer directamente (sin renderer)
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geTiledMap.h"
+#include "geFogOfWar.h"
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define MINIMAP_DEFAULT_SHIFT		2			//Log2 del lado del bloque de tiles que representa cada pixel
+#define MINIMAP_MAX_SHIFT			4			//Con bloques de hasta 16 tiles la suma vertical de una columna cabe en 16 bits
+#define MINIMAP_EXPLORED_SHADE		96			//Brillo (de 256) de los pixeles explorados que ningún observador ve
+#define MINIMAP_UNEXPLORED_COLOR	0xFF000000	//Color de los pixeles que el jugador nunca ha visto (ARGB)
+
+/************************************************************************************************************************/
+/* Declaración de la clase geMinimap                                    												*/
+/************************************************************************************************************************/
+class geMinimap : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geMinimap(void);							//Constructor standard
+	~geMinimap(void);							//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de inicialización y actualización                          												*/
+	/************************************************************************************************************************/
+public:
+	bool Init(SDL_Renderer* pRenderer, geTiledMap* pMap, geFogOfWar* pFog = NULL, const int32 player = 0, const int32 scaleShift = MINIMAP_DEFAULT_SHIFT);	//pRenderer y pFog pueden ser NULL (sin textura o sin niebla)
+	void Destroy();
+	bool Update();								//Recalcula los pixeles bajo los cambios del mapa y de la visión (llamar despues de geFogOfWar::Update()), regresa true si cambió algún pixel
+	void Rebuild(const bool bUseSIMD = true);	//Recalcula la imagen completa
+
+	void Render(geRenderQueue& queue, const SDL_Rect& dst);	//Sube a la textura solo los pixeles modificados y agrega la copia en la capa del GUI
+
+	/************************************************************************************************************************/
+	/* Funciones de acceso a la imagen                                      												*/
+	/************************************************************************************************************************/
+public:
+	const uint32* getPixels() const { return m_pixels.empty() ? NULL : &m_pixels[0]; }	//Imagen final en ARGB8888 (terreno con niebla)
+	const uint32* getTerrainPixels() const { return m_terrain.empty() ? NULL : &m_terrain[0]; }	//Promedio del terreno sin niebla
+	int32 getWidth() const { return m_width; }
+	int32 getHeight() const { return m_height; }
+	int32 getPitch() const { return m_width*(int32)sizeof(uint32); }	//Bytes por fila
+	int32 getScaleShift() const { return m_shift; }
+	const geMapRegion& getDirtyPixels() const { return m_dirtyPixels; }	//Pixeles modificados desde la última vez que se subieron a la textura
+	void ClearDirtyPixels() { m_dirtyPixels = geMapRegion(); }
+
+	void setPlayer(const int32 player);			//Cambia el jugador cuya niebla se muestra
+	static uint32 getTerrainColor(const uint8 idtype);	//Color de un tipo de terreno (ARGB8888)
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	void Resize();												//Ajusta la imagen al tamaño actual del mapa
+	geMapRegion TilesToPixels(const geMapRegion& tiles) const;	//Pixeles que cubren la región de tiles
+	void DownsampleSSE2(const geMapRegion& pixels);				//Filtro de caja con la suma vertical en SSE2
+	void DownsampleScalar(const geMapRegion& pixels);			//Filtro de caja de referencia
+	void ResolveRow(const int32 py, const int32 minX, const int32 maxX, const uint32* pSums, const int32 numRows);	//Divide las sumas de una fila de pixeles entre el número de tiles de cada bloque
+	void ComposeFog(const geMapRegion& pixels);					//Aplica la niebla del jugador sobre el terreno
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	geTiledMap *m_pMap;						//Mapa que representa
+	geFogOfWar *m_pFog;						//Visibilidad de los jugadores (NULL si no se muestra niebla)
+	SDL_Renderer *m_pRenderer;				//Renderer con el que se crea la textura (NULL si solo se usan los pixeles)
+	SDL_Texture *m_pTexture;				//Textura de streaming con la imagen
+	int32 m_player;							//Jugador cuya niebla se muestra
+	int32 m_shift;							//Log2 del lado del bloque de tiles por pixel
+	int32 m_width, m_height;				//Tamaño de la imagen en pixeles
+	int32 m_mapWidth, m_mapHeight;			//Tamaño del mapa con el que se construyó
+	uint32 m_mapVersion;					//Versión del mapa reflejada en la imagen
+	uint32 m_fogVersion;					//Versión de la visión reflejada en la imagen
+	bool m_bTextureStale;					//La textura debe subirse completa (recién creada)
+
+	std::vector<uint32> m_terrain;			//Color promedio del terreno de cada bloque
+	std::vector<uint32> m_pixels;			//Imagen final con la niebla
+	std::vector<uint16> m_columnSums;		//Sumas verticales por canal de una fila de pixeles (4 por tile)
+	std::vector<uint32> m_rowColors;		//Colores de un tramo de fila de tiles
+	std::vector<uint32> m_blockSums;		//Sumas por canal de cada pixel de una fila (4 por pixel)
+	geMapRegion m_dirtyPixels;				//Pixeles pendientes de subir a la textura
+};
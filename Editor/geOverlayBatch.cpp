@@ -0,0 +1,105 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geOverlayBatch.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geOverlayBatch
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geOverlayBatch.h"
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geOverlayBatch::geOverlayBatch(void)
+{//Constructor standard
+	m_bValid = false;
+	m_bStripOpen = false;
+}
+
+geOverlayBatch::~geOverlayBatch(void)
+{//Destructor
+}
+
+void geOverlayBatch::Begin(const geOverlayKey& key)
+{//Vacía el contenido (conservamos la memoria alojada)
+	m_key = key;
+	m_bValid = true;
+	m_bStripOpen = false;
+	m_strips.clear();
+	m_points.clear();
+}
+
+void geOverlayBatch::AddLine(const int32 x0, const int32 y0, const int32 x1, const int32 y1, const SDL_Color& color)
+{//Agrega un segmento, uniéndolo a la lista anterior cuando es posible
+	if( m_bStripOpen )
+	{
+		Strip& last = m_strips.back();
+		const SDL_Point& lastPoint = m_points.back();
+		if( !last.bPoints && SameColor(last, color) && lastPoint.x == x0 && lastPoint.y == y0 )
+		{
+			SDL_Point point = { x1, y1 };
+			m_points.push_back(point);
+			++last.count;
+			return;
+		}
+	}
+
+	SDL_Point points[2] = { { x0, y0 }, { x1, y1 } };
+	AddLines(points, 2, color);
+}
+
+void geOverlayBatch::AddLines(const SDL_Point* pPoints, const int32 numPoints, const SDL_Color& color)
+{//Abre una lista nueva con la línea continua
+	if( numPoints < 2 )
+	{
+		return;
+	}
+
+	Strip strip;
+	strip.first = (int32)m_points.size();
+	strip.count = numPoints;
+	strip.color = color;
+	strip.bPoints = false;
+	m_strips.push_back(strip);
+	m_points.insert(m_points.end(), pPoints, pPoints+numPoints);
+	m_bStripOpen = true;
+}
+
+void geOverlayBatch::AddPoint(const int32 x, const int32 y, const SDL_Color& color)
+{//Agrega un punto a la lista anterior o abre una nueva
+	SDL_Point point = { x, y };
+	if( !m_bStripOpen || !m_strips.back().bPoints || !SameColor(m_strips.back(), color) )
+	{
+		Strip strip;
+		strip.first = (int32)m_points.size();
+		strip.count = 0;
+		strip.color = color;
+		strip.bPoints = true;
+		m_strips.push_back(strip);
+		m_bStripOpen = true;
+	}
+
+	m_points.push_back(point);
+	++m_strips.back().count;
+}
+
+void geOverlayBatch::Submit(geRenderQueue& queue, const eRenderLayer layer) const
+{//Una sola llamada de dibujo por lista
+	for( SIZE_T i=0; i<m_strips.size(); ++i )
+	{
+		const Strip& strip = m_strips[i];
+		if( strip.bPoints )
+		{
+			queue.AddPoints(layer, &m_points[strip.first], strip.count, strip.color);
+		}
+		else
+		{
+			queue.AddLines(layer, &m_points[strip.first], strip.count, strip.color);
+		}
+	}
+}
@@ -0,0 +1,91 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geOverlayBatch.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geOverlayBatch
+				Líneas y puntos de depuración (grid, rutas, marcas de
+				los walkers) ya convertidos a coordenadas de pantalla.
+				Se generan una sola vez y se reenvían cada cuadro como
+				pocas listas de SDL_RenderDrawLines/DrawPoints; solo se
+				regeneran cuando cambia la llave (cámara, área de
+				impresión, versión del mapa o del contenido)
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Declaración de estructuras                                           												*/
+/************************************************************************************************************************/
+//Datos de los que depende la posición en pantalla del contenido
+struct geOverlayKey
+{
+	int32 cameraX, cameraY;				//Desfase de pantalla de la cámara
+	int32 viewX0, viewY0, viewX1, viewY1;	//Área de impresión del mapa
+	int32 mapWidth, mapHeight;			//Tamaño del mapa (el terreno no cambia la posición de las líneas)
+	uint32 contentVersion;				//Versión del contenido (la define quien genera las líneas)
+
+	geOverlayKey() : cameraX(0), cameraY(0), viewX0(0), viewY0(0), viewX1(0), viewY1(0), mapWidth(0), mapHeight(0), contentVersion(0) {}
+
+	bool operator==(const geOverlayKey& rhs) const
+	{
+		return cameraX == rhs.cameraX && cameraY == rhs.cameraY &&
+			viewX0 == rhs.viewX0 && viewY0 == rhs.viewY0 && viewX1 == rhs.viewX1 && viewY1 == rhs.viewY1 &&
+			mapWidth == rhs.mapWidth && mapHeight == rhs.mapHeight && contentVersion == rhs.contentVersion;
+	}
+	bool operator!=(const geOverlayKey& rhs) const { return !(*this == rhs); }
+};
+
+/************************************************************************************************************************/
+/* Declaración de la clase geOverlayBatch                               												*/
+/************************************************************************************************************************/
+class geOverlayBatch
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geOverlayBatch(void);						//Constructor standard
+	~geOverlayBatch(void);						//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de control del cache                                       												*/
+	/************************************************************************************************************************/
+public:
+	bool isValid(const geOverlayKey& key) const { return m_bValid && m_key == key; }	//Indica si el contenido generado corresponde a la llave
+	void Begin(const geOverlayKey& key);		//Vacía el contenido para generarlo con una nueva llave
+	void Invalidate() { m_bValid = false; }		//Obliga a regenerar el contenido la siguiente vez
+
+	/************************************************************************************************************************/
+	/* Funciones para agregar contenido (en coordenadas de pantalla)        												*/
+	/************************************************************************************************************************/
+public:
+	void AddLine(const int32 x0, const int32 y0, const int32 x1, const int32 y1, const SDL_Color& color);	//Se une a la línea anterior si empieza donde esta terminó y es del mismo color
+	void AddLines(const SDL_Point* pPoints, const int32 numPoints, const SDL_Color& color);				//Línea continua entre los puntos
+	void AddPoint(const int32 x, const int32 y, const SDL_Color& color);									//Se une a la lista de puntos anterior si es del mismo color
+	void EndStrip() { m_bStripOpen = false; }	//La siguiente línea empieza una lista nueva aunque pudiera unirse a la anterior
+
+	void Submit(geRenderQueue& queue, const eRenderLayer layer) const;	//Agrega las listas a la cola de dibujo
+
+	int32 getNumStrips() const { return (int32)m_strips.size(); }
+	int32 getNumPoints() const { return (int32)m_points.size(); }
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	struct Strip
+	{
+		int32 first;					//Primer punto de la lista
+		int32 count;					//Número de puntos
+		SDL_Color color;				//Color de la lista
+		bool bPoints;					//Puntos sueltos en lugar de una línea continua
+	};
+
+	bool SameColor(const Strip& strip, const SDL_Color& color) const { return strip.color.r == color.r && strip.color.g == color.g && strip.color.b == color.b && strip.color.a == color.a; }
+
+	geOverlayKey m_key;							//Llave con la que se generó el contenido
+	bool m_bValid;								//Indica si hay contenido generado
+	bool m_bStripOpen;							//La última lista puede seguir creciendo
+	std::vector<Strip> m_strips;				//Listas de líneas o puntos
+	std::vector<SDL_Point> m_points;			//Puntos de todas las listas
+};
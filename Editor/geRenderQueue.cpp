@@ -0,0 +1,328 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geRenderQueue.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geRenderQueue
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geRenderQueue.h"
+
+/************************************************************************************************************************/
+/* Funciones de ayuda                                                   												*/
+/************************************************************************************************************************/
+static bool CompareRenderCommands(const geRenderCommand& lhs, const geRenderCommand& rhs) { return lhs.sortKey < rhs.sortKey; }
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geRenderQueue::geRenderQueue(void)
+{//Constructor standard
+	m_currentClip = -1;
+	m_numTextureSwitches = 0;
+	m_numDrawCalls = 0;
+
+	//Por default solo el terreno puede agruparse por textura (los tiles no se enciman)
+	for( int32 i=0; i<RL_NUM_LAYERS; ++i )
+	{
+		m_bSortByTexture[i] = (i == RL_TERRAIN);
+	}
+}
+
+geRenderQueue::~geRenderQueue(void)
+{//Destructor
+}
+
+void geRenderQueue::Clear()
+{//Vacía la lista para un nuevo cuadro (conservamos la memoria alojada)
+	m_commands.clear();
+	m_quads.clear();
+	m_points.clear();
+	m_clipRects.clear();
+	m_textureIds.clear();
+	m_currentClip = -1;
+	m_numTextureSwitches = 0;
+}
+
+void geRenderQueue::setClipRect(const SDL_Rect* pClip)
+{//Recorte de los siguientes comandos
+	if( pClip == NULL )
+	{
+		m_currentClip = -1;
+		return;
+	}
+
+	m_currentClip = (int16)m_clipRects.size();
+	m_clipRects.push_back(*pClip);
+}
+
+void geRenderQueue::AddCopy(const eRenderLayer layer, SDL_Texture* pTexture, const SDL_Rect* pSrc, const SDL_Rect& dst)
+{//Agrega una copia de textura
+	geRenderCommand command;
+	command.type = RCT_COPY;
+	command.layer = (uint8)layer;
+	command.clipIndex = m_currentClip;
+	command.pTexture = pTexture;
+	command.dst = dst;
+	if( pSrc != NULL )
+	{
+		command.src = *pSrc;
+	}
+	else
+	{//Toda la textura
+		command.src.x = command.src.y = 0;
+		command.src.w = command.src.h = -1;
+	}
+
+	//La llave es capa (8 bits), textura (24 bits) y orden de llegada (32 bits), así el orden es estable
+	uint64 textureId = 0;
+	if( m_bSortByTexture[layer] )
+	{
+		std::vector<SDL_Texture*>::iterator it = std::find(m_textureIds.begin(), m_textureIds.end(), pTexture);
+		if( it == m_textureIds.end() )
+		{
+			it = m_textureIds.insert(m_textureIds.end(), pTexture);
+		}
+		textureId = (uint64)(it - m_textureIds.begin()) + 1;
+	}
+	command.sortKey = ((uint64)layer << 56) | (textureId << 32) | (uint64)m_commands.size();
+
+	m_commands.push_back(command);
+}
+
+void geRenderQueue::AddLine(const eRenderLayer layer, const int32 x0, const int32 y0, const int32 x1, const int32 y1, const SDL_Color& color)
+{//Agrega una línea
+	geRenderCommand command;
+	command.type = RCT_LINE;
+	command.layer = (uint8)layer;
+	command.clipIndex = m_currentClip;
+	command.pTexture = NULL;
+	command.dst.x = x0;
+	command.dst.y = y0;
+	command.dst.w = x1;
+	command.dst.h = y1;
+	command.color = color;
+	command.sortKey = ((uint64)layer << 56) | (uint64)m_commands.size();
+
+	m_commands.push_back(command);
+}
+
+void geRenderQueue::AddLines(const eRenderLayer layer, const SDL_Point* pPoints, const int32 numPoints, const SDL_Color& color)
+{//Agrega una línea continua
+	if( numPoints >= 2 )
+	{
+		AddPointList(RCT_LINES, layer, pPoints, numPoints, color);
+	}
+}
+
+void geRenderQueue::AddPoints(const eRenderLayer layer, const SDL_Point* pPoints, const int32 numPoints, const SDL_Color& color)
+{//Agrega una lista de puntos
+	if( numPoints >= 1 )
+	{
+		AddPointList(RCT_POINTS, layer, pPoints, numPoints, color);
+	}
+}
+
+void geRenderQueue::AddPointList(const eRenderCommandType type, const eRenderLayer layer, const SDL_Point* pPoints, const int32 numPoints, const SDL_Color& color)
+{//Los puntos se copian a la lista del cuadro, así el que los generó puede reutilizar su memoria
+	GEE_ASSERT(pPoints);
+
+	geRenderCommand command;
+	command.type = (uint8)type;
+	command.layer = (uint8)layer;
+	command.clipIndex = m_currentClip;
+	command.pTexture = NULL;
+	command.src.x = (int32)m_points.size();
+	command.src.y = command.src.h = 0;
+	command.src.w = numPoints;
+	command.color = color;
+	command.sortKey = ((uint64)layer << 56) | (uint64)m_commands.size();
+
+	m_points.insert(m_points.end(), pPoints, pPoints+numPoints);
+	m_commands.push_back(command);
+}
+
+void geRenderQueue::AddRect(const eRenderLayer layer, const SDL_Rect& rect, const SDL_Color& color, const bool bFill)
+{//Agrega un rectángulo
+	geRenderCommand command;
+	command.type = (uint8)(bFill ? RCT_FILL_RECT : RCT_RECT);
+	command.layer = (uint8)layer;
+	command.clipIndex = m_currentClip;
+	command.pTexture = NULL;
+	command.dst = rect;
+	command.color = color;
+	command.sortKey = ((uint64)layer << 56) | (uint64)m_commands.size();
+
+	m_commands.push_back(command);
+}
+
+void geRenderQueue::AddQuad(const eRenderLayer layer, SDL_Texture* pTexture, const SDL_Rect& src, const SDL_Rect& dst)
+{//Agrega una copia al lote abierto o abre uno nuevo
+	geRenderQuad quad;
+	quad.src = src;
+	quad.dst = dst;
+
+	//Solo podemos unirnos al último comando, así el orden de dibujo no cambia
+	if( !m_commands.empty() )
+	{
+		geRenderCommand& last = m_commands.back();
+		if( last.type == RCT_QUADS && last.layer == layer && last.pTexture == pTexture && last.clipIndex == m_currentClip )
+		{
+			m_quads.push_back(quad);
+			++last.src.w;
+			return;
+		}
+	}
+
+	//Abrimos un lote nuevo (la llave se calcula igual que en AddCopy)
+	SDL_Rect dummy = { 0, 0, 0, 0 };
+	AddCopy(layer, pTexture, NULL, dummy);
+	geRenderCommand& command = m_commands.back();
+	command.type = RCT_QUADS;
+	command.src.x = (int32)m_quads.size();
+	command.src.w = 1;
+	m_quads.push_back(quad);
+}
+
+void geRenderQueue::Sort()
+{//Ordena los comandos por su llave
+	std::sort(m_commands.begin(), m_commands.end(), CompareRenderCommands);
+
+	//Contamos los cambios de textura que tendrá el envío
+	m_numTextureSwitches = 0;
+	SDL_Texture* pLastTexture = NULL;
+	for( SIZE_T i=0; i<m_commands.size(); ++i )
+	{
+		if( (m_commands[i].type == RCT_COPY || m_commands[i].type == RCT_QUADS) && m_commands[i].pTexture != pLastTexture )
+		{
+			pLastTexture = m_commands[i].pTexture;
+			++m_numTextureSwitches;
+		}
+	}
+}
+
+void geRenderQueue::Submit(SDL_Renderer* pRenderer)
+{//Envía los comandos a SDL en el orden actual
+	GEE_ASSERT(pRenderer);
+
+	int32 currentClip = -1;
+	uint32 currentColor = 0;
+	bool bColorSet = false;
+	m_numDrawCalls = 0;
+
+	for( SIZE_T i=0; i<m_commands.size(); ++i )
+	{
+		const geRenderCommand& command = m_commands[i];
+
+		//Cambiamos el recorte solo si es diferente al anterior
+		if( command.clipIndex != currentClip )
+		{
+			currentClip = command.clipIndex;
+			SDL_RenderSetClipRect(pRenderer, (currentClip >= 0) ? &m_clipRects[currentClip] : NULL);
+		}
+
+		if( command.type == RCT_COPY )
+		{
+			SDL_RenderCopy(pRenderer, command.pTexture, (command.src.w >= 0) ? &command.src : NULL, &command.dst);
+			++m_numDrawCalls;
+			continue;
+		}
+
+		if( command.type == RCT_QUADS )
+		{
+			SubmitQuads(pRenderer, command);
+			continue;
+		}
+
+		//Cambiamos el color solo si es diferente al anterior
+		uint32 color = ((uint32)command.color.r << 24) | ((uint32)command.color.g << 16) | ((uint32)command.color.b << 8) | command.color.a;
+		if( !bColorSet || color != currentColor )
+		{
+			SDL_SetRenderDrawColor(pRenderer, command.color.r, command.color.g, command.color.b, command.color.a);
+			currentColor = color;
+			bColorSet = true;
+		}
+
+		++m_numDrawCalls;
+		switch( command.type )
+		{
+		case RCT_LINE:
+			SDL_RenderDrawLine(pRenderer, command.dst.x, command.dst.y, command.dst.w, command.dst.h);
+			break;
+		case RCT_RECT:
+			SDL_RenderDrawRect(pRenderer, &command.dst);
+			break;
+		case RCT_FILL_RECT:
+			SDL_RenderFillRect(pRenderer, &command.dst);
+			break;
+		case RCT_LINES:
+			SDL_RenderDrawLines(pRenderer, &m_points[command.src.x], command.src.w);
+			break;
+		case RCT_POINTS:
+			SDL_RenderDrawPoints(pRenderer, &m_points[command.src.x], command.src.w);
+			break;
+		}
+	}
+
+	if( currentClip >= 0 )
+	{//Dejamos el renderer sin recorte
+		SDL_RenderSetClipRect(pRenderer, NULL);
+	}
+}
+
+void geRenderQueue::SubmitQuads(SDL_Renderer* pRenderer, const geRenderCommand& command)
+{//Envía un lote de copias de la misma textura
+	const geRenderQuad* pQuads = &m_quads[command.src.x];
+	int32 numQuads = command.src.w;
+
+#if SDL_VERSION_ATLEAST(2,0,18)
+	//Todo el lote se envía como una sola geometría de dos triángulos por copia
+	int32 texWidth = 0, texHeight = 0;
+	if( SDL_QueryTexture(command.pTexture, NULL, NULL, &texWidth, &texHeight) == 0 && texWidth > 0 && texHeight > 0 )
+	{
+		float invWidth = 1.0f / (float)texWidth;
+		float invHeight = 1.0f / (float)texHeight;
+		SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+		m_vertices.resize(numQuads*4);
+		m_indices.resize(numQuads*6);
+		for( int32 i=0; i<numQuads; ++i )
+		{
+			const geRenderQuad& quad = pQuads[i];
+			float u0 = (float)quad.src.x * invWidth, u1 = (float)(quad.src.x + quad.src.w) * invWidth;
+			float v0 = (float)quad.src.y * invHeight, v1 = (float)(quad.src.y + quad.src.h) * invHeight;
+			float x0 = (float)quad.dst.x, x1 = (float)(quad.dst.x + quad.dst.w);
+			float y0 = (float)quad.dst.y, y1 = (float)(quad.dst.y + quad.dst.h);
+
+			SDL_Vertex* pVertex = &m_vertices[i*4];
+			pVertex[0].position.x = x0;	pVertex[0].position.y = y0;	pVertex[0].tex_coord.x = u0;	pVertex[0].tex_coord.y = v0;
+			pVertex[1].position.x = x1;	pVertex[1].position.y = y0;	pVertex[1].tex_coord.x = u1;	pVertex[1].tex_coord.y = v0;
+			pVertex[2].position.x = x1;	pVertex[2].position.y = y1;	pVertex[2].tex_coord.x = u1;	pVertex[2].tex_coord.y = v1;
+			pVertex[3].position.x = x0;	pVertex[3].position.y = y1;	pVertex[3].tex_coord.x = u0;	pVertex[3].tex_coord.y = v1;
+			pVertex[0].color = pVertex[1].color = pVertex[2].color = pVertex[3].color = white;
+
+			int32* pIndex = &m_indices[i*6];
+			int32 base = i*4;
+			pIndex[0] = base;	pIndex[1] = base+1;	pIndex[2] = base+2;
+			pIndex[3] = base;	pIndex[4] = base+2;	pIndex[5] = base+3;
+		}
+
+		if( SDL_RenderGeometry(pRenderer, command.pTexture, &m_vertices[0], numQuads*4, &m_indices[0], numQuads*6) == 0 )
+		{
+			++m_numDrawCalls;
+			return;
+		}
+	}
+#endif
+
+	//Sin geometría (SDL anterior a 2.0.18 o el renderer la rechazó) enviamos cada copia por separado, la textura sigue siendo la misma
+	for( int32 i=0; i<numQuads; ++i )
+	{
+		SDL_RenderCopy(pRenderer, command.pTexture, &pQuads[i].src, &pQuads[i].dst);
+	}
+	m_numDrawCalls += numQuads;
+}
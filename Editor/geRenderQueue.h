@@ -0,0 +1,131 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geRenderQueue.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geRenderQueue
+				Lista de comandos de dibujo (copias de textura, líneas
+				y rectángulos) que los sistemas llenan en lugar de
+				llamar a SDL directamente. La lista se ordena por capa
+				y textura y se envía a SDL en una sola pasada. Generar
+				los comandos no requiere un renderer, así que puede
+				medirse y probarse sin pantalla
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+//Capas de dibujo (se imprimen en este orden)
+enum eRenderLayer
+{
+	RL_TERRAIN = 0,		//Terreno del mapa
+	RL_MAP_OVERLAY,		//Grid y marcas sobre el terreno
+	RL_UNITS,			//Unidades y objetos del mundo
+	RL_DEBUG,			//Información de depuración
+	RL_GUI,				//Interface gráfica
+	RL_NUM_LAYERS
+};
+
+//Tipos de comando
+enum eRenderCommandType
+{
+	RCT_COPY = 0,		//Copia de una región de textura a pantalla
+	RCT_LINE,			//Línea de un color
+	RCT_RECT,			//Perímetro de un rectángulo
+	RCT_FILL_RECT,		//Rectángulo relleno
+	RCT_QUADS,			//Lote de copias de una misma textura (se envía como una sola geometría cuando SDL lo permite)
+	RCT_LINES,			//Línea continua entre varios puntos (una sola llamada a SDL_RenderDrawLines)
+	RCT_POINTS			//Lista de puntos de un color (una sola llamada a SDL_RenderDrawPoints)
+};
+
+//Copia individual dentro de un lote RCT_QUADS
+struct geRenderQuad
+{
+	SDL_Rect src;				//Región de la textura
+	SDL_Rect dst;				//Región destino
+};
+
+//Comando de dibujo
+struct geRenderCommand
+{
+	uint64 sortKey;				//Llave de orden (capa, textura y orden de llegada), se calcula al agregar el comando y Sort() solo ordena por ella
+	uint8 type;					//eRenderCommandType
+	uint8 layer;				//eRenderLayer
+	int16 clipIndex;			//Índice del rectángulo de recorte en la lista de recortes (-1 sin recorte)
+	SDL_Texture *pTexture;		//Textura de origen (solo RCT_COPY)
+	SDL_Rect src;				//Región de la textura (solo RCT_COPY, en RCT_QUADS x es el primer quad y w el número de quads, en RCT_LINES y RCT_POINTS x es el primer punto y w el número de puntos)
+	SDL_Rect dst;				//Región destino (en RCT_LINE x,y es el inicio y w,h el final)
+	SDL_Color color;			//Color (líneas y rectángulos)
+};
+
+/************************************************************************************************************************/
+/* Declaración de la clase geRenderQueue                                												*/
+/************************************************************************************************************************/
+class geRenderQueue : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geRenderQueue(void);						//Constructor standard
+	~geRenderQueue(void);						//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de control de la lista                                     												*/
+	/************************************************************************************************************************/
+public:
+	void Clear();								//Vacía la lista para un nuevo cuadro
+	void Sort();								//Ordena los comandos por capa y, en las capas que lo permiten, por textura
+	void Submit(SDL_Renderer* pRenderer);		//Envía los comandos ordenados a SDL (cambia el color y el recorte solo cuando es necesario)
+
+	void setLayerSortByTexture(const eRenderLayer layer, const bool bSort) { m_bSortByTexture[layer] = bSort; }	//Las capas cuyo contenido no se encima pueden agruparse por textura
+
+	void setClipRect(const SDL_Rect* pClip);	//Recorte que se aplica a los comandos que se agreguen despues (NULL para quitarlo)
+
+	/************************************************************************************************************************/
+	/* Funciones para agregar comandos                                      												*/
+	/************************************************************************************************************************/
+public:
+	void AddCopy(const eRenderLayer layer, SDL_Texture* pTexture, const SDL_Rect* pSrc, const SDL_Rect& dst);
+	void AddLine(const eRenderLayer layer, const int32 x0, const int32 y0, const int32 x1, const int32 y1, const SDL_Color& color);
+	void AddLines(const eRenderLayer layer, const SDL_Point* pPoints, const int32 numPoints, const SDL_Color& color);	//Línea continua entre los puntos (un solo comando)
+	void AddPoints(const eRenderLayer layer, const SDL_Point* pPoints, const int32 numPoints, const SDL_Color& color);	//Puntos sueltos de un color (un solo comando)
+	void AddRect(const eRenderLayer layer, const SDL_Rect& rect, const SDL_Color& color, const bool bFill = false);
+	void AddQuad(const eRenderLayer layer, SDL_Texture* pTexture, const SDL_Rect& src, const SDL_Rect& dst);	//Copia que se une al lote anterior si usa la misma textura, capa y recorte
+
+	/************************************************************************************************************************/
+	/* Funciones de consulta y estadísticas                                 												*/
+	/************************************************************************************************************************/
+public:
+	int32 getNumCommands() const { return (int32)m_commands.size(); }
+	const geRenderCommand& getCommand(const int32 index) const { return m_commands[index]; }
+	int32 getNumTextureSwitches() const { return m_numTextureSwitches; }	//Número de cambios de textura en la lista ordenada (se calcula en Sort())
+	int32 getNumQuads() const { return (int32)m_quads.size(); }
+	int32 getNumDrawCalls() const { return m_numDrawCalls; }	//Llamadas de dibujo a SDL en el último Submit()
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	void SubmitQuads(SDL_Renderer* pRenderer, const geRenderCommand& command);	//Envía un lote RCT_QUADS como geometría o como copias individuales
+	void AddPointList(const eRenderCommandType type, const eRenderLayer layer, const SDL_Point* pPoints, const int32 numPoints, const SDL_Color& color);	//Copia los puntos y agrega el comando que los usa
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	std::vector<geRenderCommand> m_commands;	//Comandos del cuadro actual
+	std::vector<geRenderQuad> m_quads;			//Copias de los lotes RCT_QUADS
+	std::vector<SDL_Point> m_points;			//Puntos de los comandos RCT_LINES y RCT_POINTS
+	std::vector<SDL_Rect> m_clipRects;			//Rectángulos de recorte usados en el cuadro actual
+	std::vector<SDL_Texture*> m_textureIds;		//Texturas vistas en el cuadro actual (su índice se usa en la llave de orden)
+	int16 m_currentClip;						//Recorte de los siguientes comandos
+	bool m_bSortByTexture[RL_NUM_LAYERS];		//Indica por capa si pueden agruparse los comandos por textura
+	int32 m_numTextureSwitches;					//Cambios de textura en la lista ordenada
+	int32 m_numDrawCalls;						//Llamadas de dibujo del último envío
+#if SDL_VERSION_ATLEAST(2,0,18)
+	std::vector<SDL_Vertex> m_vertices;			//Vértices de un lote RCT_QUADS al enviarlo como geometría
+	std::vector<int32> m_indices;				//Índices de un lote RCT_QUADS
+#endif
+};
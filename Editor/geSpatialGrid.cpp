@@ -0,0 +1,347 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geSpatialGrid.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geSpatialGrid
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geSpatialGrid.h"
+
+/************************************************************************************************************************/
+/* Pruebas de las consultas                                             												*/
+/************************************************************************************************************************/
+struct geSpatialRadiusTest
+{
+	float x, y, radiusSq;
+	FORCEINLINE bool operator()(const float ex, const float ey) const { return ((ex-x)*(ex-x))+((ey-y)*(ey-y)) <= radiusSq; }
+};
+
+struct geSpatialRectTest
+{
+	float minX, minY, maxX, maxY;
+	FORCEINLINE bool operator()(const float ex, const float ey) const { return ex >= minX && ex <= maxX && ey >= minY && ey <= maxY; }
+};
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geSpatialGrid::geSpatialGrid(void)
+{//Constructor standard
+	m_pMap = NULL;
+	m_mode = GM_LINKED;
+	m_cellsX = m_cellsY = 0;
+	m_firstFree = SPATIAL_INVALID_INDEX;
+	m_numEntities = 0;
+	m_bSortedDirty = false;
+}
+
+geSpatialGrid::~geSpatialGrid(void)
+{//Destructor
+	Destroy();
+}
+
+bool geSpatialGrid::Init(geTiledMap* pMap, const GRIDMODETYPE mode)
+{//Crea las celdas alineadas a los chunks del mapa
+	GEE_ASSERT(pMap);
+	Destroy();
+
+	m_pMap = pMap;
+	m_mode = mode;
+	m_cellsX = Max(pMap->getNumChunksX(), 1);
+	m_cellsY = Max(pMap->getNumChunksY(), 1);
+	m_cellHead.assign(m_cellsX*m_cellsY, SPATIAL_INVALID_INDEX);
+	m_cellStart.assign((m_cellsX*m_cellsY)+1, 0);
+
+	return true;
+}
+
+void geSpatialGrid::Destroy()
+{//Elimina todas las entidades y celdas
+	m_entities.clear();
+	m_cellHead.clear();
+	m_cellStart.clear();
+	m_sorted.clear();
+	m_firstFree = SPATIAL_INVALID_INDEX;
+	m_numEntities = 0;
+	m_cellsX = m_cellsY = 0;
+	m_bSortedDirty = false;
+	m_pMap = NULL;
+}
+
+void geSpatialGrid::Update()
+{//Ajusta las celdas al mapa y reconstruye el orden si es necesario
+	if( m_pMap == NULL )
+	{
+		return;
+	}
+
+	if( Max(m_pMap->getNumChunksX(), 1) != m_cellsX || Max(m_pMap->getNumChunksY(), 1) != m_cellsY )
+	{//El mapa cambió de tamaño, redistribuimos las entidades en las celdas nuevas
+		m_cellsX = Max(m_pMap->getNumChunksX(), 1);
+		m_cellsY = Max(m_pMap->getNumChunksY(), 1);
+		m_cellHead.assign(m_cellsX*m_cellsY, SPATIAL_INVALID_INDEX);
+		m_cellStart.assign((m_cellsX*m_cellsY)+1, 0);
+		RelinkAll();
+	}
+
+	if( m_mode == GM_SORTED && m_bSortedDirty )
+	{
+		Rebuild();
+	}
+}
+
+void geSpatialGrid::setMode(const GRIDMODETYPE mode)
+{//Cambia el modo de actualización
+	if( mode == m_mode )
+	{
+		return;
+	}
+
+	m_mode = mode;
+	RelinkAll();
+}
+
+int32 geSpatialGrid::Insert(const float x, const float y, const uint32 userData)
+{//Agrega una entidad
+	GEE_ASSERT(m_pMap);
+
+	int32 entity;
+	if( m_firstFree != SPATIAL_INVALID_INDEX )
+	{//Reutilizamos un espacio libre
+		entity = m_firstFree;
+		m_firstFree = m_entities[entity].next;
+	}
+	else
+	{
+		entity = (int32)m_entities.size();
+		m_entities.push_back( Entity() );
+	}
+
+	Entity& e = m_entities[entity];
+	e.x = x;
+	e.y = y;
+	e.userData = userData;
+	e.cell = getCell(x, y);
+	e.prev = e.next = SPATIAL_INVALID_INDEX;
+	++m_numEntities;
+
+	if( m_mode == GM_LINKED )
+	{
+		Link(entity, e.cell);
+	}
+	m_bSortedDirty = true;
+
+	return entity;
+}
+
+void geSpatialGrid::Remove(const int32 entity)
+{//Elimina una entidad
+	GEE_ASSERT( entity >= 0 && entity < (int32)m_entities.size() && m_entities[entity].cell != SPATIAL_INVALID_INDEX );
+
+	if( m_mode == GM_LINKED )
+	{
+		Unlink(entity);
+	}
+
+	//Agregamos el espacio a la lista de libres
+	Entity& e = m_entities[entity];
+	e.cell = SPATIAL_INVALID_INDEX;
+	e.next = m_firstFree;
+	m_firstFree = entity;
+	--m_numEntities;
+	m_bSortedDirty = true;
+}
+
+void geSpatialGrid::Move(const int32 entity, const float x, const float y)
+{//Cambia la posición de una entidad
+	GEE_ASSERT( entity >= 0 && entity < (int32)m_entities.size() && m_entities[entity].cell != SPATIAL_INVALID_INDEX );
+
+	Entity& e = m_entities[entity];
+	e.x = x;
+	e.y = y;
+
+	int32 newCell = getCell(x, y);
+	if( m_mode == GM_SORTED )
+	{//Solo guardamos la posición, el orden se reconstruye en Update()
+		e.cell = newCell;
+		m_bSortedDirty = true;
+	}
+	else if( newCell != e.cell )
+	{//Solo reenlazamos si cambió de celda
+		Unlink(entity);
+		Link(entity, newCell);
+	}
+}
+
+void geSpatialGrid::Link(const int32 entity, const int32 cell)
+{//Agrega una entidad al inicio de la lista de una celda
+	Entity& e = m_entities[entity];
+	e.cell = cell;
+	e.prev = SPATIAL_INVALID_INDEX;
+	e.next = m_cellHead[cell];
+	if( e.next != SPATIAL_INVALID_INDEX )
+	{
+		m_entities[e.next].prev = entity;
+	}
+	m_cellHead[cell] = entity;
+}
+
+void geSpatialGrid::Unlink(const int32 entity)
+{//Quita una entidad de la lista de su celda
+	Entity& e = m_entities[entity];
+	if( e.prev != SPATIAL_INVALID_INDEX )
+	{
+		m_entities[e.prev].next = e.next;
+	}
+	else
+	{
+		m_cellHead[e.cell] = e.next;
+	}
+
+	if( e.next != SPATIAL_INVALID_INDEX )
+	{
+		m_entities[e.next].prev = e.prev;
+	}
+	e.prev = e.next = SPATIAL_INVALID_INDEX;
+}
+
+void geSpatialGrid::RelinkAll()
+{//Vuelve a calcular la celda de todas las entidades
+	std::fill(m_cellHead.begin(), m_cellHead.end(), SPATIAL_INVALID_INDEX);
+	for( int32 i=0; i<(int32)m_entities.size(); ++i )
+	{
+		Entity& e = m_entities[i];
+		if( e.cell == SPATIAL_INVALID_INDEX )
+		{//Espacio libre
+			continue;
+		}
+
+		e.cell = getCell(e.x, e.y);
+		if( m_mode == GM_LINKED )
+		{
+			Link(i, e.cell);
+		}
+	}
+
+	m_bSortedDirty = true;
+	if( m_mode == GM_SORTED )
+	{
+		Rebuild();
+	}
+}
+
+void geSpatialGrid::Rebuild()
+{//Ordena todas las entidades por celda con un counting sort
+	int32 numCells = m_cellsX*m_cellsY;
+	std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+
+	//Contamos las entidades de cada celda
+	for( SIZE_T i=0; i<m_entities.size(); ++i )
+	{
+		if( m_entities[i].cell != SPATIAL_INVALID_INDEX )
+		{
+			++m_cellStart[m_entities[i].cell+1];
+		}
+	}
+
+	//Convertimos los conteos en posiciones iniciales
+	for( int32 cell=0; cell<numCells; ++cell )
+	{
+		m_cellStart[cell+1] += m_cellStart[cell];
+	}
+
+	//Colocamos cada entidad en su lugar (usamos m_cellHead como cursor de escritura temporal)
+	m_sorted.resize(m_numEntities);
+	m_cellHead.assign(m_cellStart.begin(), m_cellStart.end()-1);
+	for( int32 i=0; i<(int32)m_entities.size(); ++i )
+	{
+		const Entity& e = m_entities[i];
+		if( e.cell != SPATIAL_INVALID_INDEX )
+		{
+			SortedEntry& entry = m_sorted[m_cellHead[e.cell]++];
+			entry.x = e.x;
+			entry.y = e.y;
+			entry.entity = i;
+		}
+	}
+
+	m_bSortedDirty = false;
+}
+
+template<class TEST>
+int32 geSpatialGrid::Query(const float minX, const float minY, const float maxX, const float maxY, const TEST& test, int32* pResults, const int32 maxResults)
+{//Recorre las celdas que toca el rectángulo y escribe las entidades que pasan la prueba
+	if( m_pMap == NULL )
+	{
+		return 0;
+	}
+
+	if( m_mode == GM_SORTED && m_bSortedDirty )
+	{//Hubo cambios desde la última reconstrucción
+		Rebuild();
+	}
+
+	int32 iniCell = getCell(minX, minY);
+	int32 finCell = getCell(maxX, maxY);
+	int32 iniCX = iniCell % m_cellsX, iniCY = iniCell / m_cellsX;
+	int32 finCX = finCell % m_cellsX, finCY = finCell / m_cellsX;
+
+	int32 numFound = 0;
+	for( int32 cy=iniCY; cy<=finCY; ++cy )
+	{
+		for( int32 cx=iniCX; cx<=finCX; ++cx )
+		{
+			int32 cell = (cy*m_cellsX)+cx;
+			if( m_mode == GM_SORTED )
+			{//Las entidades de la celda están contiguas
+				for( int32 i=m_cellStart[cell]; i<m_cellStart[cell+1]; ++i )
+				{
+					const SortedEntry& entry = m_sorted[i];
+					if( test(entry.x, entry.y) )
+					{
+						if( numFound < maxResults ) pResults[numFound] = entry.entity;
+						++numFound;
+					}
+				}
+			}
+			else
+			{
+				for( int32 i=m_cellHead[cell]; i!=SPATIAL_INVALID_INDEX; i=m_entities[i].next )
+				{
+					const Entity& e = m_entities[i];
+					if( test(e.x, e.y) )
+					{
+						if( numFound < maxResults ) pResults[numFound] = i;
+						++numFound;
+					}
+				}
+			}
+		}
+	}
+
+	return numFound;
+}
+
+int32 geSpatialGrid::QueryRadius(const float x, const float y, const float radius, int32* pResults, const int32 maxResults)
+{//Busca las entidades dentro del círculo
+	geSpatialRadiusTest test;
+	test.x = x;
+	test.y = y;
+	test.radiusSq = radius*radius;
+	return Query(x-radius, y-radius, x+radius, y+radius, test, pResults, maxResults);
+}
+
+int32 geSpatialGrid::QueryRect(const float minX, const float minY, const float maxX, const float maxY, int32* pResults, const int32 maxResults)
+{//Busca las entidades dentro del rectángulo (inclusivo)
+	geSpatialRectTest test;
+	test.minX = minX;
+	test.minY = minY;
+	test.maxX = maxX;
+	test.maxY = maxY;
+	return Query(minX, minY, maxX, maxY, test, pResults, maxResults);
+}
@@ -0,0 +1,126 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geSpatialGrid.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geSpatialGrid
+				Índice espacial de entidades sobre un geTiledMap con
+				una celda por chunk del mapa. Soporta dos modos: listas
+				enlazadas por índice (mover una entidad es O(1)) y
+				reconstrucción ordenada por celda una vez por ciclo
+				(para cuando casi todas las entidades se mueven)
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geTiledMap.h"
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define SPATIAL_INVALID_INDEX -1		//Índice inválido de entidad o de celda
+
+/************************************************************************************************************************/
+/* Declaración de la clase geSpatialGrid                                												*/
+/************************************************************************************************************************/
+class geSpatialGrid : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Tipo definido enumerador para los modos de actualización												*/
+	/************************************************************************************************************************/
+public:
+	typedef enum GRIDMODE
+	{
+		GM_LINKED,		//Cada movimiento actualiza las listas de las celdas inmediatamente
+		GM_SORTED		//Los movimientos solo guardan la posición, Rebuild() ordena todas las entidades por celda
+	}GRIDMODETYPE;
+
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geSpatialGrid(void);						//Constructor standard
+	~geSpatialGrid(void);						//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de inicialización y actualización                          												*/
+	/************************************************************************************************************************/
+public:
+	bool Init(geTiledMap* pMap, const GRIDMODETYPE mode = GM_LINKED);	//Crea las celdas alineadas a los chunks del mapa
+	void Destroy();														//Elimina todas las entidades y celdas
+	void Update();														//Ajusta las celdas si el mapa cambió de tamaño y en modo GM_SORTED reconstruye el orden
+
+	void setMode(const GRIDMODETYPE mode);								//Cambia el modo de actualización
+	GRIDMODETYPE getMode() const { return m_mode; }
+
+	/************************************************************************************************************************/
+	/* Funciones de control de entidades (posiciones en tiles, con fracción)												*/
+	/************************************************************************************************************************/
+public:
+	int32 Insert(const float x, const float y, const uint32 userData);		//Agrega una entidad y regresa su identificador
+	void Remove(const int32 entity);										//Elimina una entidad
+	void Move(const int32 entity, const float x, const float y);			//Cambia la posición de una entidad
+
+	float getX(const int32 entity) const { return m_entities[entity].x; }
+	float getY(const int32 entity) const { return m_entities[entity].y; }
+	uint32 getUserData(const int32 entity) const { return m_entities[entity].userData; }
+	int32 getNumEntities() const { return m_numEntities; }
+
+	/************************************************************************************************************************/
+	/* Funciones de consulta (escriben los identificadores en el buffer del llamador y regresan cuántos encontraron)		*/
+	/* Si hay más resultados que maxResults, solo se escriben los primeros maxResults pero se regresa el total				*/
+	/************************************************************************************************************************/
+public:
+	int32 QueryRadius(const float x, const float y, const float radius, int32* pResults, const int32 maxResults);
+	int32 QueryRect(const float minX, const float minY, const float maxX, const float maxY, int32* pResults, const int32 maxResults);
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	struct Entity
+	{
+		float x, y;					//Posición en tiles
+		uint32 userData;			//Dato del usuario (ej. puntero o identificador de la unidad)
+		int32 cell;					//Celda en la que está enlazada (SPATIAL_INVALID_INDEX si el espacio está libre)
+		int32 prev, next;			//Enlaces de la lista de su celda (modo GM_LINKED) o de la lista de libres
+	};
+
+	struct SortedEntry
+	{//Copia compacta de una entidad para recorrer las celdas en modo GM_SORTED sin saltar por memoria
+		float x, y;
+		int32 entity;
+	};
+
+	FORCEINLINE int32 getCell(const float x, const float y) const
+	{//Celda que contiene la posición (las posiciones fuera del mapa se asignan a la celda del borde)
+		int32 cx = Clamp( Trunc(x) >> MAP_CHUNK_BITS, 0, m_cellsX-1 );
+		int32 cy = Clamp( Trunc(y) >> MAP_CHUNK_BITS, 0, m_cellsY-1 );
+		return (cy*m_cellsX)+cx;
+	}
+
+	void Link(const int32 entity, const int32 cell);	//Agrega una entidad a la lista de una celda
+	void Unlink(const int32 entity);					//Quita una entidad de la lista de su celda
+	void RelinkAll();									//Vuelve a calcular la celda de todas las entidades
+	void Rebuild();										//Ordena todas las entidades por celda (counting sort)
+	template<class TEST> int32 Query(const float minX, const float minY, const float maxX, const float maxY, const TEST& test, int32* pResults, const int32 maxResults);
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	geTiledMap *m_pMap;							//Mapa asociado
+	GRIDMODETYPE m_mode;						//Modo de actualización
+	int32 m_cellsX, m_cellsY;					//Número de celdas en cada eje (igual al número de chunks del mapa)
+
+	std::vector<Entity> m_entities;				//Entidades (los espacios libres se reutilizan)
+	int32 m_firstFree;							//Primer espacio libre
+	int32 m_numEntities;						//Número de entidades vivas
+
+	std::vector<int32> m_cellHead;				//Primera entidad de cada celda (modo GM_LINKED)
+	std::vector<int32> m_cellStart;				//Inicio de cada celda en m_sorted, con una entrada extra al final (modo GM_SORTED)
+	std::vector<SortedEntry> m_sorted;			//Entidades ordenadas por celda (modo GM_SORTED)
+	bool m_bSortedDirty;						//Indica que hubo cambios desde la última reconstrucción
+};
@@ -0,0 +1,246 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geSpriteBatch.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geSpriteBatch
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geSpriteBatch.h"
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geSpriteBatch::geSpriteBatch(void)
+{//Constructor standard
+	m_pMap = NULL;
+	m_firstRow = 0;
+	m_cullMargin = SPRITE_CULL_MARGIN_TILES;
+	m_numVisible = 0;
+	m_numPageSwitches = 0;
+}
+
+geSpriteBatch::~geSpriteBatch(void)
+{//Destructor
+	Destroy();
+}
+
+bool geSpriteBatch::Init(geTiledMap* pMap)
+{//Asocia el lote a un mapa
+	GEE_ASSERT(pMap);
+
+	Destroy();
+	m_pMap = pMap;
+	return true;
+}
+
+void geSpriteBatch::Destroy()
+{//Suelta las páginas (quedan en el cache de texturas)
+	m_pages.clear();
+	m_pageInfo.clear();
+	m_sprites.clear();
+	m_keys.clear();
+	m_sortTemp.clear();
+	m_pMap = NULL;
+}
+
+int32 geSpriteBatch::AddPage(const geTextureHandle& page)
+{//La página queda identificada por su índice (los sprites solo guardan el índice)
+	GEE_ASSERT(page.isValid());
+	if( m_pages.size() >= SPRITE_MAX_PAGES )
+	{
+		GEE_WARNING( TEXT("geSpriteBatch::AddPage: Se alcanzó el máximo de páginas de atlas") );
+		return -1;
+	}
+
+	m_pages.push_back(page);
+	return (int32)m_pages.size()-1;
+}
+
+void geSpriteBatch::AddSprite(const float mapX, const float mapY, const int32 page, const int32 region)
+{//Solo guardamos los datos, el descarte y el orden se hacen una vez en Submit()
+	GEE_ASSERT(page >= 0 && page < (int32)m_pages.size());
+
+	Sprite sprite;
+	sprite.mapX = mapX;
+	sprite.mapY = mapY;
+	sprite.page = page;
+	sprite.region = region;
+	m_sprites.push_back(sprite);
+}
+
+uint64 geSpriteBatch::MakeSortKey(const float depth, const int32 page, const uint32 sprite)
+{//Los bits altos mandan: primero la profundidad, a igual profundidad la página y al final el orden de llegada (así el orden nunca depende del algoritmo)
+	uint64 fixedDepth = (uint64)Clamp( Trunc(depth * (float)(1<<SPRITE_DEPTH_FRACTION_BITS)), 0, 0xFFFFFF );
+	return (fixedDepth << 40) | ((uint64)(page & 0xFF) << 32) | (uint64)sprite;
+}
+
+void geSpriteBatch::RadixSort(std::vector<uint64>& keys, std::vector<uint64>& temp)
+{//LSD por bytes, estable. Los histogramas de los 8 bytes se cuentan en una sola pasada y los bytes iguales en todas las llaves no cambian el orden
+	SIZE_T num = keys.size();
+	if( num < 2 )
+	{
+		return;
+	}
+
+	uint32 counts[8][256];
+	memset(counts, 0, sizeof(counts));
+	uint64 allOr = 0, allAnd = ~(uint64)0;
+	for( SIZE_T i=0; i<num; ++i )
+	{
+		uint64 key = keys[i];
+		allOr |= key;
+		allAnd &= key;
+		for( int32 iterByte=0; iterByte<8; ++iterByte )
+		{
+			++counts[iterByte][(key >> (iterByte<<3)) & 0xFF];
+		}
+	}
+	uint64 varyingBits = allOr ^ allAnd;
+
+	temp.resize(num);
+	for( int32 iterByte=0; iterByte<8; ++iterByte )
+	{
+		int32 shift = iterByte<<3;
+		if( ((varyingBits >> shift) & 0xFF) == 0 )
+		{
+			continue;
+		}
+
+		//Convertimos el histograma en la posición inicial de cada valor
+		uint32* pOffsets = counts[iterByte];
+		uint32 offset = 0;
+		for( int32 iterValue=0; iterValue<256; ++iterValue )
+		{
+			uint32 count = pOffsets[iterValue];
+			pOffsets[iterValue] = offset;
+			offset += count;
+		}
+
+		const uint64* pSrc = &keys[0];
+		uint64* pDst = &temp[0];
+		for( SIZE_T i=0; i<num; ++i )
+		{
+			pDst[pOffsets[(pSrc[i] >> shift) & 0xFF]++] = pSrc[i];
+		}
+		keys.swap(temp);
+	}
+}
+
+void geSpriteBatch::BuildVisibleRows()
+{//Cada rango visible acepta las columnas vecinas y las filas vecinas dentro del margen
+	m_rowMinX.clear();
+	m_rowMaxX.clear();
+	m_pMap->ComputeVisibleSpans(m_spans);
+	if( m_spans.empty() )
+	{
+		return;
+	}
+
+	int32 firstY = m_spans[0].y, lastY = m_spans[0].y;
+	for( SIZE_T i=1; i<m_spans.size(); ++i )
+	{
+		firstY = Min(firstY, m_spans[i].y);
+		lastY = Max(lastY, m_spans[i].y);
+	}
+
+	m_firstRow = firstY - m_cullMargin;
+	int32 numRows = (lastY - firstY + 1) + (m_cullMargin<<1);
+	m_rowMinX.assign(numRows, (int32)MAX_INT32);
+	m_rowMaxX.assign(numRows, (int32)MIN_INT32);
+	for( SIZE_T i=0; i<m_spans.size(); ++i )
+	{
+		const geMapRowSpan& span = m_spans[i];
+		for( int32 iterRow=span.y-m_cullMargin; iterRow<=span.y+m_cullMargin; ++iterRow )
+		{
+			int32 row = iterRow - m_firstRow;
+			m_rowMinX[row] = Min(m_rowMinX[row], span.iniX - m_cullMargin);
+			m_rowMaxX[row] = Max(m_rowMaxX[row], span.finX + m_cullMargin);
+		}
+	}
+}
+
+void geSpriteBatch::Submit(geRenderQueue& queue, const eRenderLayer layer)
+{//Descarta, ordena de atrás hacia adelante y agrega los sprites como copias (las consecutivas de la misma página se unen en un lote)
+	m_numVisible = 0;
+	m_numPageSwitches = 0;
+	if( m_pMap == NULL || m_sprites.empty() )
+	{
+		m_sprites.clear();
+		return;
+	}
+
+	//Resolvemos las páginas una sola vez (una página con carga asíncrona pendiente no imprime sus sprites)
+	m_pageInfo.resize(m_pages.size());
+	for( SIZE_T i=0; i<m_pages.size(); ++i )
+	{
+		PageInfo& info = m_pageInfo[i];
+		info.pTexture = NULL;
+		info.pRegions = &m_pages[i].getRegions();
+		info.width = info.height = 0;
+		if( m_pages[i].isReady() )
+		{
+			info.pTexture = m_pages[i]->GetSDLTexture();
+			info.width = m_pages[i]->GetWidth();
+			info.height = m_pages[i]->GetHeight();
+		}
+	}
+
+	//Solo los sprites visibles llegan al ordenamiento
+	BuildVisibleRows();
+	m_keys.clear();
+	for( SIZE_T i=0; i<m_sprites.size(); ++i )
+	{
+		const Sprite& sprite = m_sprites[i];
+		if( m_pageInfo[sprite.page].pTexture != NULL && isVisible(Floor(sprite.mapX), Floor(sprite.mapY)) )
+		{
+#ifdef MAP_IS_ISOMETRIC
+			float depth = sprite.mapX + sprite.mapY;	//Las diagonales x+y se imprimen de arriba hacia abajo en la pantalla
+#else
+			float depth = sprite.mapY;
+#endif
+			m_keys.push_back( MakeSortKey(depth, sprite.page, (uint32)i) );
+		}
+	}
+	RadixSort(m_keys, m_sortTemp);
+
+	//El pie del sprite va en su posición del mapa, centrado horizontalmente
+	int32 originX, originY;
+	m_pMap->getMapToScreenCoords(0, 0, originX, originY);
+	int32 lastPage = -1;
+	for( SIZE_T i=0; i<m_keys.size(); ++i )
+	{
+		const Sprite& sprite = m_sprites[(uint32)m_keys[i]];
+		const PageInfo& info = m_pageInfo[sprite.page];
+
+		SDL_Rect srcRect = { 0, 0, info.width, info.height };
+		if( sprite.region != SPRITE_WHOLE_TEXTURE )
+		{
+			GEE_ASSERT( sprite.region >= 0 && sprite.region < (int32)info.pRegions->size() );
+			srcRect = (*info.pRegions)[sprite.region];
+		}
+
+#ifdef MAP_IS_ISOMETRIC
+		int32 footX = originX + TILEHALFSIZE_X + Round( (sprite.mapX - sprite.mapY) * (float)TILEHALFSIZE_X );
+		int32 footY = originY + Round( (sprite.mapX + sprite.mapY) * (float)TILEHALFSIZE_Y );
+#else
+		int32 footX = originX + Round( sprite.mapX * (float)TILESIZE_X );
+		int32 footY = originY + Round( sprite.mapY * (float)TILESIZE_Y );
+#endif
+		SDL_Rect dstRect = { footX - (srcRect.w>>1), footY - srcRect.h, srcRect.w, srcRect.h };
+		queue.AddQuad(layer, info.pTexture, srcRect, dstRect);
+
+		if( sprite.page != lastPage )
+		{
+			++m_numPageSwitches;
+			lastPage = sprite.page;
+		}
+	}
+
+	m_numVisible = (int32)m_keys.size();
+	m_sprites.clear();
+}
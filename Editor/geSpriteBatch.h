@@ -0,0 +1,114 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geSpriteBatch.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geSpriteBatch
+				Lote de sprites de unidades sobre un geTiledMap. Los
+				sistemas agregan sus sprites durante el cuadro y al
+				enviarlos se descartan los que no caen en los tiles
+				visibles, se ordenan de atrás hacia adelante por su
+				profundidad isométrica (x+y) con un radix sort sobre
+				llaves de 64 bits, y a igual profundidad se agrupan por
+				página de atlas para que la lista de comandos los una
+				en lotes de la misma textura
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geTiledMap.h"
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define SPRITE_DEPTH_FRACTION_BITS	2		//Fracción de tile en la profundidad (los sprites a menos de 1/4 de tile se consideran a la misma profundidad y se agrupan por página)
+#define SPRITE_MAX_PAGES			256		//Páginas de atlas que caben en la llave de orden
+#define SPRITE_WHOLE_TEXTURE		-1		//Región que indica que se imprime la página completa
+#define SPRITE_CULL_MARGIN_TILES	2		//Tiles alrededor del área visible cuyos sprites se conservan (los sprites son más altos que un tile)
+
+/************************************************************************************************************************/
+/* Declaración de la clase geSpriteBatch                                												*/
+/************************************************************************************************************************/
+class geSpriteBatch : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geSpriteBatch(void);						//Constructor standard
+	~geSpriteBatch(void);						//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de inicialización                                          												*/
+	/************************************************************************************************************************/
+public:
+	bool Init(geTiledMap* pMap);
+	void Destroy();								//Libera las páginas y los sprites pendientes
+
+	int32 AddPage(const geTextureHandle& page);	//Registra una página de atlas (sus regiones son los cuadros de los sprites) y regresa su índice (-1 si ya no caben)
+	int32 getNumPages() const { return (int32)m_pages.size(); }
+	void setCullMargin(const int32 tiles) { m_cullMargin = Max(tiles, 0); }
+
+	/************************************************************************************************************************/
+	/* Funciones de control del cuadro                                      												*/
+	/************************************************************************************************************************/
+public:
+	void AddSprite(const float mapX, const float mapY, const int32 page, const int32 region = SPRITE_WHOLE_TEXTURE);	//Agrega un sprite con el pie en la posición del mapa (en tiles, con fracción)
+	void Submit(geRenderQueue& queue, const eRenderLayer layer = RL_UNITS);	//Descarta, ordena y agrega los sprites del cuadro a la lista, despues vacía el lote
+	void Clear() { m_sprites.clear(); }			//Descarta los sprites pendientes sin imprimirlos
+
+	int32 getNumPendingSprites() const { return (int32)m_sprites.size(); }
+	int32 getNumVisibleSprites() const { return m_numVisible; }		//Sprites que pasaron el descarte en el último Submit()
+	int32 getNumPageSwitches() const { return m_numPageSwitches; }	//Cambios de página en el orden final del último Submit()
+
+	static uint64 MakeSortKey(const float depth, const int32 page, const uint32 sprite);	//Profundidad (24 bits), página (8 bits) y orden de llegada (32 bits)
+	static void RadixSort(std::vector<uint64>& keys, std::vector<uint64>& temp);	//Ordena las llaves por bytes, saltando los bytes iguales en todas
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	struct Sprite
+	{
+		float mapX, mapY;					//Posición del pie del sprite
+		int32 page;							//Página de atlas
+		int32 region;						//Región dentro de la página (SPRITE_WHOLE_TEXTURE para la página completa)
+	};
+
+	struct PageInfo
+	{//Datos de una página resueltos una vez por envío
+		SDL_Texture *pTexture;				//Textura (NULL si la página aún no está lista)
+		const std::vector<SDL_Rect> *pRegions;	//Regiones de la página
+		int32 width, height;				//Tamaño de la página completa
+	};
+
+	void BuildVisibleRows();				//Convierte los rangos visibles del mapa en un rango de columnas por fila, ampliado por el margen
+	FORCEINLINE bool isVisible(const int32 x, const int32 y) const
+	{//El tile del pie está en el rango de su fila
+		int32 row = y - m_firstRow;
+		if( row < 0 || row >= (int32)m_rowMinX.size() )
+		{
+			return false;
+		}
+		return x >= m_rowMinX[row] && x <= m_rowMaxX[row];
+	}
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	geTiledMap *m_pMap;							//Mapa sobre el que se imprimen los sprites
+	std::vector<geTextureHandle> m_pages;		//Páginas de atlas registradas
+	std::vector<Sprite> m_sprites;				//Sprites del cuadro actual
+	std::vector<PageInfo> m_pageInfo;			//Páginas resueltas al comenzar el envío
+	std::vector<uint64> m_keys;					//Llaves de orden de los sprites visibles
+	std::vector<uint64> m_sortTemp;				//Buffer de apoyo del radix sort
+	std::vector<geMapRowSpan> m_spans;			//Tiles visibles de cada fila
+	std::vector<int32> m_rowMinX, m_rowMaxX;	//Columnas aceptadas por fila a partir de m_firstRow (min > max si la fila no tiene)
+	int32 m_firstRow;							//Primera fila de la tabla de descarte
+	int32 m_cullMargin;							//Tiles de margen del descarte
+	int32 m_numVisible;							//Estadísticas del último envío
+	int32 m_numPageSwitches;
+};
@@ -0,0 +1,243 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geTerrainAtlas.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geTerrainAtlas
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geTerrainAtlas.h"
+
+/************************************************************************************************************************/
+/* Funciones de ayuda                                                   												*/
+/************************************************************************************************************************/
+struct AtlasImage
+{
+	geString fileName;			//Ruta de la imagen
+	SDL_Surface *pSurface;		//Pixeles cargados
+	SDL_Rect region;			//Lugar asignado en el atlas
+};
+
+static bool CompareAtlasImageHeight(const AtlasImage* lhs, const AtlasImage* rhs) { return lhs->pSurface->h > rhs->pSurface->h; }
+
+static bool PackAtlasShelves(std::vector<AtlasImage*>& images, const int32 atlasWidth, int32& atlasHeight)
+{//Acomoda las imágenes en renglones de izquierda a derecha (ordenadas de mayor a menor altura), regresa false si alguna no cabe a lo ancho
+	int32 shelfX = 0, shelfY = 0, shelfHeight = 0;
+	for( SIZE_T i=0; i<images.size(); ++i )
+	{
+		SDL_Rect& region = images[i]->region;
+		region.w = images[i]->pSurface->w;
+		region.h = images[i]->pSurface->h;
+		if( region.w > atlasWidth )
+		{
+			return false;
+		}
+
+		if( shelfX + region.w > atlasWidth )
+		{//Abrimos un nuevo renglón
+			shelfY += shelfHeight;
+			shelfX = shelfHeight = 0;
+		}
+		region.x = shelfX;
+		region.y = shelfY;
+		shelfX += region.w;
+		shelfHeight = Max(shelfHeight, region.h);
+	}
+
+	atlasHeight = shelfY + shelfHeight;
+	return true;
+}
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geTerrainAtlas::geTerrainAtlas(void)
+{//Constructor standard
+	m_pRenderer = NULL;
+	m_numPending = 0;
+	m_bFailed = false;
+}
+
+geTerrainAtlas::~geTerrainAtlas(void)
+{//Destructor
+	Destroy();
+}
+
+void geTerrainAtlas::Destroy()
+{
+	//Descartamos la carga en curso antes de liberar lo que ya llegó
+	m_loader.Stop();
+	FreeImages();
+	m_imageFiles.clear();
+	m_typeImage.clear();
+	m_numPending = 0;
+	m_bFailed = false;
+	m_key.clear();
+	m_pRenderer = NULL;
+
+	m_texture.Release();
+	m_regions.clear();
+}
+
+void geTerrainAtlas::FreeImages()
+{//Libera las superficies decodificadas
+	for( SIZE_T i=0; i<m_imageSurfaces.size(); ++i )
+	{
+		if( m_imageSurfaces[i] != NULL )
+		{
+			SDL_FreeSurface(m_imageSurfaces[i]);
+		}
+	}
+	m_imageSurfaces.clear();
+}
+
+void geTerrainAtlas::Init(SDL_Renderer* pRenderer, const geString* pFileNames, const int32 numTypes)
+{//Toma el atlas del cache o pide las imágenes al hilo de carga
+	Destroy();
+	GEE_ASSERT(pRenderer && pFileNames && numTypes > 0);
+
+	//Si ya empacamos estas mismas imágenes antes el atlas sigue en el cache
+	m_key = TEXT("atlas:");
+	for( int32 type=0; type<numTypes; ++type )
+	{
+		m_key += pFileNames[type] + TEXT("|");
+	}
+	m_texture = g_TextureManager.Find(m_key);
+	if( m_texture.isValid() && (int32)m_texture.getRegions().size() == numTypes )
+	{
+		m_regions = m_texture.getRegions();
+		return;
+	}
+	m_texture.Release();
+
+	//Pedimos cada ruta diferente una sola vez (en el mapa isométrico todos los tipos comparten imagen)
+	m_pRenderer = pRenderer;
+	m_typeImage.resize(numTypes);
+	for( int32 type=0; type<numTypes; ++type )
+	{
+		SIZE_T index = 0;
+		while( index < m_imageFiles.size() && m_imageFiles[index] != pFileNames[type] ) ++index;
+		m_typeImage[type] = (int32)index;
+		if( index == m_imageFiles.size() )
+		{
+			m_imageFiles.push_back(pFileNames[type]);
+		}
+	}
+
+	m_imageSurfaces.assign(m_imageFiles.size(), NULL);
+	m_numPending = (int32)m_imageFiles.size();
+	for( SIZE_T i=0; i<m_imageFiles.size(); ++i )
+	{
+		m_loader.Request((int32)i, 0, m_imageFiles[i]);
+	}
+}
+
+bool geTerrainAtlas::Update()
+{//Recoge las imágenes decodificadas (el hilo de carga ya les aplicó el color key)
+	if( m_numPending == 0 )
+	{
+		return false;
+	}
+
+	geTextureDecodeJob job;
+	while( m_loader.PopDecoded(job) )
+	{
+		if( job.pSurface == NULL )
+		{
+			GEE_WARNING(TEXT("Falló al cargar la imagen para el atlas: ") + job.path);
+			m_bFailed = true;
+		}
+		m_imageSurfaces[job.entry] = job.pSurface;
+		--m_numPending;
+	}
+	if( m_numPending > 0 )
+	{
+		return false;
+	}
+
+	//Llegaron todas, empacamos en este cuadro y ya no necesitamos el hilo
+	bool bPacked = !m_bFailed && Pack();
+	FreeImages();
+	m_loader.Stop();
+	return bPacked;
+}
+
+bool geTerrainAtlas::Pack()
+{//Empaca las imágenes decodificadas
+	std::vector<AtlasImage> images(m_imageFiles.size());
+	for( SIZE_T i=0; i<images.size(); ++i )
+	{
+		images[i].fileName = m_imageFiles[i];
+		images[i].pSurface = m_imageSurfaces[i];
+	}
+
+	//Buscamos el ancho potencia de 2 más chico en el que caben todas las imágenes sin pasar del máximo del renderer
+	int32 maxSize = TERRAIN_ATLAS_MAX_SIZE;
+	SDL_RendererInfo info;
+	if( SDL_GetRendererInfo(m_pRenderer, &info) == 0 && info.max_texture_width > 0 && info.max_texture_height > 0 )
+	{
+		maxSize = Min( (int32)info.max_texture_width, (int32)info.max_texture_height );
+	}
+
+	std::vector<AtlasImage*> sorted;
+	int32 maxWidth = 0;
+	for( SIZE_T i=0; i<images.size(); ++i )
+	{
+		sorted.push_back(&images[i]);
+		maxWidth = Max(maxWidth, images[i].pSurface->w);
+	}
+	std::sort(sorted.begin(), sorted.end(), CompareAtlasImageHeight);
+
+	int32 atlasWidth = (int32)RoundUpToPowerOfTwo( (uint32)Max(maxWidth, 1) );
+	int32 atlasHeight = 0;
+	bool bPacked = false;
+	while( atlasWidth <= maxSize )
+	{
+		if( PackAtlasShelves(sorted, atlasWidth, atlasHeight) && atlasHeight <= atlasWidth )
+		{
+			bPacked = true;
+			break;
+		}
+		atlasWidth <<= 1;
+	}
+	if( !bPacked )
+	{
+		GEE_WARNING( TEXT("Las imágenes del terreno no caben en un atlas, se usarán texturas separadas") );
+		return false;
+	}
+
+	//Copiamos las imágenes al atlas y lo subimos como una sola textura
+	SDL_Surface* pAtlasSurface = SDL_CreateRGBSurface(0, atlasWidth, atlasHeight, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+	if( pAtlasSurface == NULL )
+	{
+		return false;
+	}
+
+	SDL_FillRect(pAtlasSurface, NULL, 0);	//Transparente donde no hay imagen o hay color key
+	for( SIZE_T i=0; i<images.size(); ++i )
+	{
+		SDL_SetSurfaceBlendMode(images[i].pSurface, SDL_BLENDMODE_NONE);
+		SDL_BlitSurface(images[i].pSurface, NULL, pAtlasSurface, &images[i].region);
+	}
+
+	//Guardamos la región de cada tipo junto con la textura (los tipos con la misma imagen comparten región)
+	std::vector<SDL_Rect> regions(m_typeImage.size());
+	for( SIZE_T type=0; type<m_typeImage.size(); ++type )
+	{
+		regions[type] = images[m_typeImage[type]].region;
+	}
+
+	m_texture = g_TextureManager.Create(m_key, pAtlasSurface, &regions);
+	if( m_texture.isValid() )
+	{
+		m_texture->SetBlendMode(SDL_BLENDMODE_BLEND);
+		m_regions = regions;
+	}
+	SDL_FreeSurface(pAtlasSurface);
+
+	return m_texture.isValid();
+}
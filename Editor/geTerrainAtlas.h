@@ -0,0 +1,84 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geTerrainAtlas.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geTerrainAtlas
+				Empaca las imágenes de los tipos de terreno en una sola
+				textura al cargar el mapa. Con todos los tiles en la
+				misma textura el terreno completo se envía como uno o
+				pocos lotes de geometría en lugar de cambiar de textura
+				casi en cada tile. El atlas se guarda en el cache de
+				texturas, así recrear el mapa no vuelve a empacarlo.
+				Las imágenes se decodifican en un hilo de trabajo y el
+				atlas se empaca en Update() cuando llegan todas
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define TERRAIN_ATLAS_MAX_SIZE		4096	//Tamaño máximo del atlas si el renderer no reporta uno
+
+/************************************************************************************************************************/
+/* Declaración de la clase geTerrainAtlas                               												*/
+/************************************************************************************************************************/
+class geTerrainAtlas : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geTerrainAtlas(void);						//Constructor standard
+	~geTerrainAtlas(void);						//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de creación                                                												*/
+	/************************************************************************************************************************/
+public:
+	void Init(SDL_Renderer* pRenderer, const geString* pFileNames, const int32 numTypes);	//Toma el atlas del cache o pide al hilo de carga una imagen por tipo (las rutas repetidas se cargan una sola vez)
+	bool Update();								//Recoge las imágenes decodificadas y empaca el atlas cuando llegan todas, regresa true en la llamada que lo deja listo
+	void Destroy();
+
+	/************************************************************************************************************************/
+	/* Funciones de consulta                                                												*/
+	/************************************************************************************************************************/
+public:
+	bool isValid() const { return m_texture.isValid(); }
+	bool isLoading() const { return m_numPending > 0; }	//Aún faltan imágenes por decodificar (si termina sin ser válido es que no se pudo crear)
+	SDL_Texture* getTexture() const { return m_texture->GetSDLTexture(); }
+	const SDL_Rect& getRegion(const int32 type) const { return m_regions[type]; }	//Región del atlas con la imagen del tipo
+
+	FORCEINLINE void getSource(const int32 type, const int32 pixelX, const int32 pixelY, const int32 width, const int32 height, SDL_Rect& src) const
+	{//Región del atlas para un pedazo de la imagen del tipo (la imagen se repite cada ancho/alto de su región, igual que con texturas separadas)
+		const SDL_Rect& region = m_regions[type];
+		src.x = region.x + (pixelX % region.w);
+		src.y = region.y + (pixelY % region.h);
+		src.w = width;
+		src.h = height;
+	}
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	bool Pack();								//Empaca las imágenes decodificadas y sube el atlas al cache de texturas
+	void FreeImages();							//Libera las superficies decodificadas
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	geTextureHandle m_texture;					//Textura con todas las imágenes (compartida por el cache de texturas)
+	std::vector<SDL_Rect> m_regions;			//Región de cada tipo dentro del atlas
+
+	//Datos de la carga en curso
+	SDL_Renderer *m_pRenderer;					//Renderer del que se obtiene el tamaño máximo de textura
+	geString m_key;								//Llave del atlas en el cache de texturas
+	geTextureLoader m_loader;					//Hilo que decodifica las imágenes
+	std::vector<geString> m_imageFiles;			//Rutas diferentes que se pidieron
+	std::vector<SDL_Surface*> m_imageSurfaces;	//Superficie decodificada de cada ruta (NULL mientras no llega)
+	std::vector<int32> m_typeImage;				//Imagen que usa cada tipo
+	int32 m_numPending;							//Imágenes que aún no llegan del hilo de carga
+	bool m_bFailed;								//Alguna imagen no se pudo decodificar
+};
@@ -0,0 +1,284 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geTerrainChunkCache.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geTerrainChunkCache
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geTerrainChunkCache.h"
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geTerrainChunkCache::geTerrainChunkCache(void)
+{//Constructor standard
+	m_pRenderer = NULL;
+	m_pMap = NULL;
+	m_bSupported = false;
+	m_bEnabled = false;
+	m_numChunksX = m_numChunksY = 0;
+	m_frame = 0;
+	m_numRasterized = 0;
+}
+
+geTerrainChunkCache::~geTerrainChunkCache(void)
+{//Destructor
+	Destroy();
+}
+
+bool geTerrainChunkCache::Init(SDL_Renderer* pRenderer, geTiledMap* pMap)
+{//Prepara el cache para el mapa
+	Destroy();
+
+	GEE_ASSERT(pRenderer && pMap);
+	m_pRenderer = pRenderer;
+	m_pMap = pMap;
+
+	//Sin render targets no podemos rasterizar los chunks, el mapa sigue imprimiendo tile por tile
+	m_bSupported = (SDL_RenderTargetSupported(pRenderer) == SDL_TRUE);
+	m_bEnabled = m_bSupported;
+	if( !m_bSupported )
+	{
+		GEE_WARNING( TEXT("El renderer no soporta render targets, el terreno se imprimirá tile por tile") );
+		return false;
+	}
+
+	CheckMapSize();
+	return true;
+}
+
+void geTerrainChunkCache::Destroy()
+{//Libera todas las texturas
+	for( SIZE_T i=0; i<m_entries.size(); ++i )
+	{
+		if( m_entries[i].pTexture != NULL )
+		{
+			SDL_DestroyTexture(m_entries[i].pTexture);
+		}
+	}
+	m_entries.clear();
+	m_rasterQueue.Clear();
+	m_chunkEntry.clear();
+	m_chunkFrame.clear();
+	m_visibleChunks.clear();
+	m_numChunksX = m_numChunksY = 0;
+
+	m_pRenderer = NULL;
+	m_pMap = NULL;
+	m_bSupported = false;
+	m_bEnabled = false;
+}
+
+void geTerrainChunkCache::Invalidate()
+{//Conservamos las texturas pero obligamos a rasterizar todo de nuevo
+	for( SIZE_T i=0; i<m_entries.size(); ++i )
+	{
+		if( m_entries[i].chunk >= 0 )
+		{
+			m_chunkEntry[m_entries[i].chunk] = -1;
+		}
+		m_entries[i].chunk = -1;
+	}
+}
+
+void geTerrainChunkCache::CheckMapSize()
+{//Si el número de chunks cambió, ninguna entrada sigue siendo válida
+	int32 numChunksX = m_pMap->getNumChunksX();
+	int32 numChunksY = m_pMap->getNumChunksY();
+	if( numChunksX == m_numChunksX && numChunksY == m_numChunksY )
+	{
+		return;
+	}
+
+	m_numChunksX = numChunksX;
+	m_numChunksY = numChunksY;
+	m_chunkEntry.assign(numChunksX*numChunksY, -1);
+	m_chunkFrame.assign(numChunksX*numChunksY, 0);
+	for( SIZE_T i=0; i<m_entries.size(); ++i )
+	{
+		m_entries[i].chunk = -1;
+	}
+}
+
+int32 geTerrainChunkCache::AcquireEntry(const int32 chunk)
+{//Obtiene una entrada para el chunk
+	//Si todavía hay espacio creamos una textura nueva
+	if( m_entries.size() < CHUNK_CACHE_MAX_TEXTURES )
+	{
+		Entry entry;
+		entry.pTexture = SDL_CreateTexture(m_pRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, CHUNK_TEXTURE_WIDTH, CHUNK_TEXTURE_HEIGHT);
+		if( entry.pTexture != NULL )
+		{
+			SDL_SetTextureBlendMode(entry.pTexture, SDL_BLENDMODE_BLEND);	//Las esquinas fuera del rombo son transparentes
+			entry.chunk = chunk;
+			entry.version = 0;
+			entry.lastFrame = m_frame;
+			m_entries.push_back(entry);
+			return (int32)m_entries.size()-1;
+		}
+		GEE_WARNING( TEXT("No se pudo crear la textura de un chunk! SDL Error: ") + s2gs(SDL_GetError()) );
+	}
+
+	//Buscamos la entrada libre o la usada hace más tiempo, las del cuadro actual no se pueden desalojar
+	int32 oldest = -1;
+	for( SIZE_T i=0; i<m_entries.size(); ++i )
+	{
+		if( m_entries[i].chunk < 0 )
+		{
+			oldest = (int32)i;
+			break;
+		}
+		if( m_entries[i].lastFrame != m_frame && (oldest < 0 || m_entries[i].lastFrame < m_entries[oldest].lastFrame) )
+		{
+			oldest = (int32)i;
+		}
+	}
+	if( oldest < 0 )
+	{
+		return -1;
+	}
+
+	Entry& entry = m_entries[oldest];
+	if( entry.chunk >= 0 )
+	{
+		m_chunkEntry[entry.chunk] = -1;
+	}
+	entry.chunk = chunk;
+	entry.version = 0;
+	entry.lastFrame = m_frame;
+	return oldest;
+}
+
+void geTerrainChunkCache::Rasterize(Entry& entry, const int32 chunkX, const int32 chunkY)
+{//Imprime los tiles del chunk en su textura
+	SDL_SetRenderTarget(m_pRenderer, entry.pTexture);
+	SDL_SetRenderDrawColor(m_pRenderer, 0, 0, 0, 0);
+	SDL_RenderClear(m_pRenderer);
+
+	int32 iniX = chunkX<<MAP_CHUNK_BITS, iniY = chunkY<<MAP_CHUNK_BITS;
+	int32 finX = Min(iniX+MAP_CHUNK_SIZE, m_pMap->getMapWidth());
+	int32 finY = Min(iniY+MAP_CHUNK_SIZE, m_pMap->getMapHeight());
+
+	//Los tiles se juntan en lotes (uno solo si el mapa tiene atlas) y se envían a la textura del chunk
+	m_rasterQueue.Clear();
+	SDL_Rect clipRect, dstRect;
+	dstRect.w = TILESIZE_X;
+	dstRect.h = TILESIZE_Y;
+	for( int32 iterY=iniY; iterY<finY; ++iterY )
+	{
+		const uint8* pTypeRow = m_pMap->getTypeRow(iterY);
+		for( int32 iterX=iniX; iterX<finX; ++iterX )
+		{
+			SDL_Texture* pTexture = m_pMap->getTerrainSource(pTypeRow[iterX], iterX, iterY, clipRect);
+
+			//Posición del tile dentro de la textura del chunk
+			int32 localX = iterX-iniX, localY = iterY-iniY;
+#ifdef MAP_IS_ISOMETRIC
+			dstRect.x = (localX - localY + MAP_CHUNK_MASK) << BITSFT_TILEHALFSIZE_X;
+			dstRect.y = (localX + localY) << BITSFT_TILEHALFSIZE_Y;
+#else
+			dstRect.x = localX << BITSFT_TILESIZE_X;
+			dstRect.y = localY << BITSFT_TILESIZE_Y;
+#endif
+			m_rasterQueue.AddQuad(RL_TERRAIN, pTexture, clipRect, dstRect);
+		}
+	}
+	m_rasterQueue.Submit(m_pRenderer);
+
+	SDL_SetRenderTarget(m_pRenderer, NULL);
+	entry.version = m_pMap->getChunkVersion(chunkX, chunkY);
+	++m_numRasterized;
+}
+
+bool geTerrainChunkCache::Render(geRenderQueue& queue, const std::vector<geMapRowSpan>& spans)
+{//Agrega una copia por chunk visible
+	if( !m_bEnabled )
+	{
+		return false;
+	}
+
+	CheckMapSize();
+	++m_frame;
+	m_numRasterized = 0;
+
+	//Obtenemos los chunks que contienen algún tile visible (cada rango de fila toca pocos chunks)
+	m_visibleChunks.clear();
+	for( SIZE_T i=0; i<spans.size(); ++i )
+	{
+		int32 chunkY = spans[i].y>>MAP_CHUNK_BITS;
+		for( int32 chunkX=spans[i].iniX>>MAP_CHUNK_BITS; chunkX<=(spans[i].finX>>MAP_CHUNK_BITS); ++chunkX )
+		{
+			int32 chunk = (chunkY*m_numChunksX)+chunkX;
+			if( m_chunkFrame[chunk] != m_frame )
+			{
+				m_chunkFrame[chunk] = m_frame;
+				m_visibleChunks.push_back(chunk);
+			}
+		}
+	}
+
+	//Si no caben todos en el cache dejamos que el mapa imprima tile por tile este cuadro
+	if( m_visibleChunks.size() > CHUNK_CACHE_MAX_TEXTURES )
+	{
+		return false;
+	}
+
+	//Primero nos aseguramos de que todos tengan su textura al día, así si falla alguno no queda nada agregado a la lista
+	for( SIZE_T i=0; i<m_visibleChunks.size(); ++i )
+	{
+		int32 chunk = m_visibleChunks[i];
+		int32 chunkX = chunk % m_numChunksX, chunkY = chunk / m_numChunksX;
+
+		//Los chunks que aún se están cargando no se imprimen
+		if( !m_pMap->isChunkReady(chunkX, chunkY) )
+		{
+			continue;
+		}
+
+		int32 index = m_chunkEntry[chunk];
+		if( index < 0 )
+		{
+			index = AcquireEntry(chunk);
+			if( index < 0 )
+			{
+				return false;
+			}
+			m_chunkEntry[chunk] = (int16)index;
+		}
+
+		//Solo rasterizamos si el chunk cambió desde la última vez
+		Entry& entry = m_entries[index];
+		entry.lastFrame = m_frame;
+		if( entry.version != m_pMap->getChunkVersion(chunkX, chunkY) )
+		{
+			Rasterize(entry, chunkX, chunkY);
+		}
+	}
+
+	SDL_Rect dstRect;
+	dstRect.w = CHUNK_TEXTURE_WIDTH;
+	dstRect.h = CHUNK_TEXTURE_HEIGHT;
+	for( SIZE_T i=0; i<m_visibleChunks.size(); ++i )
+	{
+		int32 chunk = m_visibleChunks[i];
+		int32 chunkX = chunk % m_numChunksX, chunkY = chunk / m_numChunksX;
+		if( m_chunkEntry[chunk] < 0 || !m_pMap->isChunkReady(chunkX, chunkY) )
+		{
+			continue;
+		}
+
+		//La textura empieza medio rombo a la izquierda del primer tile del chunk
+		m_pMap->getMapToScreenCoords(chunkX<<MAP_CHUNK_BITS, chunkY<<MAP_CHUNK_BITS, dstRect.x, dstRect.y);
+#ifdef MAP_IS_ISOMETRIC
+		dstRect.x -= MAP_CHUNK_MASK<<BITSFT_TILEHALFSIZE_X;
+#endif
+		queue.AddCopy(RL_TERRAIN, m_entries[m_chunkEntry[chunk]].pTexture, NULL, dstRect);
+	}
+
+	return true;
+}
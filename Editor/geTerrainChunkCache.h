@@ -0,0 +1,90 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geTerrainChunkCache.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geTerrainChunkCache
+				Guarda el terreno de cada chunk del mapa pre-rendereado
+				en una textura, así un cuadro solo necesita una copia
+				por chunk visible en lugar de una por tile. Un chunk se
+				vuelve a rasterizar solo cuando su versión en el journal
+				del mapa cambia. Usa texturas de render target, que
+				también soporta el renderer por software de SDL
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define CHUNK_CACHE_MAX_TEXTURES	48		//Número máximo de texturas de chunk vivas (si hay más chunks visibles se imprime tile por tile)
+
+#ifdef MAP_IS_ISOMETRIC
+	#define CHUNK_TEXTURE_WIDTH		(((MAP_CHUNK_SIZE-1)*2*TILEHALFSIZE_X)+TILESIZE_X)	//Ancho del rombo de un chunk
+	#define CHUNK_TEXTURE_HEIGHT	(((MAP_CHUNK_SIZE-1)*2*TILEHALFSIZE_Y)+TILESIZE_Y)	//Alto del rombo de un chunk
+#else
+	#define CHUNK_TEXTURE_WIDTH		(MAP_CHUNK_SIZE*TILESIZE_X)
+	#define CHUNK_TEXTURE_HEIGHT	(MAP_CHUNK_SIZE*TILESIZE_Y)
+#endif
+
+class geTiledMap;
+
+/************************************************************************************************************************/
+/* Declaración de la clase geTerrainChunkCache                          												*/
+/************************************************************************************************************************/
+class geTerrainChunkCache : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geTerrainChunkCache(void);					//Constructor standard
+	~geTerrainChunkCache(void);					//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de inicialización y rendereo                               												*/
+	/************************************************************************************************************************/
+public:
+	bool Init(SDL_Renderer* pRenderer, geTiledMap* pMap);	//Prepara el cache para el mapa (regresa false si el renderer no soporta render targets)
+	void Destroy();											//Libera todas las texturas
+	void Invalidate();										//Marca todos los chunks para rasterizarse de nuevo (ej. cuando el dispositivo pierde los render targets)
+
+	bool Render(geRenderQueue& queue, const std::vector<geMapRowSpan>& spans);	//Agrega una copia por chunk visible, regresa false si no caben todos y hay que imprimir tile por tile
+
+	bool isEnabled() const { return m_bEnabled; }
+	void setEnabled(const bool bEnabled) { m_bEnabled = bEnabled && m_bSupported; }
+	int32 getNumRasterized() const { return m_numRasterized; }	//Chunks rasterizados en el último cuadro (para medir)
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	struct Entry
+	{
+		SDL_Texture *pTexture;		//Textura con el terreno del chunk
+		int32 chunk;				//Chunk que contiene (-1 si está libre)
+		uint32 version;				//Versión del chunk con la que se rasterizó
+		uint32 lastFrame;			//Último cuadro en el que se usó (para desalojar el menos reciente)
+	};
+
+	int32 AcquireEntry(const int32 chunk);						//Obtiene una textura libre o desaloja la usada hace más tiempo (-1 si todas se usan en este cuadro)
+	void Rasterize(Entry& entry, const int32 chunkX, const int32 chunkY);	//Imprime los tiles del chunk en su textura
+	void CheckMapSize();										//Reinicia el cache si el mapa cambió de tamaño
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	SDL_Renderer *m_pRenderer;					//Renderer con el que se crean y rasterizan las texturas
+	geTiledMap *m_pMap;							//Mapa asociado
+	bool m_bSupported;							//El renderer soporta render targets
+	bool m_bEnabled;							//El cache está activo
+
+	int32 m_numChunksX, m_numChunksY;			//Chunks del mapa con el que se creó el cache
+	std::vector<Entry> m_entries;				//Texturas del cache
+	std::vector<int16> m_chunkEntry;			//Entrada de cada chunk (-1 si no está en el cache)
+	std::vector<uint32> m_chunkFrame;			//Último cuadro en el que el chunk fue visible (para no agregarlo dos veces)
+	std::vector<int32> m_visibleChunks;			//Chunks visibles del cuadro actual
+	geRenderQueue m_rasterQueue;				//Lotes de tiles con los que se rasteriza un chunk
+	uint32 m_frame;								//Número de cuadro actual
+	int32 m_numRasterized;						//Chunks rasterizados en el último cuadro
+};
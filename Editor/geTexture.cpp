@@ -43,10 +43,6 @@ bool geTexture::LoadFromFile( SDL_Renderer *pRenderer, geString path )
 	Free();
 
 	GEE_ASSERT(pRenderer);
-	m_Renderer = pRenderer;	//Almacenamos localmente una referencia al renderer que se utilizará para crear este objeto
-
-	//Creamos un puntero a la nueva textura que alojaremos en memoria
-	SDL_Texture* newTexture = NULL;
 
 	//Cargamos la imagen desde la ruta especificada
 #if PLATFORM_TCHAR_IS_1_BYTE == 1
@@ -64,24 +60,38 @@ bool geTexture::LoadFromFile( SDL_Renderer *pRenderer, geString path )
 		SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, 0, 0xFF, 0xFF ) );
 
 		//Creamos la textura a partir de los pixeles de la superficie
-		newTexture = SDL_CreateTextureFromSurface( m_Renderer, loadedSurface );
-		if( newTexture == NULL )
+		if( !CreateFromSurface( pRenderer, loadedSurface ) )
 		{//Si falló al crear la textura
 			GEE_WARNING(TEXT("Falló al crear la textura: ") + path);
 		}
-		else
-		{
-			//Almacenamos las dimensiones de la imagen
-			m_Width = loadedSurface->w;
-			m_Height = loadedSurface->h;
-		}
 
 		//Get rid of old loaded surface
 		SDL_FreeSurface( loadedSurface );
 	}
 
 	//Return success
-	m_Texture = newTexture;
+	return m_Texture != NULL;
+}
+
+/************************************************************************/
+/* Esta función crea la textura a partir de una superficie              */
+/************************************************************************/
+bool geTexture::CreateFromSurface( SDL_Renderer *pRenderer, SDL_Surface *pSurface )
+{
+	//Nos deshacemos de cualquier información anterior
+	Free();
+
+	GEE_ASSERT(pRenderer && pSurface);
+	m_Renderer = pRenderer;	//Almacenamos localmente una referencia al renderer que se utilizará para crear este objeto
+
+	m_Texture = SDL_CreateTextureFromSurface( m_Renderer, pSurface );
+	if( m_Texture != NULL )
+	{
+		//Almacenamos las dimensiones de la imagen
+		m_Width = pSurface->w;
+		m_Height = pSurface->h;
+	}
+
 	return m_Texture != NULL;
 }
 
@@ -147,6 +157,23 @@ void geTexture::Render(const int32 x, const int32 y, SDL_Rect* clip)
 	//SDL_RenderCopyEx( m_Renderer, m_Texture, clip, &renderQuad, angle, center, flip );
 }
 
+/************************************************************************/
+/* Agrega la copia de la imagen a una lista de comandos de dibujo       */
+/************************************************************************/
+void geTexture::Render( geRenderQueue& queue, const eRenderLayer layer, const int32 x, const int32 y, const SDL_Rect* clip )
+{
+	SDL_Rect renderQuad = { x, y, m_Width, m_Height };
+
+	//Establece las dimensiones del clip de render
+	if( clip != NULL )
+	{
+		renderQuad.w = clip->w;
+		renderQuad.h = clip->h;
+	}
+
+	queue.AddCopy( layer, m_Texture, clip, renderQuad );
+}
+
 /************************************************************************/
 /* Establece el espacio de rendereo y renderea la imagen a la pantalla  */
 /* Esta es la versión que procesa efectos (consume más tiempo)			*/
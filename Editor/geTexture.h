@@ -16,6 +16,7 @@ public:
 
 	//Funciones de carga y creación
 	bool LoadFromFile( SDL_Renderer *pRenderer, geString path );	//Carga una imagen a partir de la ruta especificada
+	bool CreateFromSurface( SDL_Renderer *pRenderer, SDL_Surface *pSurface );	//Crea la textura a partir de pixeles ya cargados (la superficie sigue siendo del llamador)
 
 	//Funciones genericas
 	void Free();											//Desaloja la textura
@@ -24,10 +25,12 @@ public:
 	void SetAlpha( Uint8 alpha );							//Establece la modulación del canal alpha
 	void Render( const int32 x, const int32 y, SDL_Rect* clip=NULL);	//Renderea la textura haciendo una copia a pantalla sin ningún tipo de efecto
 	void RenderEx( const int32 x, const int32 y, SDL_Rect* clip=NULL, double angle=0.0, SDL_Point* center=NULL, SDL_RendererFlip flip=SDL_FLIP_NONE );	//Renderea la textura aplicando giro o efectos
+	void Render( geRenderQueue& queue, const eRenderLayer layer, const int32 x, const int32 y, const SDL_Rect* clip=NULL );	//Agrega la copia a una lista de comandos en lugar de enviarla a SDL
 
 	//Estas funciones regresan información sobre la textura
 	int GetWidth();		//Longitud
 	int GetHeight();	//Altura
+	SDL_Texture* GetSDLTexture() { return m_Texture; }	//Textura de SDL
 
 private:
 	SDL_Renderer* m_Renderer;	//Puntero al objeto de renderer utilizado para crear este recurso
@@ -0,0 +1,162 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geTextureLoader.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geTextureLoader
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geTextureLoader.h"
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geTextureLoader::geTextureLoader(void)
+{//Constructor standard
+	m_numPending = 0;
+
+	//Creamos el evento de sincronización (con reinicio automático)
+	m_hWakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	GEE_ASSERT(m_hWakeEvent);
+}
+
+geTextureLoader::~geTextureLoader(void)
+{//Destructor
+	Stop();
+
+	if( m_hWakeEvent != NULL )
+	{
+		CloseHandle(m_hWakeEvent);
+		m_hWakeEvent = NULL;
+	}
+}
+
+void geTextureLoader::Request(const int32 entry, const uint32 serial, const geString& path)
+{//Agrega un archivo a la cola
+	geTextureDecodeJob job;
+	job.entry = entry;
+	job.serial = serial;
+	job.path = path;
+	job.pSurface = NULL;
+
+	{
+		ScopedCriticalSection lock(m_lock);
+		m_requests.push(job);
+	}
+	InterlockedIncrement(&m_numPending);
+
+	//El hilo se crea con el primer pedido y se queda esperando los siguientes
+	if( !IsRunning() )
+	{
+		Join();
+		if( !Start() )
+		{
+			GEE_WARNING(TEXT("geTextureLoader::Request: Falló al crear el hilo de carga para ") + path);
+		}
+	}
+	SetEvent(m_hWakeEvent);
+}
+
+bool geTextureLoader::PopDecoded(geTextureDecodeJob& job)
+{//Saca un resultado terminado
+	ScopedCriticalSection lock(m_lock);
+	if( m_decoded.empty() )
+	{
+		return false;
+	}
+
+	job = m_decoded.front();
+	m_decoded.pop();
+	InterlockedDecrement(&m_numPending);
+	return true;
+}
+
+bool geTextureLoader::Cancel(const int32 entry, const uint32 serial)
+{//Reconstruimos la cola sin el pedido (son pocos pedidos y solo pasa cuando alguien necesita la textura de inmediato)
+	ScopedCriticalSection lock(m_lock);
+	bool bFound = false;
+	SIZE_T numRequests = m_requests.size();
+	for( SIZE_T i=0; i<numRequests; ++i )
+	{
+		geTextureDecodeJob job = m_requests.front();
+		m_requests.pop();
+		if( !bFound && job.entry == entry && job.serial == serial )
+		{
+			bFound = true;
+			continue;
+		}
+		m_requests.push(job);
+	}
+
+	if( bFound )
+	{
+		InterlockedDecrement(&m_numPending);
+	}
+	return bFound;
+}
+
+void geTextureLoader::Stop()
+{//Detiene el hilo y descarta lo pendiente
+	RequestStop();
+	SetEvent(m_hWakeEvent);
+	Join();
+
+	ScopedCriticalSection lock(m_lock);
+	while( !m_requests.empty() )
+	{
+		m_requests.pop();
+	}
+	while( !m_decoded.empty() )
+	{
+		if( m_decoded.front().pSurface != NULL )
+		{
+			SDL_FreeSurface(m_decoded.front().pSurface);
+		}
+		m_decoded.pop();
+	}
+	InterlockedExchange(&m_numPending, 0);
+}
+
+uint32 geTextureLoader::Run()
+{//Función del hilo de trabajo
+	while( !IsStopRequested() )
+	{
+		//Tomamos el siguiente pedido, si no hay esperamos a que llegue uno
+		geTextureDecodeJob job;
+		bool bHasJob = false;
+		{
+			ScopedCriticalSection lock(m_lock);
+			if( !m_requests.empty() )
+			{
+				job = m_requests.front();
+				m_requests.pop();
+				bHasJob = true;
+			}
+		}
+		if( !bHasJob )
+		{
+			WaitForSingleObject(m_hWakeEvent, INFINITE);
+			continue;
+		}
+
+		//Decodificamos la imagen igual que geTexture::LoadFromFile (solo la creación de la textura queda para el hilo principal)
+#if PLATFORM_TCHAR_IS_1_BYTE == 1
+		job.pSurface = IMG_Load( job.path.c_str() );
+#else
+		job.pSurface = IMG_Load( ws2s(job.path).c_str() );
+#endif // PLATFORM_TCHAR_IS_1_BYTE == 1
+		if( job.pSurface != NULL )
+		{
+			SDL_SetColorKey( job.pSurface, SDL_TRUE, SDL_MapRGB( job.pSurface->format, 0, 0xFF, 0xFF ) );
+		}
+
+		ScopedCriticalSection lock(m_lock);
+		m_decoded.push(job);
+	}
+
+	return 0;
+}
@@ -0,0 +1,62 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geTextureLoader.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geTextureLoader
+				Hilo de trabajo que decodifica archivos de imagen a
+				superficies de SDL. Crear la textura a partir de la
+				superficie tiene que hacerse en el hilo del renderer,
+				así que geTextureManager recoge los resultados y los
+				sube con un límite de tiempo por cuadro
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Declaración de estructuras                                           												*/
+/************************************************************************************************************************/
+//Pedido de decodificación (o su resultado)
+struct geTextureDecodeJob
+{
+	int32 entry;				//Entrada del cache que espera la imagen
+	uint32 serial;				//Número de serie de la entrada al hacer el pedido (si cambió, la entrada ya no la espera)
+	geString path;				//Archivo a decodificar
+	SDL_Surface *pSurface;		//Superficie decodificada (NULL si falló o aún no se decodifica)
+};
+
+/************************************************************************************************************************/
+/* Declaración de la clase geTextureLoader                              												*/
+/************************************************************************************************************************/
+class geTextureLoader : public geThread
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geTextureLoader(void);						//Constructor standard
+	virtual ~geTextureLoader(void);				//Destructor (detiene el hilo y libera los resultados no recogidos)
+
+	/************************************************************************************************************************/
+	/* Funciones de control                                                 												*/
+	/************************************************************************************************************************/
+public:
+	void Request(const int32 entry, const uint32 serial, const geString& path);	//Agrega un archivo a la cola (inicia el hilo si no está corriendo)
+	bool PopDecoded(geTextureDecodeJob& job);									//Saca un resultado terminado, regresa false si no hay
+	bool Cancel(const int32 entry, const uint32 serial);						//Quita un pedido que el hilo aún no toma, regresa false si ya se está decodificando o ya terminó
+	void Stop();																//Detiene el hilo y descarta los pedidos y resultados pendientes
+
+	int32 getNumPending() const { return m_numPending; }						//Pedidos que aún no se recogen con PopDecoded()
+
+protected:
+	virtual uint32 Run();						//Función del hilo de trabajo
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	CriticalSection m_lock;						//Protege las dos colas
+	std::queue<geTextureDecodeJob> m_requests;	//Archivos por decodificar
+	std::queue<geTextureDecodeJob> m_decoded;	//Superficies listas para subirse
+	HANDLE m_hWakeEvent;						//Despierta al hilo cuando llega un pedido o debe terminar
+	volatile LONG m_numPending;					//Pedidos hechos que aún no se recogen
+};
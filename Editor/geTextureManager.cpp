@@ -0,0 +1,510 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geTextureManager.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de las clases geTextureManager y
+				geTextureHandle
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geTextureManager.h"
+
+/************************************************************************************************************************/
+/* Variables globales                                                   												*/
+/************************************************************************************************************************/
+geTextureManager g_TextureManager;
+
+/************************************************************************************************************************/
+/* Implementación de la clase geTextureHandle                           												*/
+/************************************************************************************************************************/
+geTextureHandle::geTextureHandle(void)
+{
+	m_pManager = NULL;
+	m_index = -1;
+	m_serial = 0;
+}
+
+geTextureHandle::geTextureHandle(geTextureManager* pManager, const int32 index)
+{//Solo el cache crea handles válidos (la referencia ya fue contada)
+	m_pManager = pManager;
+	m_index = index;
+	m_serial = pManager->m_entries[index].serial;
+}
+
+geTextureHandle::geTextureHandle(const geTextureHandle& other)
+{
+	m_pManager = other.m_pManager;
+	m_index = other.m_index;
+	m_serial = other.m_serial;
+	if( m_pManager != NULL )
+	{
+		m_pManager->AddRef(m_index, m_serial);
+	}
+}
+
+geTextureHandle::~geTextureHandle(void)
+{
+	Release();
+}
+
+geTextureHandle& geTextureHandle::operator=(const geTextureHandle& other)
+{
+	if( this != &other )
+	{
+		//Contamos la nueva referencia antes de soltar la anterior por si son la misma entrada
+		if( other.m_pManager != NULL )
+		{
+			other.m_pManager->AddRef(other.m_index, other.m_serial);
+		}
+		Release();
+		m_pManager = other.m_pManager;
+		m_index = other.m_index;
+		m_serial = other.m_serial;
+	}
+	return *this;
+}
+
+void geTextureHandle::Release()
+{
+	if( m_pManager != NULL )
+	{
+		m_pManager->ReleaseRef(m_index, m_serial);
+	}
+	m_pManager = NULL;
+	m_index = -1;
+	m_serial = 0;
+}
+
+bool geTextureHandle::isValid() const
+{
+	return m_pManager != NULL && m_pManager->getEntry(m_index, m_serial) != NULL;
+}
+
+bool geTextureHandle::isReady() const
+{
+	geTexture* pTexture = get();
+	return pTexture != NULL && pTexture->GetSDLTexture() != NULL;
+}
+
+bool geTextureHandle::isPending() const
+{
+	const geTextureManager::Entry* pEntry = (m_pManager != NULL) ? m_pManager->getEntry(m_index, m_serial) : NULL;
+	return pEntry != NULL && pEntry->bPending;
+}
+
+geTexture* geTextureHandle::get() const
+{
+	if( m_pManager == NULL )
+	{
+		return NULL;
+	}
+	const geTextureManager::Entry* pEntry = m_pManager->getEntry(m_index, m_serial);
+	return (pEntry != NULL) ? pEntry->pTexture : NULL;
+}
+
+const std::vector<SDL_Rect>& geTextureHandle::getRegions() const
+{
+	static const std::vector<SDL_Rect> s_noRegions;
+	const geTextureManager::Entry* pEntry = (m_pManager != NULL) ? m_pManager->getEntry(m_index, m_serial) : NULL;
+	return (pEntry != NULL) ? pEntry->regions : s_noRegions;
+}
+
+/************************************************************************************************************************/
+/* Implementación de la clase geTextureManager                          												*/
+/************************************************************************************************************************/
+geTextureManager::geTextureManager(void)
+{//Constructor standard
+	m_pRenderer = NULL;
+	m_budgetBytes = TEXTURE_CACHE_DEFAULT_BUDGET;
+	m_totalBytes = 0;
+	m_numTextures = 0;
+	m_useCounter = 0;
+	m_numHits = m_numMisses = 0;
+}
+
+geTextureManager::~geTextureManager(void)
+{//Destructor
+	Destroy();
+}
+
+bool geTextureManager::Init(SDL_Renderer* pRenderer, const SIZE_T budgetBytes)
+{
+	Destroy();
+
+	GEE_ASSERT(pRenderer);
+	m_pRenderer = pRenderer;
+	m_budgetBytes = budgetBytes;
+	return true;
+}
+
+void geTextureManager::Destroy()
+{//Liberamos todas las texturas, los números de serie siguen creciendo para invalidar los handles vivos
+	m_loader.Stop();
+
+	for( SIZE_T i=0; i<m_entries.size(); ++i )
+	{
+		if( m_entries[i].pTexture != NULL )
+		{
+			if( m_entries[i].refCount > 0 )
+			{
+				GEE_WARNING( TEXT("geTextureManager::Destroy: La textura sigue en uso: ") + m_entries[i].key );
+			}
+			FreeEntry((int32)i);
+		}
+	}
+	m_lookup.clear();
+	m_totalBytes = 0;
+	m_numTextures = 0;
+	m_pRenderer = NULL;
+}
+
+geString geTextureManager::NormalizeKey(const geString& key)
+{//Las rutas se comparan sin importar mayúsculas ni el tipo de diagonal
+	geString normalized = key;
+	for( SIZE_T i=0; i<normalized.size(); ++i )
+	{
+		normalized[i] = (normalized[i] == TEXT('/')) ? TEXT('\\') : (TCHAR)_totlower(normalized[i]);
+	}
+	return normalized;
+}
+
+int32 geTextureManager::FindEntry(const geString& normalizedKey, const uint32 hash) const
+{
+	typedef std::multimap<uint32, int32>::const_iterator LookupIterator;
+	std::pair<LookupIterator, LookupIterator> range = m_lookup.equal_range(hash);
+	for( LookupIterator it=range.first; it!=range.second; ++it )
+	{
+		if( m_entries[it->second].key == normalizedKey )
+		{
+			return it->second;
+		}
+	}
+	return -1;
+}
+
+int32 geTextureManager::AddEntry(const geString& normalizedKey, const uint32 hash, geTexture* pTexture)
+{//Guarda una textura nueva en una entrada libre (sin referencias todavía)
+	int32 index;
+	if( !m_freeEntries.empty() )
+	{
+		index = m_freeEntries.back();
+		m_freeEntries.pop_back();
+	}
+	else
+	{
+		index = (int32)m_entries.size();
+		Entry empty;
+		empty.serial = 0;
+		empty.pTexture = NULL;
+		m_entries.push_back(empty);
+	}
+
+	Entry& entry = m_entries[index];
+	entry.key = normalizedKey;
+	entry.hash = hash;
+	++entry.serial;
+	entry.pTexture = pTexture;
+	entry.regions.clear();
+	entry.refCount = 0;
+	entry.bPending = false;
+	entry.lastUsed = m_useCounter;
+	entry.bytes = (SIZE_T)pTexture->GetWidth() * (SIZE_T)pTexture->GetHeight() * 4;
+
+	m_lookup.insert( std::make_pair(hash, index) );
+	m_totalBytes += entry.bytes;
+	++m_numTextures;
+	return index;
+}
+
+void geTextureManager::FreeEntry(const int32 index)
+{
+	Entry& entry = m_entries[index];
+	SAFE_DELETE(entry.pTexture);
+	entry.regions.clear();
+	++entry.serial;
+	entry.refCount = 0;
+	m_freeEntries.push_back(index);
+}
+
+void geTextureManager::RemoveEntry(const int32 index)
+{//Saca la entrada de la tabla de búsqueda y libera su textura
+	typedef std::multimap<uint32, int32>::iterator LookupIterator;
+	std::pair<LookupIterator, LookupIterator> range = m_lookup.equal_range(m_entries[index].hash);
+	for( LookupIterator it=range.first; it!=range.second; ++it )
+	{
+		if( it->second == index )
+		{
+			m_lookup.erase(it);
+			break;
+		}
+	}
+
+	m_totalBytes -= m_entries[index].bytes;
+	--m_numTextures;
+	FreeEntry(index);
+}
+
+geTextureHandle geTextureManager::MakeHandle(const int32 index)
+{//Cuenta la referencia y marca la entrada como recién usada
+	Entry& entry = m_entries[index];
+	++entry.refCount;
+	entry.lastUsed = ++m_useCounter;
+	return geTextureHandle(this, index);
+}
+
+geTextureHandle geTextureManager::Load(const geString& path)
+{//Regresa la textura del archivo, solo la carga si no está en el cache
+	geString key = NormalizeKey(path);
+	uint32 hash = (uint32)(SIZE_T)HashedString::hash_name(key.c_str());
+
+	int32 index = FindEntry(key, hash);
+	if( index >= 0 )
+	{
+		++m_numHits;
+		if( !m_entries[index].bPending )
+		{
+			return MakeHandle(index);
+		}
+
+		//Quien llama espera una textura lista, no podemos regresarle la entrada vacía de LoadAsync()
+		if( !FinishPending(index, path) )
+		{
+			return geTextureHandle();
+		}
+		geTextureHandle handle = MakeHandle(index);
+		Trim();
+		return handle;
+	}
+
+	GEE_ASSERT(m_pRenderer);
+	++m_numMisses;
+	geTexture* pTexture = GEE_NEW geTexture();
+	GEE_ASSERT(pTexture);
+	if( !pTexture->LoadFromFile(m_pRenderer, path) )
+	{
+		SAFE_DELETE(pTexture);
+		return geTextureHandle();
+	}
+
+	index = AddEntry(key, hash, pTexture);
+	geTextureHandle handle = MakeHandle(index);
+	Trim();
+	return handle;
+}
+
+geTextureHandle geTextureManager::LoadAsync(const geString& path)
+{//Regresa la textura del archivo, si no está en el cache la pide al hilo de carga
+	geString key = NormalizeKey(path);
+	uint32 hash = (uint32)(SIZE_T)HashedString::hash_name(key.c_str());
+
+	int32 index = FindEntry(key, hash);
+	if( index >= 0 )
+	{
+		++m_numHits;
+		return MakeHandle(index);
+	}
+
+	//Creamos la entrada con una textura vacía para que el handle sea válido desde ahora
+	GEE_ASSERT(m_pRenderer);
+	++m_numMisses;
+	geTexture* pTexture = GEE_NEW geTexture();
+	GEE_ASSERT(pTexture);
+	index = AddEntry(key, hash, pTexture);
+	m_entries[index].bPending = true;
+
+	m_loader.Request(index, m_entries[index].serial, path);
+	return MakeHandle(index);
+}
+
+bool geTextureManager::FinishPending(const int32 index, const geString& path)
+{//Cancelamos el pedido y cargamos el archivo aquí (si el hilo ya lo tomó, UpdateUploads() descarta su resultado porque la entrada ya no está pendiente)
+	m_loader.Cancel(index, m_entries[index].serial);
+
+	Entry& entry = m_entries[index];
+	entry.bPending = false;
+	if( !entry.pTexture->LoadFromFile(m_pRenderer, path) )
+	{
+		entry.key.clear();	//Igual que una carga asíncrona fallida, se libera cuando se suelte el último handle
+		if( entry.refCount == 0 )
+		{
+			RemoveEntry(index);
+		}
+		return false;
+	}
+
+	entry.bytes = (SIZE_T)entry.pTexture->GetWidth() * (SIZE_T)entry.pTexture->GetHeight() * 4;
+	m_totalBytes += entry.bytes;
+	return true;
+}
+
+int32 geTextureManager::UpdateUploads(const float budgetMs)
+{//Sube las imágenes decodificadas mientras haya tiempo
+	Uint64 startCounter = SDL_GetPerformanceCounter();
+	Uint64 budgetCounts = (Uint64)( (double)budgetMs * 0.001 * (double)SDL_GetPerformanceFrequency() );
+
+	int32 numUploaded = 0;
+	geTextureDecodeJob job;
+	while( m_loader.PopDecoded(job) )
+	{
+		//Si la entrada se desalojó o se recicló mientras se decodificaba, la imagen ya no sirve
+		const Entry* pEntry = getEntry(job.entry, job.serial);
+		if( pEntry == NULL || !pEntry->bPending )
+		{
+			if( job.pSurface != NULL )
+			{
+				SDL_FreeSurface(job.pSurface);
+			}
+			continue;
+		}
+
+		Entry& entry = m_entries[job.entry];
+		entry.bPending = false;
+		if( job.pSurface == NULL )
+		{
+			GEE_WARNING(TEXT("Falló al cargar la imagen: ") + job.path);
+			entry.key.clear();	//Nadie más puede pedirla, se libera cuando se suelte el último handle
+			if( entry.refCount == 0 )
+			{
+				RemoveEntry(job.entry);
+			}
+			continue;
+		}
+
+		if( !entry.pTexture->CreateFromSurface(m_pRenderer, job.pSurface) )
+		{
+			GEE_WARNING(TEXT("Falló al crear la textura: ") + job.path);
+		}
+		SDL_FreeSurface(job.pSurface);
+
+		entry.bytes = (SIZE_T)entry.pTexture->GetWidth() * (SIZE_T)entry.pTexture->GetHeight() * 4;
+		m_totalBytes += entry.bytes;
+		++numUploaded;
+
+		if( SDL_GetPerformanceCounter() - startCounter >= budgetCounts )
+		{//Se acabó el tiempo de este cuadro, lo demás espera al siguiente
+			break;
+		}
+	}
+
+	if( numUploaded > 0 )
+	{
+		Trim();
+	}
+	return numUploaded;
+}
+
+geTextureHandle geTextureManager::Find(const geString& key)
+{//Regresa una textura del cache sin cargar nada
+	geString normalizedKey = NormalizeKey(key);
+	int32 index = FindEntry(normalizedKey, (uint32)(SIZE_T)HashedString::hash_name(normalizedKey.c_str()));
+	if( index < 0 )
+	{
+		return geTextureHandle();
+	}
+
+	++m_numHits;
+	return MakeHandle(index);
+}
+
+geTextureHandle geTextureManager::Create(const geString& key, SDL_Surface* pSurface, const std::vector<SDL_Rect>* pRegions)
+{//Crea una textura a partir de pixeles y la guarda con la llave indicada
+	GEE_ASSERT(m_pRenderer && pSurface);
+	geString normalizedKey = NormalizeKey(key);
+	uint32 hash = (uint32)(SIZE_T)HashedString::hash_name(normalizedKey.c_str());
+
+	geTexture* pTexture = GEE_NEW geTexture();
+	GEE_ASSERT(pTexture);
+	if( !pTexture->CreateFromSurface(m_pRenderer, pSurface) )
+	{
+		GEE_WARNING( TEXT("Falló al crear la textura ") + key + TEXT("! SDL Error: ") + s2gs(SDL_GetError()) );
+		SAFE_DELETE(pTexture);
+		return geTextureHandle();
+	}
+
+	//Si ya existía una textura con esta llave la reemplazamos (los handles anteriores siguen apuntando a la vieja hasta que se suelten)
+	int32 oldIndex = FindEntry(normalizedKey, hash);
+	if( oldIndex >= 0 )
+	{
+		if( m_entries[oldIndex].refCount == 0 )
+		{
+			RemoveEntry(oldIndex);
+		}
+		else
+		{
+			m_entries[oldIndex].key.clear();
+		}
+	}
+
+	int32 index = AddEntry(normalizedKey, hash, pTexture);
+	if( pRegions != NULL )
+	{
+		m_entries[index].regions = *pRegions;
+	}
+	geTextureHandle handle = MakeHandle(index);
+	Trim();
+	return handle;
+}
+
+void geTextureManager::Trim()
+{//Desalojamos texturas sin referencias, la usada hace más tiempo primero
+	while( m_totalBytes > m_budgetBytes )
+	{
+		int32 oldest = -1;
+		for( SIZE_T i=0; i<m_entries.size(); ++i )
+		{
+			const Entry& entry = m_entries[i];
+			if( entry.pTexture != NULL && entry.refCount == 0 && (oldest < 0 || entry.lastUsed < m_entries[oldest].lastUsed) )
+			{
+				oldest = (int32)i;
+			}
+		}
+		if( oldest < 0 )
+		{//Todo lo que queda está en uso
+			break;
+		}
+
+		RemoveEntry(oldest);
+	}
+}
+
+void geTextureManager::AddRef(const int32 index, const uint32 serial)
+{
+	if( getEntry(index, serial) != NULL )
+	{
+		++m_entries[index].refCount;
+	}
+}
+
+void geTextureManager::ReleaseRef(const int32 index, const uint32 serial)
+{
+	if( getEntry(index, serial) == NULL )
+	{//La entrada ya fue liberada (ej. el cache se destruyó antes que el handle)
+		return;
+	}
+
+	Entry& entry = m_entries[index];
+	GEE_ASSERT(entry.refCount > 0);
+	if( --entry.refCount == 0 )
+	{
+		if( entry.key.empty() )
+		{//Fue reemplazada por Create(), ya nadie puede volver a pedirla
+			RemoveEntry(index);
+			return;
+		}
+		Trim();
+	}
+}
+
+const geTextureManager::Entry* geTextureManager::getEntry(const int32 index, const uint32 serial) const
+{
+	if( index < 0 || index >= (int32)m_entries.size() )
+	{
+		return NULL;
+	}
+	const Entry& entry = m_entries[index];
+	return (entry.pTexture != NULL && entry.serial == serial) ? &entry : NULL;
+}
@@ -0,0 +1,147 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geTextureManager.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de las clases geTextureManager y
+				geTextureHandle
+				Cache compartido de texturas indexado por el hash de la
+				ruta. Una ruta se carga una sola vez sin importar
+				cuántos objetos la pidan; cada objeto guarda un handle
+				con cuenta de referencias. Las texturas sin referencias
+				se quedan en el cache (así recrear un mapa o el GUI no
+				vuelve a cargar nada) hasta que el total rebasa el
+				presupuesto y se desalojan las usadas hace más tiempo.
+				Las cargas asíncronas decodifican en un hilo de trabajo
+				y se suben al renderer con un límite de tiempo por cuadro
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define TEXTURE_CACHE_DEFAULT_BUDGET	(128*1024*1024)		//Bytes de textura que puede mantener el cache (estimados a 4 bytes por pixel)
+#define TEXTURE_UPLOAD_DEFAULT_BUDGET_MS	2.0f			//Milisegundos por cuadro que se pueden usar para subir texturas decodificadas
+
+class geTextureManager;
+
+/************************************************************************************************************************/
+/* Declaración de la clase geTextureHandle                              												*/
+/************************************************************************************************************************/
+class geTextureHandle
+{
+	friend class geTextureManager;
+
+public:
+	geTextureHandle(void);
+	geTextureHandle(const geTextureHandle& other);
+	~geTextureHandle(void);
+	geTextureHandle& operator=(const geTextureHandle& other);
+
+	void Release();											//Suelta la referencia (la textura queda en el cache)
+	bool isValid() const;
+	bool isReady() const;									//La textura ya se subió al renderer (una carga asíncrona puede seguir pendiente)
+	bool isPending() const;									//La carga asíncrona aún no termina (si terminó y no está lista es que falló)
+	geTexture* get() const;									//Textura (NULL si el handle no es válido)
+	geTexture* operator->() const { return get(); }
+	const std::vector<SDL_Rect>& getRegions() const;		//Regiones guardadas junto con la textura (ej. las imágenes de un atlas)
+
+private:
+	geTextureHandle(geTextureManager* pManager, const int32 index);
+
+	geTextureManager *m_pManager;			//Cache dueño de la textura
+	int32 m_index;							//Entrada en el cache (-1 si no es válido)
+	uint32 m_serial;						//Número de serie de la entrada al crear el handle (evita usar una entrada reciclada)
+};
+
+/************************************************************************************************************************/
+/* Declaración de la clase geTextureManager                             												*/
+/************************************************************************************************************************/
+class geTextureManager : public GEE_noncopyable
+{
+	friend class geTextureHandle;
+
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geTextureManager(void);						//Constructor standard
+	~geTextureManager(void);					//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de inicialización                                          												*/
+	/************************************************************************************************************************/
+public:
+	bool Init(SDL_Renderer* pRenderer, const SIZE_T budgetBytes = TEXTURE_CACHE_DEFAULT_BUDGET);
+	void Destroy();								//Libera todas las texturas (los handles que sigan vivos se vuelven inválidos)
+
+	/************************************************************************************************************************/
+	/* Funciones para obtener texturas                                      												*/
+	/************************************************************************************************************************/
+public:
+	geTextureHandle Load(const geString& path);	//Regresa la textura del archivo, solo la carga si no está en el cache (si hay una carga asíncrona pendiente del mismo archivo la termina aquí, el handle siempre regresa listo)
+	geTextureHandle LoadAsync(const geString& path);	//Igual que Load() pero la decodificación se hace en un hilo de trabajo (el handle es válido pero no está listo hasta que se suba)
+	geTextureHandle Find(const geString& key);	//Regresa una textura del cache (handle inválido si no está)
+	geTextureHandle Create(const geString& key, SDL_Surface* pSurface, const std::vector<SDL_Rect>* pRegions = NULL);	//Crea una textura a partir de pixeles y la guarda con la llave indicada
+
+	/************************************************************************************************************************/
+	/* Funciones de control del presupuesto                                 												*/
+	/************************************************************************************************************************/
+public:
+	void setBudget(const SIZE_T budgetBytes) { m_budgetBytes = budgetBytes; Trim(); }
+	SIZE_T getBudget() const { return m_budgetBytes; }
+	SIZE_T getTotalBytes() const { return m_totalBytes; }
+	int32 getNumTextures() const { return m_numTextures; }
+	uint32 getNumHits() const { return m_numHits; }		//Pedidos resueltos sin cargar
+	uint32 getNumMisses() const { return m_numMisses; }	//Pedidos que tuvieron que cargar el archivo
+
+	void Trim();								//Desaloja texturas sin referencias, empezando por la usada hace más tiempo, hasta quedar dentro del presupuesto
+	int32 UpdateUploads(const float budgetMs = TEXTURE_UPLOAD_DEFAULT_BUDGET_MS);	//Sube las imágenes decodificadas hasta agotar el tiempo (al menos una por llamada), regresa cuántas subió
+	int32 getNumPendingLoads() const { return m_loader.getNumPending(); }
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	struct Entry
+	{
+		geString key;						//Llave normalizada (ruta en minúsculas con diagonales invertidas)
+		uint32 hash;						//Hash de la llave
+		uint32 serial;						//Cambia cada vez que la entrada se recicla
+		geTexture *pTexture;				//Textura (NULL si la entrada está libre)
+		std::vector<SDL_Rect> regions;		//Regiones opcionales dentro de la textura
+		int32 refCount;						//Handles vivos
+		bool bPending;						//Espera su imagen del hilo de carga
+		uint32 lastUsed;					//Marca del último pedido (para desalojar la usada hace más tiempo)
+		SIZE_T bytes;						//Memoria estimada de la textura
+	};
+
+	static geString NormalizeKey(const geString& key);
+	int32 FindEntry(const geString& normalizedKey, const uint32 hash) const;
+	int32 AddEntry(const geString& normalizedKey, const uint32 hash, geTexture* pTexture);
+	void FreeEntry(const int32 index);
+	void RemoveEntry(const int32 index);		//Saca la entrada de la tabla de búsqueda, descuenta su memoria y la libera
+	geTextureHandle MakeHandle(const int32 index);
+	bool FinishPending(const int32 index, const geString& path);	//Carga en este momento una entrada que espera al hilo de carga, regresa false si falló (la entrada ya no puede pedirse)
+
+	void AddRef(const int32 index, const uint32 serial);
+	void ReleaseRef(const int32 index, const uint32 serial);
+	const Entry* getEntry(const int32 index, const uint32 serial) const;
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	SDL_Renderer *m_pRenderer;					//Renderer con el que se crean las texturas
+	geTextureLoader m_loader;					//Hilo que decodifica las cargas asíncronas
+	std::vector<Entry> m_entries;				//Entradas del cache
+	std::vector<int32> m_freeEntries;			//Entradas libres para reutilizar
+	std::multimap<uint32, int32> m_lookup;		//Entradas por hash de su llave (puede haber colisiones, se compara la llave)
+	SIZE_T m_budgetBytes;						//Presupuesto de memoria
+	SIZE_T m_totalBytes;						//Memoria de todas las texturas del cache
+	int32 m_numTextures;						//Texturas en el cache
+	uint32 m_useCounter;						//Contador de pedidos (marca de tiempo para el LRU)
+	uint32 m_numHits, m_numMisses;				//Estadísticas
+};
+
+extern geTextureManager g_TextureManager;		//Cache de texturas de la aplicación (se inicializa con el renderer principal)
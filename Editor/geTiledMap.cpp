@@ -11,6 +11,163 @@
 /************************************************************************************************************************/
 #include "stdafx.h"
 #include "geTiledMap.h"
+#include <intrin.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+
+/************************************************************************************************************************/
+/* Funciones de ayuda                                                   												*/
+/************************************************************************************************************************/
+static geString GetTerrainTextureName(const uint8 idtype)
+{//Ruta de la imagen de un tipo de terreno
+#ifdef MAP_IS_ISOMETRIC	//El mapa está en modo isométrico, todos los tipos usan la misma imagen
+	(void*)&idtype;
+	return TEXT("Textures\\Terrain\\iso_terrain_")+ ToStr(0) +TEXT(".png");
+#else	//Estamos utilizando el sistema de mapa cuadrado
+	return TEXT("Textures\\Terrain\\terrain_")+ ToStr(idtype) +TEXT(".png");
+#endif
+}
+
+/************************************************************************************************************************/
+/* Conversiones de coordenadas en lote                                  												*/
+/************************************************************************************************************************/
+static bool CPUHasAVX2()
+{//Revisa una sola vez si el procesador y el sistema operativo soportan AVX2
+	static int32 s_hasAVX2 = -1;
+	if( s_hasAVX2 < 0 )
+	{
+		int32 info[4];
+		__cpuid(info, 0);
+		s_hasAVX2 = 0;
+		if( info[0] >= 7 )
+		{
+			__cpuid(info, 1);
+			bool bOSXSave = (info[2] & (1<<27)) != 0;
+			bool bAVX = (info[2] & (1<<28)) != 0;
+			if( bOSXSave && bAVX && (_xgetbv(0) & 6) == 6 )
+			{//El sistema operativo guarda los registros YMM
+				__cpuidex(info, 7, 0);
+				s_hasAVX2 = (info[1] & (1<<5)) ? 1 : 0;
+			}
+		}
+	}
+	return s_hasAVX2 != 0;
+}
+
+static FORCEINLINE __m128i ClampSSE2(const __m128i v, const __m128i vMin, const __m128i vMax)
+{//Equivalente a Max(vMin, Min(v, vMax)) con instrucciones de SSE2
+	__m128i vGreater = _mm_cmpgt_epi32(v, vMax);
+	__m128i vResult = _mm_or_si128( _mm_and_si128(vGreater, vMax), _mm_andnot_si128(vGreater, v) );
+	__m128i vLess = _mm_cmplt_epi32(vResult, vMin);
+	return _mm_or_si128( _mm_and_si128(vLess, vMin), _mm_andnot_si128(vLess, vResult) );
+}
+
+static int32 ScreenToMapSSE2(const int32* pScrX, const int32* pScrY, int32* pMapX, int32* pMapY, const int32 count, const int32 defaceX, const int32 defaceY, const int32 maxX, const int32 maxY)
+{//Convierte grupos de 4 puntos, regresa cuántos puntos procesó
+	const __m128i vDefaceX = _mm_set1_epi32(defaceX), vDefaceY = _mm_set1_epi32(defaceY);
+	const __m128i vZero = _mm_setzero_si128();
+	const __m128i vMaxX = _mm_set1_epi32(maxX), vMaxY = _mm_set1_epi32(maxY);
+#ifdef MAP_IS_ISOMETRIC
+	//Multiplicar por el inverso de una potencia de 2 da exactamente lo mismo que la división de la versión de un punto
+	const __m128 vInvHalfX = _mm_set1_ps(1.0f/TILEHALFSIZE_X), vInvHalfY = _mm_set1_ps(1.0f/TILEHALFSIZE_Y);
+	const __m128 vOne = _mm_set1_ps(1.0f);
+#endif
+
+	int32 i = 0;
+	for( ; i+4<=count; i+=4 )
+	{
+		__m128i vX = _mm_sub_epi32( _mm_loadu_si128((const __m128i*)&pScrX[i]), vDefaceX );
+		__m128i vY = _mm_sub_epi32( _mm_loadu_si128((const __m128i*)&pScrY[i]), vDefaceY );
+#ifdef MAP_IS_ISOMETRIC
+		__m128 vfX = _mm_sub_ps( _mm_mul_ps(_mm_cvtepi32_ps(vX), vInvHalfX), vOne );
+		__m128 vfY = _mm_mul_ps( _mm_cvtepi32_ps(vY), vInvHalfY );
+		__m128i vMapX = _mm_srai_epi32( _mm_cvttps_epi32(_mm_add_ps(vfX, vfY)), 1 );
+		__m128i vMapY = _mm_srai_epi32( _mm_cvttps_epi32(_mm_sub_ps(vfY, vfX)), 1 );
+#else
+		__m128i vMapX = _mm_srai_epi32(vX, BITSFT_TILESIZE_X);
+		__m128i vMapY = _mm_srai_epi32(vY, BITSFT_TILESIZE_Y);
+#endif
+		_mm_storeu_si128( (__m128i*)&pMapX[i], ClampSSE2(vMapX, vZero, vMaxX) );
+		_mm_storeu_si128( (__m128i*)&pMapY[i], ClampSSE2(vMapY, vZero, vMaxY) );
+	}
+	return i;
+}
+
+static int32 ScreenToMapAVX2(const int32* pScrX, const int32* pScrY, int32* pMapX, int32* pMapY, const int32 count, const int32 defaceX, const int32 defaceY, const int32 maxX, const int32 maxY)
+{//Convierte grupos de 8 puntos, regresa cuántos puntos procesó
+	const __m256i vDefaceX = _mm256_set1_epi32(defaceX), vDefaceY = _mm256_set1_epi32(defaceY);
+	const __m256i vZero = _mm256_setzero_si256();
+	const __m256i vMaxX = _mm256_set1_epi32(maxX), vMaxY = _mm256_set1_epi32(maxY);
+#ifdef MAP_IS_ISOMETRIC
+	const __m256 vInvHalfX = _mm256_set1_ps(1.0f/TILEHALFSIZE_X), vInvHalfY = _mm256_set1_ps(1.0f/TILEHALFSIZE_Y);
+	const __m256 vOne = _mm256_set1_ps(1.0f);
+#endif
+
+	int32 i = 0;
+	for( ; i+8<=count; i+=8 )
+	{
+		__m256i vX = _mm256_sub_epi32( _mm256_loadu_si256((const __m256i*)&pScrX[i]), vDefaceX );
+		__m256i vY = _mm256_sub_epi32( _mm256_loadu_si256((const __m256i*)&pScrY[i]), vDefaceY );
+#ifdef MAP_IS_ISOMETRIC
+		__m256 vfX = _mm256_sub_ps( _mm256_mul_ps(_mm256_cvtepi32_ps(vX), vInvHalfX), vOne );
+		__m256 vfY = _mm256_mul_ps( _mm256_cvtepi32_ps(vY), vInvHalfY );
+		__m256i vMapX = _mm256_srai_epi32( _mm256_cvttps_epi32(_mm256_add_ps(vfX, vfY)), 1 );
+		__m256i vMapY = _mm256_srai_epi32( _mm256_cvttps_epi32(_mm256_sub_ps(vfY, vfX)), 1 );
+#else
+		__m256i vMapX = _mm256_srai_epi32(vX, BITSFT_TILESIZE_X);
+		__m256i vMapY = _mm256_srai_epi32(vY, BITSFT_TILESIZE_Y);
+#endif
+		_mm256_storeu_si256( (__m256i*)&pMapX[i], _mm256_max_epi32(vZero, _mm256_min_epi32(vMapX, vMaxX)) );
+		_mm256_storeu_si256( (__m256i*)&pMapY[i], _mm256_max_epi32(vZero, _mm256_min_epi32(vMapY, vMaxY)) );
+	}
+	_mm256_zeroupper();
+	return i;
+}
+
+static int32 MapToScreenSSE2(const int32* pMapX, const int32* pMapY, int32* pScrX, int32* pScrY, const int32 count, const int32 defaceX, const int32 defaceY)
+{//Convierte grupos de 4 puntos, regresa cuántos puntos procesó
+	const __m128i vDefaceX = _mm_set1_epi32(defaceX), vDefaceY = _mm_set1_epi32(defaceY);
+
+	int32 i = 0;
+	for( ; i+4<=count; i+=4 )
+	{
+		__m128i vX = _mm_loadu_si128((const __m128i*)&pMapX[i]);
+		__m128i vY = _mm_loadu_si128((const __m128i*)&pMapY[i]);
+#ifdef MAP_IS_ISOMETRIC
+		__m128i vScrX = _mm_slli_epi32( _mm_sub_epi32(vX, vY), BITSFT_TILEHALFSIZE_X );
+		__m128i vScrY = _mm_slli_epi32( _mm_add_epi32(vX, vY), BITSFT_TILEHALFSIZE_Y );
+#else
+		__m128i vScrX = _mm_slli_epi32(vX, BITSFT_TILESIZE_X);
+		__m128i vScrY = _mm_slli_epi32(vY, BITSFT_TILESIZE_Y);
+#endif
+		_mm_storeu_si128( (__m128i*)&pScrX[i], _mm_add_epi32(vScrX, vDefaceX) );
+		_mm_storeu_si128( (__m128i*)&pScrY[i], _mm_add_epi32(vScrY, vDefaceY) );
+	}
+	return i;
+}
+
+static int32 MapToScreenAVX2(const int32* pMapX, const int32* pMapY, int32* pScrX, int32* pScrY, const int32 count, const int32 defaceX, const int32 defaceY)
+{//Convierte grupos de 8 puntos, regresa cuántos puntos procesó
+	const __m256i vDefaceX = _mm256_set1_epi32(defaceX), vDefaceY = _mm256_set1_epi32(defaceY);
+
+	int32 i = 0;
+	for( ; i+8<=count; i+=8 )
+	{
+		__m256i vX = _mm256_loadu_si256((const __m256i*)&pMapX[i]);
+		__m256i vY = _mm256_loadu_si256((const __m256i*)&pMapY[i]);
+#ifdef MAP_IS_ISOMETRIC
+		__m256i vScrX = _mm256_slli_epi32( _mm256_sub_epi32(vX, vY), BITSFT_TILEHALFSIZE_X );
+		__m256i vScrY = _mm256_slli_epi32( _mm256_add_epi32(vX, vY), BITSFT_TILEHALFSIZE_Y );
+#else
+		__m256i vScrX = _mm256_slli_epi32(vX, BITSFT_TILESIZE_X);
+		__m256i vScrY = _mm256_slli_epi32(vY, BITSFT_TILESIZE_Y);
+#endif
+		_mm256_storeu_si256( (__m256i*)&pScrX[i], _mm256_add_epi32(vScrX, vDefaceX) );
+		_mm256_storeu_si256( (__m256i*)&pScrY[i], _mm256_add_epi32(vScrY, vDefaceY) );
+	}
+	_mm256_zeroupper();
+	return i;
+}
 
 /************************************************************************************************************************/
 /* Implementación de funciones de la clase geTiledMap                              										*/
@@ -18,8 +175,23 @@
 geTiledMap::geTiledMap(void)
 {//Constructor Standard
 	//Limpiamos las variables miembro
-	m_mapGrid = NULL;
-	m_mapSize = 0;
+	m_typePlane = NULL;
+	m_costOverrideBits = NULL;
+	m_clearancePlanes = NULL;
+	m_passabilityPlanes = NULL;
+	m_passabilityRowWords = 0;
+	m_mapWidth = m_mapHeight = 0;
+	m_strideShift = 0;
+	m_strideMask = 0;
+	m_chunkReady = NULL;
+	m_numChunksReady = 0;
+	m_numChunksX = m_numChunksY = 0;
+	m_numChunksJournaled = 0;
+	m_version = 0;
+	m_chunkVersion = NULL;
+	m_journalCount = 0;
+	m_journalBaseVersion = 0;
+	m_pendingDerived = geMapRegion();
 	m_startX = m_startY = 0;
 	m_endX = m_endY = 0;
 	m_iCameraX = m_iCameraY = 0;
@@ -27,16 +199,41 @@ geTiledMap::geTiledMap(void)
 
 	//Aún no creamos ninguna textura para el mapa
 	m_pRenderer = NULL;
-	m_mapTextures = NULL;
 	m_bShowGrid = false;
+
+	memset(m_costVersion, 0, sizeof(m_costVersion));
+	setDefaultTerrainCosts();
 }
 
-geTiledMap::geTiledMap(SDL_Renderer* pRenderer, const int32 mapSize)
+geTiledMap::geTiledMap(SDL_Renderer* pRenderer, const int32 mapWidth, const int32 mapHeight)
 {
-	m_mapGrid = NULL;
-	m_mapTextures = NULL;
+	m_typePlane = NULL;
+	m_costOverrideBits = NULL;
+	m_clearancePlanes = NULL;
+	m_passabilityPlanes = NULL;
+	m_passabilityRowWords = 0;
+	m_mapWidth = m_mapHeight = 0;
+	m_strideShift = 0;
+	m_strideMask = 0;
+	m_chunkReady = NULL;
+	m_numChunksReady = 0;
+	m_numChunksX = m_numChunksY = 0;
+	m_numChunksJournaled = 0;
+	m_version = 0;
+	m_chunkVersion = NULL;
+	m_journalCount = 0;
+	m_journalBaseVersion = 0;
+	m_pendingDerived = geMapRegion();
+	m_startX = m_startY = 0;
+	m_endX = m_endY = 0;
+	m_iCameraX = m_iCameraY = 0;
+	m_fCameraX = m_fCameraY = 0.f;
+	m_pRenderer = NULL;
+	m_bShowGrid = false;
+	memset(m_costVersion, 0, sizeof(m_costVersion));
+	setDefaultTerrainCosts();
 
-	Init(pRenderer, mapSize);
+	Init(pRenderer, mapWidth, mapHeight);
 }
 
 geTiledMap::~geTiledMap(void)
@@ -48,88 +245,142 @@ geTiledMap::~geTiledMap(void)
 /* Esta función aloja la memoria necesaria para el mapa y carga las texturas para el render								*/
 /*																														*/
 /* Parametros:																											*/
-/*     mapSize: Indica el tamaño del mapa (se creará un mapa cuadrado e.j. maxSize*maxSize )							*/
+/*     mapWidth: Indica el ancho del mapa en tiles																		*/
+/*     mapHeight: Indica el alto del mapa en tiles																		*/
 /************************************************************************************************************************/
-bool geTiledMap::Init(SDL_Renderer* pRenderer, const int32 mapSize)
+bool geTiledMap::Init(SDL_Renderer* pRenderer, const int32 mapWidth, const int32 mapHeight)
 {
 	//Revisamos que esta función pueda ser llamada
-	if( m_mapGrid != NULL )
+	if( m_typePlane != NULL )
 	{//Este mapa ya fue creado anteriormente, destruimos los datos actuales y reinicializamos
 		Destroy();
 	}
 
-	//Variables temporales
-	geString textureName;	//Temporal útilizada para indicar nombres de texturas
-
-	//Copiamos localmente el puntero del renderer
-	GEE_ASSERT(pRenderer);
+	//Copiamos localmente el puntero del renderer (sin renderer solo se crean los datos del mapa, ej. en las pruebas)
 	m_pRenderer = pRenderer;
 
-	//Creamos el grid del mapa según el tamaño indicado
-	//Lo creamos como una matriz accesible en dos dimensiones PERO EVITAMOS CREARLA COMO UNA MATRIZ DE DOS DIMENSIONES
-	m_mapGrid = GEE_NEW MapTile*[mapSize];
-	GEE_ASSERT(m_mapGrid);
+	GEE_ASSERT( mapWidth > 0 && mapHeight > 0 );
 
-	for( int32 i=0 ; i<mapSize; ++i )
+	//Copiamos localmente el tamaño del mapa para futuras referencias
+	m_mapWidth = mapWidth;
+	m_mapHeight = mapHeight;
+
+	//Las filas de los planos se alojan con una longitud potencia de 2 (solo se rellena el ancho, así los mapas largos y delgados no se rellenan a un cuadrado)
+	m_strideShift = (int32)CeilLogTwo( (uint32)mapWidth );
+	m_strideMask = (1<<m_strideShift)-1;
+	int32 numTiles = mapHeight<<m_strideShift;
+
+	//Creamos los planos del mapa, cada uno es un solo bloque contiguo de memoria
+	m_typePlane = GEE_NEW uint8[numTiles];
+	GEE_ASSERT(m_typePlane);
+	m_costOverrideBits = GEE_NEW uint64[(numTiles+63)>>6];
+	GEE_ASSERT(m_costOverrideBits);
+	m_clearancePlanes = GEE_NEW uint8[MC_NUM_CLASSES*numTiles];
+	GEE_ASSERT(m_clearancePlanes);
+	m_passabilityRowWords = (mapWidth+63)>>6;
+	m_passabilityPlanes = GEE_NEW uint64[MC_NUM_CLASSES*mapHeight*m_passabilityRowWords];
+	GEE_ASSERT(m_passabilityPlanes);
+	memset(m_passabilityPlanes, 0, MC_NUM_CLASSES*mapHeight*m_passabilityRowWords*sizeof(uint64));
+
+	//Inicializamos todos los tiles como caminables y sin costos especiales
+	memset(m_typePlane, TT_WALKABLE, numTiles);
+	memset(m_costOverrideBits, 0, ((numTiles+63)>>6)*sizeof(uint64));
+	m_costOverrides.clear();
+
+	//Creamos las banderas de disponibilidad de los chunks (un mapa recién creado está disponible completo)
+	m_numChunksX = (mapWidth+MAP_CHUNK_MASK)>>MAP_CHUNK_BITS;
+	m_numChunksY = (mapHeight+MAP_CHUNK_MASK)>>MAP_CHUNK_BITS;
+	m_chunkReady = GEE_NEW LONG[m_numChunksX*m_numChunksY];
+	GEE_ASSERT(m_chunkReady);
+	setAllChunksReady(true);
+
+	//Reiniciamos el journal de cambios, la versión del mapa sigue creciendo para que ningún consumidor confunda este mapa con el anterior
+	m_chunkVersion = GEE_NEW uint32[m_numChunksX*m_numChunksY];
+	GEE_ASSERT(m_chunkVersion);
+	++m_version;
+	m_journalCount = 0;
+	m_journalBaseVersion = m_version;	//Los consumidores con una versión anterior deben reconstruir todo
+	for( int32 i=0; i<m_numChunksX*m_numChunksY; ++i )
 	{
-		m_mapGrid[i] = NULL;
-		m_mapGrid[i] = GEE_NEW MapTile[mapSize];
-		GEE_ASSERT(m_mapGrid[i]);
+		m_chunkVersion[i] = m_version;
 	}
 
-	//Copiamos localmente el tamaño del mapa para futuras referencias
-	m_mapSize = mapSize;
+	//Calculamos los datos derivados del mapa completo
+	m_pendingDerived = geMapRegion();
+	UpdateDerivedPlanes( geMapRegion(0, 0, m_mapWidth-1, m_mapHeight-1) );
 
 	//Establecemos posiciones seguras para la cámara
 	setCameraStartPosition(0, 0);
 
-	//Aquí cargamos las texturas necesarias para renderear el mapa
-	m_mapTextures = NULL;
-
-	//Primero alojamos memoria para los objetos
-	m_mapTextures = GEE_NEW geTexture[TT_NUM_OBJECTS];
-	GEE_ASSERT(m_mapTextures);
+	if( m_pRenderer == NULL )
+	{//Un mapa sin renderer no puede imprimirse, no necesitamos texturas
+		return true;
+	}
 
-#ifdef MAP_IS_ISOMETRIC	//El mapa está en modo isométrico
-	//Cargamos las imágenes de sus archivos respectivos
+	//Las imágenes del terreno se decodifican en un hilo de trabajo, mientras tanto todos los tipos se imprimen con la textura provisional
+	CreatePlaceholderTexture();
 	for( uint8 i=0; i<TT_NUM_OBJECTS; ++i )
 	{
-		textureName = TEXT("Textures\\Terrain\\iso_terrain_")+ ToStr(0) +TEXT(".png");
-		m_mapTextures[i].LoadFromFile(m_pRenderer, textureName);
+		m_mapTextures[i] = m_placeholderTexture;
 	}
-#else	//Estamos utilizando el sistema de mapa cuadrado
-	//Cargamos las imágenes de sus archivos respectivos
+
+	//Empacamos las imágenes en un atlas para imprimir el terreno sin cambiar de textura (si no se puede, UpdateTerrainTextures() pide una textura por tipo)
+	geString textureNames[TT_NUM_OBJECTS];
 	for( uint8 i=0; i<TT_NUM_OBJECTS; ++i )
 	{
-		textureName = TEXT("Textures\\Terrain\\terrain_")+ ToStr(i) +TEXT(".png");
-		m_mapTextures[i].LoadFromFile(m_pRenderer, textureName);
+		textureNames[i] = GetTerrainTextureName(i);
 	}
-#endif
+	m_terrainAtlas.Init(m_pRenderer, textureNames, TT_NUM_OBJECTS);
 
 	//Hacemos los precálculos necesarios según los cambios en los datos
 	PreCalc();
 
+	//Preparamos el cache de chunks con las texturas recién cargadas
+	m_chunkCache.Init(m_pRenderer, this);
+
 	return true;
 }
 
 void geTiledMap::Destroy()
 {
-	//Revisamos si ya se creó un mapa
-	if(m_mapGrid != NULL)
-	{//Fue creado y necesitamos destruirlo
-		for(int32 i = 0; i < m_mapSize; i++)
-		{
-			SAFE_DELETE_ARRAY( m_mapGrid[i] );
-		}
-
-		SAFE_DELETE_ARRAY( m_mapGrid );
+	//Destruimos los planos del mapa
+	SAFE_DELETE_ARRAY( m_typePlane );
+	SAFE_DELETE_ARRAY( m_costOverrideBits );
+	m_costOverrides.clear();
+	SAFE_DELETE_ARRAY( m_clearancePlanes );
+	SAFE_DELETE_ARRAY( m_passabilityPlanes );
+	m_passabilityRowWords = 0;
+
+	//Destruimos las banderas de los chunks
+	if( m_chunkReady != NULL )
+	{
+		GEE_DELETE_ARRAY m_chunkReady;
+		m_chunkReady = NULL;
 	}
-
-	//Destruimos las texturas del mapa
-	SAFE_DELETE_ARRAY( m_mapTextures );
+	m_numChunksReady = 0;
+	m_numChunksJournaled = 0;
+	m_numChunksX = m_numChunksY = 0;
+
+	//Destruimos las versiones de los chunks y vaciamos el journal (m_version no se reinicia para que siga siendo monotónica)
+	SAFE_DELETE_ARRAY( m_chunkVersion );
+	m_journalCount = 0;
+	m_journalBaseVersion = m_version;
+	m_pendingDerived = geMapRegion();
+
+	//Destruimos las texturas del mapa y del cache de chunks
+	m_chunkCache.Destroy();
+	m_terrainAtlas.Destroy();
+	for( uint8 i=0; i<TT_NUM_OBJECTS; ++i )
+	{
+		m_mapTextures[i].Release();
+		m_pendingTextures[i].Release();
+	}
+	m_placeholderTexture.Release();
 
 	//Limpiamos las otras variables miembro de la clase
-	m_mapSize = 0;
+	m_mapWidth = m_mapHeight = 0;
+	m_strideShift = 0;
+	m_strideMask = 0;
 	setCameraStartPosition(0, 0);
 	PreCalc();	//Rehacemos precálculos para evitar utilizar datos inválidos
 
@@ -137,28 +388,581 @@ void geTiledMap::Destroy()
 	m_bShowGrid = false;
 }
 
-int8 geTiledMap::getCost (const int32 x, const int32 y) const
+int8 geTiledMap::getCost (const int32 x, const int32 y, const eMovementClass mc) const
 {
-	GEE_ASSERT( (x>=0) && (x<m_mapSize) && (y>=0) && (y<m_mapSize) );
-	return m_mapGrid[x][y].getCost();
+	GEE_ASSERT( isInside(x, y) );
+	if( hasCostOverride(x, y) )
+	{//Este tile tiene un costo especial
+		return m_costOverrides.find( getTileIndex(x, y) )->second;
+	}
+
+	return m_terrainCost[mc][m_typePlane[getTileIndex(x, y)]];
 }
 
 void geTiledMap::setCost(const int32 x, const int32 y, const int8 cost)
 {
-	GEE_ASSERT( (x>=0) && (x<m_mapSize) && (y>=0) && (y<m_mapSize) );
-	m_mapGrid[x][y].setCost(cost);
+	GEE_ASSERT( isInside(x, y) );
+	if( !isEditable() )
+	{//El hilo de carga sigue escribiendo los tiles
+		return;
+	}
+	if( getCostOverride(x, y) != cost )
+	{//Solo registramos el cambio si realmente modifica el mapa
+		setCostOverride(getTileIndex(x, y), cost);
+		markDirty( geMapRegion(x, y, x, y) );
+	}
+}
+
+int8 geTiledMap::getCostOverride(const int32 x, const int32 y) const
+{
+	GEE_ASSERT( isInside(x, y) );
+	return hasCostOverride(x, y) ? m_costOverrides.find( getTileIndex(x, y) )->second : (int8)MAP_COST_NO_OVERRIDE;
+}
+
+void geTiledMap::setCostOverride(const int32 index, const int8 cost)
+{//Escribe o borra el costo especial de un tile
+	uint64 bit = (uint64)1 << (index&63);
+	if( cost == MAP_COST_NO_OVERRIDE )
+	{
+		if( m_costOverrideBits[index>>6] & bit )
+		{
+			m_costOverrideBits[index>>6] &= ~bit;
+			m_costOverrides.erase(index);
+		}
+	}
+	else
+	{
+		m_costOverrideBits[index>>6] |= bit;
+		m_costOverrides[index] = cost;
+	}
+}
+
+void geTiledMap::ReadCostOverrides(const int32 x, const int32 y, const int32 count, int8* pCosts) const
+{//Copia los costos especiales de un tramo de fila
+	GEE_ASSERT( isInside(x, y) && isInside(x+count-1, y) );
+	memset(pCosts, MAP_COST_NO_OVERRIDE, count);
+
+	int32 index = getTileIndex(x, y);
+	int32 i = 0;
+	while( i < count )
+	{
+		uint64 word = m_costOverrideBits[(index+i)>>6];
+		if( word == 0 )
+		{//Saltamos de una vez los 64 tiles de esta palabra (o lo que queda de ella)
+			i += 64 - ((index+i)&63);
+			continue;
+		}
+
+		if( (word >> ((index+i)&63)) & 1 )
+		{
+			pCosts[i] = m_costOverrides.find(index+i)->second;
+		}
+		++i;
+	}
+}
+
+void geTiledMap::setTerrainCost(const eMovementClass mc, const uint8 idtype, const int8 cost)
+{//Cambia el costo de un terreno para todo el mapa
+	GEE_ASSERT( mc < MC_NUM_CLASSES && idtype < TT_NUM_OBJECTS );
+	if( m_terrainCost[mc][idtype] != cost )
+	{
+		bool bPassabilityChanged = (m_terrainCost[mc][idtype] == MAP_COST_IMPASSABLE) != (cost == MAP_COST_IMPASSABLE);
+		m_terrainCost[mc][idtype] = cost;
+		++m_costVersion[mc];
+
+		//Los tipos de terreno no cambiaron, así que no se registra nada en el journal; solo se recalculan los planos derivados de esta clase
+		if( m_typePlane != NULL && bPassabilityChanged )
+		{
+			if( isFullyLoaded() )
+			{
+				geMapRegion fullMap(0, 0, m_mapWidth-1, m_mapHeight-1);
+				UpdatePassability(mc, fullMap);
+				UpdateClearance(mc, fullMap);
+			}
+			else
+			{//Solo leemos los chunks que el hilo de carga ya publicó, los demás se calculan cuando se registren en el journal
+				for( int32 i=0; i<m_numChunksX*m_numChunksY; ++i )
+				{
+					if( m_chunkReady[i] != 0 )
+					{
+						int32 iniX = (i%m_numChunksX)<<MAP_CHUNK_BITS;
+						int32 iniY = (i/m_numChunksX)<<MAP_CHUNK_BITS;
+						geMapRegion chunk(iniX, iniY, iniX+MAP_CHUNK_MASK, iniY+MAP_CHUNK_MASK);
+						chunk.Clip(m_mapWidth, m_mapHeight);
+						UpdatePassability(mc, chunk);
+						UpdateClearance(mc, chunk);
+					}
+				}
+			}
+		}
+	}
+}
+
+void geTiledMap::setDefaultTerrainCosts()
+{//Establece la tabla de costos por default
+	//Infantería: no puede entrar al agua, el pantano la hace más lenta
+	m_terrainCost[MC_INFANTRY][TT_WATER] = MAP_COST_IMPASSABLE;
+	m_terrainCost[MC_INFANTRY][TT_WALKABLE] = 1;
+	m_terrainCost[MC_INFANTRY][TT_MARSH] = 2;
+	m_terrainCost[MC_INFANTRY][TT_OBSTACLE] = MAP_COST_IMPASSABLE;
+
+	//Vehículos: igual que la infantería pero el pantano les cuesta mucho más
+	m_terrainCost[MC_VEHICLE][TT_WATER] = MAP_COST_IMPASSABLE;
+	m_terrainCost[MC_VEHICLE][TT_WALKABLE] = 1;
+	m_terrainCost[MC_VEHICLE][TT_MARSH] = 4;
+	m_terrainCost[MC_VEHICLE][TT_OBSTACLE] = MAP_COST_IMPASSABLE;
+
+	//Hover (anfibio): pasa por agua y pantano sin penalización
+	m_terrainCost[MC_HOVER][TT_WATER] = 1;
+	m_terrainCost[MC_HOVER][TT_WALKABLE] = 1;
+	m_terrainCost[MC_HOVER][TT_MARSH] = 1;
+	m_terrainCost[MC_HOVER][TT_OBSTACLE] = MAP_COST_IMPASSABLE;
+
+	//Naval: solo puede moverse por agua
+	m_terrainCost[MC_NAVAL][TT_WATER] = 1;
+	m_terrainCost[MC_NAVAL][TT_WALKABLE] = MAP_COST_IMPASSABLE;
+	m_terrainCost[MC_NAVAL][TT_MARSH] = MAP_COST_IMPASSABLE;
+	m_terrainCost[MC_NAVAL][TT_OBSTACLE] = MAP_COST_IMPASSABLE;
 }
 
 int8 geTiledMap::getType(const int32 x, const int32 y) const
 {
-	GEE_ASSERT( (x>=0) && (x<m_mapSize) && (y>=0) && (y<m_mapSize) );
-	return m_mapGrid[x][y].getType();
+	GEE_ASSERT( isInside(x, y) );
+	return m_typePlane[getTileIndex(x, y)];
 }
 
 void geTiledMap::setType(const int32 x, const int32 y, const uint8 idtype)
 {
-	GEE_ASSERT( (x>=0) && (x<m_mapSize) && (y>=0) && (y<m_mapSize) );
-	m_mapGrid[x][y].setType(idtype);
+	GEE_ASSERT( isInside(x, y) );
+	GEE_ASSERT( idtype < TT_NUM_OBJECTS );
+	if( !isEditable() )
+	{//El hilo de carga sigue escribiendo los tiles
+		return;
+	}
+	int32 index = getTileIndex(x, y);
+	uint8 validType = ValidateType(idtype);
+	if( m_typePlane[index] != validType )
+	{//Solo registramos el cambio si realmente modifica el mapa
+		m_typePlane[index] = validType;
+		markDirty( geMapRegion(x, y, x, y) );
+	}
+}
+
+/************************************************************************************************************************/
+/* Funciones de edición en bloque																						*/
+/************************************************************************************************************************/
+void geTiledMap::FillRect(const geMapRegion& region, const uint8 idtype)
+{//Establece el tipo de terreno de todos los tiles de la región
+	GEE_ASSERT( idtype < TT_NUM_OBJECTS );
+	if( !isEditable() )
+	{//El hilo de carga sigue escribiendo los tiles
+		return;
+	}
+	geMapRegion clipped = region;
+	clipped.Clip(m_mapWidth, m_mapHeight);
+	if( clipped.isEmpty() )
+	{
+		return;
+	}
+
+	//Las filas son contiguas en memoria, así que cada una se llena con un solo memset
+	int32 width = clipped.getWidth();
+	for( int32 tmpY=clipped.minY; tmpY<=clipped.maxY; ++tmpY )
+	{
+		memset(&m_typePlane[getTileIndex(clipped.minX, tmpY)], ValidateType(idtype), width);
+	}
+
+	markDirty(clipped);
+}
+
+void geTiledMap::FillCostRect(const geMapRegion& region, const int8 cost)
+{//Establece el costo de todos los tiles de la región
+	if( !isEditable() )
+	{//El hilo de carga sigue escribiendo los tiles
+		return;
+	}
+	geMapRegion clipped = region;
+	clipped.Clip(m_mapWidth, m_mapHeight);
+	if( clipped.isEmpty() )
+	{
+		return;
+	}
+
+	for( int32 tmpY=clipped.minY; tmpY<=clipped.maxY; ++tmpY )
+	{
+		int32 index = getTileIndex(clipped.minX, tmpY);
+		for( int32 i=0; i<clipped.getWidth(); ++i )
+		{
+			setCostOverride(index+i, cost);
+		}
+	}
+
+	markDirty(clipped);
+}
+
+void geTiledMap::StampBrush(const int32 x, const int32 y, const uint8* pMask, const int32 maskWidth, const int32 maskHeight, const uint8 idtype)
+{//Establece el tipo de los tiles cubiertos por la máscara
+	GEE_ASSERT(pMask);
+	GEE_ASSERT( maskWidth > 0 && maskHeight > 0 );
+	GEE_ASSERT( idtype < TT_NUM_OBJECTS );
+	if( !isEditable() )
+	{//El hilo de carga sigue escribiendo los tiles
+		return;
+	}
+	uint8 validType = ValidateType(idtype);
+
+	//Calculamos el área que cubre la máscara centrada en el tile indicado y la limitamos al mapa
+	geMapRegion stamp(x-DivX2(maskWidth), y-DivX2(maskHeight), 0, 0);
+	stamp.maxX = stamp.minX+maskWidth-1;
+	stamp.maxY = stamp.minY+maskHeight-1;
+	geMapRegion clipped = stamp;
+	clipped.Clip(m_mapWidth, m_mapHeight);
+	if( clipped.isEmpty() )
+	{
+		return;
+	}
+
+	int32 width = clipped.getWidth();
+	for( int32 tmpY=clipped.minY; tmpY<=clipped.maxY; ++tmpY )
+	{
+		uint8* pTypeRow = &m_typePlane[getTileIndex(clipped.minX, tmpY)];
+		const uint8* pMaskRow = &pMask[((tmpY-stamp.minY)*maskWidth) + (clipped.minX-stamp.minX)];
+
+		//NOTA: Se escribe cada tile con una selección en lugar de un salto condicional para que el compilador pueda vectorizar el ciclo
+		for( int32 i=0; i<width; ++i )
+		{
+			pTypeRow[i] = pMaskRow[i] ? validType : pTypeRow[i];
+		}
+	}
+
+	markDirty(clipped);
+}
+
+geMapRegion geTiledMap::FloodFill(const int32 x, const int32 y, const uint8 idtype)
+{//Cambia el tipo de la zona conectada (4 vecinos) del mismo tipo que el tile inicial
+	GEE_ASSERT( idtype < TT_NUM_OBJECTS );
+	geMapRegion changed;
+	if( !isInside(x, y) || !isEditable() )
+	{//Fuera del mapa o el hilo de carga sigue escribiendo los tiles
+		return changed;
+	}
+
+	uint8 validType = ValidateType(idtype);
+	uint8 targetType = m_typePlane[getTileIndex(x, y)];
+	if( targetType == validType )
+	{//No hay nada que cambiar
+		return changed;
+	}
+
+	//Hacemos un llenado por líneas: cada semilla se extiende a izquierda y derecha y siembra las filas vecinas
+	std::vector<int32> seeds;
+	seeds.push_back( getTileIndex(x, y) );
+	while( !seeds.empty() )
+	{
+		int32 index = seeds.back();
+		seeds.pop_back();
+		if( m_typePlane[index] != targetType )
+		{//Este tramo ya fue llenado desde otra semilla
+			continue;
+		}
+
+		int32 tmpY = getTileIndexY(index);
+		int32 iniX = getTileIndexX(index);
+		int32 finX = iniX;
+		uint8* pTypeRow = &m_typePlane[getTileIndex(0, tmpY)];
+		while( iniX > 0 && pTypeRow[iniX-1] == targetType ) --iniX;
+		while( finX < m_mapWidth-1 && pTypeRow[finX+1] == targetType ) ++finX;
+
+		memset(&pTypeRow[iniX], validType, finX-iniX+1);
+		changed.Merge( geMapRegion(iniX, tmpY, finX, tmpY) );
+
+		//Agregamos una semilla por cada tramo contiguo del tipo buscado en las filas de arriba y abajo
+		for( int32 neighborY=tmpY-1; neighborY<=tmpY+1; neighborY+=2 )
+		{
+			if( neighborY < 0 || neighborY >= m_mapHeight )
+			{
+				continue;
+			}
+
+			const uint8* pNeighborRow = &m_typePlane[getTileIndex(0, neighborY)];
+			bool bInSpan = false;
+			for( int32 tmpX=iniX; tmpX<=finX; ++tmpX )
+			{
+				if( pNeighborRow[tmpX] == targetType )
+				{
+					if( !bInSpan )
+					{
+						seeds.push_back( getTileIndex(tmpX, neighborY) );
+						bInSpan = true;
+					}
+				}
+				else
+				{
+					bInSpan = false;
+				}
+			}
+		}
+	}
+
+	markDirty(changed);
+	return changed;
+}
+
+void geTiledMap::CopyBlock(const geMapRegion& region, geMapBlock& block) const
+{//Copia los tiles de la región al bloque indicado
+	geMapRegion clipped = region;
+	clipped.Clip(m_mapWidth, m_mapHeight);
+	if( clipped.isEmpty() )
+	{
+		block.width = block.height = 0;
+		block.types.clear();
+		block.costs.clear();
+		return;
+	}
+
+	block.width = clipped.getWidth();
+	block.height = clipped.getHeight();
+	block.types.resize(block.width*block.height);
+	block.costs.resize(block.width*block.height);
+	for( int32 tmpY=0; tmpY<block.height; ++tmpY )
+	{
+		int32 index = getTileIndex(clipped.minX, clipped.minY+tmpY);
+		memcpy(&block.types[tmpY*block.width], &m_typePlane[index], block.width);
+		ReadCostOverrides(clipped.minX, clipped.minY+tmpY, block.width, &block.costs[tmpY*block.width]);
+	}
+}
+
+void geTiledMap::PasteBlock(const int32 x, const int32 y, const geMapBlock& block)
+{//Escribe el bloque en el mapa con su esquina superior izquierda en x,y
+	if( !isEditable() )
+	{//El hilo de carga sigue escribiendo los tiles
+		return;
+	}
+	geMapRegion target(x, y, x+block.width-1, y+block.height-1);
+	geMapRegion clipped = target;
+	clipped.Clip(m_mapWidth, m_mapHeight);
+	if( clipped.isEmpty() )
+	{
+		return;
+	}
+
+	int32 width = clipped.getWidth();
+	for( int32 tmpY=clipped.minY; tmpY<=clipped.maxY; ++tmpY )
+	{
+		int32 index = getTileIndex(clipped.minX, tmpY);
+		int32 blockIndex = ((tmpY-target.minY)*block.width) + (clipped.minX-target.minX);
+		for( int32 i=0; i<width; ++i )
+		{//El bloque puede venir de fuera del mapa (ej. un archivo), validamos cada tipo
+			m_typePlane[index+i] = ValidateType(block.types[blockIndex+i]);
+			setCostOverride(index+i, block.costs[blockIndex+i]);
+		}
+	}
+
+	markDirty(clipped);
+}
+
+void geTiledMap::publishChunk(const int32 chunkX, const int32 chunkY)
+{//Marca un chunk como listo para leerse
+	GEE_ASSERT( (chunkX>=0) && (chunkX<m_numChunksX) && (chunkY>=0) && (chunkY<m_numChunksY) );
+
+	//NOTA: InterlockedExchange funciona como barrera completa, así que las escrituras de los tiles del chunk son visibles para otros hilos antes que la bandera
+	//NOTA: El valor 1 indica que el chunk está listo pero su cambio aún no se registra en el journal, Update() lo registra desde el hilo principal
+	if( InterlockedExchange(&m_chunkReady[(chunkY*m_numChunksX)+chunkX], 1) == 0 )
+	{//Este chunk no estaba listo antes, lo contamos
+		InterlockedIncrement(&m_numChunksReady);
+	}
+}
+
+void geTiledMap::setAllChunksReady(const bool bReady)
+{//Marca todos los chunks como listos o pendientes (solo debe llamarse cuando ningún hilo esté cargando este mapa)
+	int32 numChunks = m_numChunksX*m_numChunksY;
+	for( int32 i=0; i<numChunks; ++i )
+	{
+		m_chunkReady[i] = bReady ? 2 : 0;	//2 = listo y registrado en el journal
+	}
+
+	InterlockedExchange(&m_numChunksReady, bReady ? numChunks : 0);
+	m_numChunksJournaled = bReady ? numChunks : 0;
+}
+
+/************************************************************************************************************************/
+/* Funciones del journal de cambios																						*/
+/************************************************************************************************************************/
+void geTiledMap::markDirty(const geMapRegion& region)
+{//Registra un cambio en la región indicada
+	//NOTA: Esta función solo debe llamarse desde el hilo principal
+	geMapRegion clipped = region;
+	clipped.Clip(m_mapWidth, m_mapHeight);
+	if( clipped.isEmpty() )
+	{
+		return;
+	}
+
+	++m_version;
+
+	//Acumulamos la región para recalcular los datos derivados una sola vez por edición (ver FlushDerivedPlanes)
+	m_pendingDerived.Merge(clipped);
+
+	//Actualizamos la versión de los chunks que toca la región
+	for( int32 chunkY=(clipped.minY>>MAP_CHUNK_BITS); chunkY<=(clipped.maxY>>MAP_CHUNK_BITS); ++chunkY )
+	{
+		for( int32 chunkX=(clipped.minX>>MAP_CHUNK_BITS); chunkX<=(clipped.maxX>>MAP_CHUNK_BITS); ++chunkX )
+		{
+			m_chunkVersion[(chunkY*m_numChunksX)+chunkX] = m_version;
+		}
+	}
+
+	if( m_journalCount > 0 )
+	{//Intentamos unir el cambio con el último registrado (las ediciones de un pincel suelen caer repetidamente en la misma zona)
+		MapChange& last = m_journal[(m_journalCount-1) & (MAP_JOURNAL_SIZE-1)];
+		bool bSameChunk =	(last.region.minX>>MAP_CHUNK_BITS) == (clipped.minX>>MAP_CHUNK_BITS) && (last.region.maxX>>MAP_CHUNK_BITS) == (clipped.maxX>>MAP_CHUNK_BITS) &&
+							(last.region.minY>>MAP_CHUNK_BITS) == (clipped.minY>>MAP_CHUNK_BITS) && (last.region.maxY>>MAP_CHUNK_BITS) == (clipped.maxY>>MAP_CHUNK_BITS) &&
+							(last.region.minX>>MAP_CHUNK_BITS) == (last.region.maxX>>MAP_CHUNK_BITS) && (last.region.minY>>MAP_CHUNK_BITS) == (last.region.maxY>>MAP_CHUNK_BITS);
+		if( bSameChunk || last.region.Contains(clipped) )
+		{
+			last.region.Merge(clipped);
+			last.version = m_version;
+			return;
+		}
+	}
+
+	//Agregamos una nueva entrada al buffer circular
+	MapChange& entry = m_journal[m_journalCount & (MAP_JOURNAL_SIZE-1)];
+	if( m_journalCount >= MAP_JOURNAL_SIZE )
+	{//Vamos a sobreescribir la entrada más antigua, así que el journal ya no puede responder por versiones anteriores a ella
+		m_journalBaseVersion = entry.version;
+	}
+	entry.version = m_version;
+	entry.region = clipped;
+	++m_journalCount;
+}
+
+void geTiledMap::FlushDerivedPlanes()
+{//Recalcula los datos derivados de todas las regiones modificadas desde la última vez
+	if( !m_pendingDerived.isEmpty() )
+	{
+		UpdateDerivedPlanes(m_pendingDerived);
+		m_pendingDerived = geMapRegion();
+	}
+}
+
+void geTiledMap::UpdateDerivedPlanes(const geMapRegion& region)
+{//Cada clase tiene su propio plano de transitabilidad y su propio clearance (el clearance depende de la transitabilidad de la clase)
+	for( int32 mc=0; mc<MC_NUM_CLASSES; ++mc )
+	{
+		UpdatePassability((eMovementClass)mc, region);
+		UpdateClearance((eMovementClass)mc, region);
+	}
+}
+
+void geTiledMap::UpdatePassability(const eMovementClass mc, const geMapRegion& region)
+{//Recalcula los bits de transitabilidad de una clase de movimiento dentro de la región
+	//Tabla de transitabilidad por tipo de terreno para esta clase
+	uint64 passableType[TT_NUM_OBJECTS];
+	for( int32 i=0; i<TT_NUM_OBJECTS; ++i )
+	{
+		passableType[i] = (m_terrainCost[mc][i] != MAP_COST_IMPASSABLE) ? 1 : 0;
+	}
+
+	for( int32 tmpY=region.minY; tmpY<=region.maxY; ++tmpY )
+	{
+		const uint8* pTypeRow = getTypeRow(tmpY);
+		uint64* pPassRow = &m_passabilityPlanes[((mc*m_mapHeight)+tmpY)*m_passabilityRowWords];
+		int32 rowIndex = getTileIndex(0, tmpY);
+
+		//Armamos cada palabra completa en un registro y la escribimos una sola vez
+		for( int32 word=(region.minX>>6); word<=(region.maxX>>6); ++word )
+		{
+			int32 iniX = Max(region.minX, word<<6);
+			int32 finX = Min(region.maxX, (word<<6)+63);
+
+			uint64 bits = 0;
+			for( int32 tmpX=iniX; tmpX<=finX; ++tmpX )
+			{
+				bits |= passableType[pTypeRow[tmpX]] << (tmpX&63);
+			}
+
+			//Los tiles con costo especial usan ese costo en lugar del de su terreno
+			if( !m_costOverrides.empty() )
+			{
+				for( int32 tmpX=iniX; tmpX<=finX; ++tmpX )
+				{
+					int32 index = rowIndex+tmpX;
+					if( (m_costOverrideBits[index>>6] >> (index&63)) & 1 )
+					{
+						uint64 bit = (uint64)1 << (tmpX&63);
+						bits = (m_costOverrides.find(index)->second != MAP_COST_IMPASSABLE) ? (bits | bit) : (bits & ~bit);
+					}
+				}
+			}
+
+			int32 count = finX-iniX+1;
+			uint64 mask = ((count == 64) ? ~(uint64)0 : (((uint64)1 << count)-1)) << (iniX&63);
+			pPassRow[word] = (pPassRow[word] & ~mask) | bits;
+		}
+	}
+}
+
+void geTiledMap::UpdateClearance(const eMovementClass mc, const geMapRegion& region)
+{//Recalcula el clearance de una clase en los tiles que pueden depender de la región modificada
+	//El clearance de un tile solo depende de los tiles a su derecha y abajo (hasta MAP_MAX_CLEARANCE de distancia), así que un cambio
+	//solo puede afectar a los tiles que están arriba y a la izquierda de la región
+	geMapRegion area = region;
+	area.minX -= MAP_MAX_CLEARANCE-1;
+	area.minY -= MAP_MAX_CLEARANCE-1;
+	area.Clip(m_mapWidth, m_mapHeight);
+	if( area.isEmpty() )
+	{
+		return;
+	}
+
+	//Recorremos de abajo hacia arriba y de derecha a izquierda, así los vecinos que se leen ya tienen su valor final
+	//NOTA: Fuera del mapa se considera clearance 0 (no se leen los tiles de relleno de las filas)
+	for( int32 tmpY=area.maxY; tmpY>=area.minY; --tmpY )
+	{
+		const uint64* pPassRow = getPassabilityRow(mc, tmpY);
+		uint8* pClearanceRow = &m_clearancePlanes[((mc*m_mapHeight)+tmpY)<<m_strideShift];
+		const uint8* pBelowRow = (tmpY+1 < m_mapHeight) ? getClearanceRow(mc, tmpY+1) : NULL;
+
+		for( int32 tmpX=area.maxX; tmpX>=area.minX; --tmpX )
+		{
+			if( !((pPassRow[tmpX>>6] >> (tmpX&63)) & 1) )
+			{
+				pClearanceRow[tmpX] = 0;
+				continue;
+			}
+
+			uint8 right = (tmpX+1 < m_mapWidth) ? pClearanceRow[tmpX+1] : 0;
+			uint8 below = (pBelowRow != NULL) ? pBelowRow[tmpX] : 0;
+			uint8 diagonal = (pBelowRow != NULL && tmpX+1 < m_mapWidth) ? pBelowRow[tmpX+1] : 0;
+			pClearanceRow[tmpX] = (uint8)Min( 1+Min3(right, below, diagonal), MAP_MAX_CLEARANCE );
+		}
+	}
+}
+
+bool geTiledMap::getDirtyRegionsSince(const uint32 sinceVersion, std::vector<geMapRegion>& regions) const
+{//Agrega a la lista las regiones que cambiaron despues de la versión indicada (de la más antigua a la más reciente)
+	if( sinceVersion >= m_version )
+	{//No hay cambios nuevos
+		return true;
+	}
+
+	if( sinceVersion < m_journalBaseVersion )
+	{//Los cambios que necesita el consumidor ya fueron descartados (o el mapa fue reinicializado), debe reconstruir todo
+		return false;
+	}
+
+	uint32 numEntries = Min(m_journalCount, (uint32)MAP_JOURNAL_SIZE);
+	for( uint32 i=m_journalCount-numEntries; i<m_journalCount; ++i )
+	{
+		const MapChange& entry = m_journal[i & (MAP_JOURNAL_SIZE-1)];
+		if( entry.version > sinceVersion )
+		{
+			regions.push_back(entry.region);
+		}
+	}
+
+	return true;
 }
 
 void geTiledMap::moveCamera(const float dx, const float dy)
@@ -226,14 +1030,14 @@ void geTiledMap::getScreenToMapCoords(const int32 scrX, const int32 scrY, int32
 	mapY = (scrY-m_PreCalc_ScreenDefaceY)>>BITSFT_TILESIZE_Y;
 #endif	//MAP_IS_ISOMETRIC
 
-	mapX = Max( 0, Min( mapX, m_mapSize-1 ) );
-	mapY = Max( 0, Min( mapY, m_mapSize-1 ) );
+	mapX = Max( 0, Min( mapX, m_mapWidth-1 ) );
+	mapY = Max( 0, Min( mapY, m_mapHeight-1 ) );
 }
 
 void geTiledMap::getMapToScreenCoords(const int32 mapX, const int32 mapY, int32 &scrX, int32 &scrY)
 {//Esta función convierte coordenadas de mapa a coordenadas de pantalla
 	//Revisamos que nadie pase datos inválidos del mapa (a diferencia de las coordenadas de pantalla, las coordenadas de mapa nunca deberían llegar aquí de manera inválida)
-	GEE_ASSERT( (mapX>=0) && (mapX<m_mapSize) && (mapY>=0) && (mapY<m_mapSize) );
+	GEE_ASSERT( isInside(mapX, mapY) );
 
 #ifdef MAP_IS_ISOMETRIC	//Estamos usando el sistema isométrico
 	scrX = (mapX - mapY) <<5 ;
@@ -248,18 +1052,183 @@ void geTiledMap::getMapToScreenCoords(const int32 mapX, const int32 mapY, int32
 #endif	//MAP_IS_ISOMETRIC
 }
 
+void geTiledMap::getScreenToMapCoords(const int32* pScrX, const int32* pScrY, int32* pMapX, int32* pMapY, const int32 count)
+{//Convierte un arreglo de coordenadas de pantalla a coordenadas de mapa
+	int32 done = 0;
+	if( CPUHasAVX2() )
+	{
+		done = ScreenToMapAVX2(pScrX, pScrY, pMapX, pMapY, count, m_PreCalc_ScreenDefaceX, m_PreCalc_ScreenDefaceY, m_mapWidth-1, m_mapHeight-1);
+	}
+	done += ScreenToMapSSE2(pScrX+done, pScrY+done, pMapX+done, pMapY+done, count-done, m_PreCalc_ScreenDefaceX, m_PreCalc_ScreenDefaceY, m_mapWidth-1, m_mapHeight-1);
+
+	//Los puntos restantes se convierten uno por uno
+	for( int32 i=done; i<count; ++i )
+	{
+		getScreenToMapCoords(pScrX[i], pScrY[i], pMapX[i], pMapY[i]);
+	}
+}
+
+void geTiledMap::getMapToScreenCoords(const int32* pMapX, const int32* pMapY, int32* pScrX, int32* pScrY, const int32 count)
+{//Convierte un arreglo de coordenadas de mapa a coordenadas de pantalla (igual que en la versión de un punto, las coordenadas deben estar dentro del mapa)
+	int32 done = 0;
+	if( CPUHasAVX2() )
+	{
+		done = MapToScreenAVX2(pMapX, pMapY, pScrX, pScrY, count, m_PreCalc_ScreenDefaceX, m_PreCalc_ScreenDefaceY);
+	}
+	done += MapToScreenSSE2(pMapX+done, pMapY+done, pScrX+done, pScrY+done, count-done, m_PreCalc_ScreenDefaceX, m_PreCalc_ScreenDefaceY);
+
+	for( int32 i=done; i<count; ++i )
+	{
+		getMapToScreenCoords(pMapX[i], pMapY[i], pScrX[i], pScrY[i]);
+	}
+}
+
 void geTiledMap::Update(float deltaTime)
 {
 	//Aquí deben hacerse las actualizaciones de objetos del mapa para cada ciclo
 	(void*)&deltaTime;
+
+	//Registramos en el journal los chunks que el hilo de carga publicó desde el último ciclo
+	if( m_numChunksJournaled < m_numChunksReady )
+	{
+		int32 numChunks = m_numChunksX*m_numChunksY;
+		for( int32 i=0; i<numChunks && m_numChunksJournaled < m_numChunksReady; ++i )
+		{
+			if( InterlockedCompareExchange(&m_chunkReady[i], 2, 1) == 1 )
+			{
+				int32 iniX = (i%m_numChunksX)<<MAP_CHUNK_BITS;
+				int32 iniY = (i/m_numChunksX)<<MAP_CHUNK_BITS;
+				markDirty( geMapRegion(iniX, iniY, iniX+MAP_CHUNK_MASK, iniY+MAP_CHUNK_MASK) );
+				++m_numChunksJournaled;
+			}
+		}
+	}
+
+	//Los trazos del pincel y los chunks recién cargados en este ciclo se recalculan juntos
+	FlushDerivedPlanes();
+
+	if( m_pRenderer != NULL )
+	{//Cambiamos la textura provisional por las imágenes del terreno que ya se subieron
+		UpdateTerrainTextures();
+	}
 }
 
-void geTiledMap::Render()
+bool geTiledMap::isTerrainLoading() const
+{//El atlas o alguna textura por tipo sigue pendiente
+	if( m_terrainAtlas.isLoading() )
+	{
+		return true;
+	}
+	for( uint8 i=0; i<TT_NUM_OBJECTS; ++i )
+	{
+		if( m_pendingTextures[i].isValid() )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void geTiledMap::CreatePlaceholderTexture()
+{//Textura lisa del tamaño de un tile (se comparte en el cache entre todos los mapas)
+	const geString key = TEXT("terrain:placeholder");
+	m_placeholderTexture = g_TextureManager.Find(key);
+	if( m_placeholderTexture.isValid() )
+	{
+		return;
+	}
+
+	SDL_Surface* pSurface = SDL_CreateRGBSurface(0, TILESIZE_X, TILESIZE_Y, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+	if( pSurface == NULL )
+	{
+		GEE_WARNING( TEXT("No se pudo crear la textura provisional del terreno! SDL Error: ") + s2gs(SDL_GetError()) );
+		return;
+	}
+
+	for( int32 y=0; y<TILESIZE_Y; ++y )
+	{
+		uint32* pRow = (uint32*)((uint8*)pSurface->pixels + (y*pSurface->pitch));
+		for( int32 x=0; x<TILESIZE_X; ++x )
+		{
+#ifdef MAP_IS_ISOMETRIC
+			//Solo el rombo del tile es opaco (distancia al centro medida en pixeles dobles para no usar fracciones)
+			bool bInside = (Abs((x<<1)+1-TILESIZE_X)*TILESIZE_Y) + (Abs((y<<1)+1-TILESIZE_Y)*TILESIZE_X) <= TILESIZE_X*TILESIZE_Y;
+#else
+			bool bInside = true;
+#endif
+			pRow[x] = bInside ? MAP_PLACEHOLDER_COLOR : 0;
+		}
+	}
+
+	m_placeholderTexture = g_TextureManager.Create(key, pSurface);
+	if( m_placeholderTexture.isValid() )
+	{
+		m_placeholderTexture->SetBlendMode(SDL_BLENDMODE_BLEND);
+	}
+	SDL_FreeSurface(pSurface);
+}
+
+void geTiledMap::UpdateTerrainTextures()
+{//Revisa las cargas asíncronas del terreno
+	bool bChanged = false;
+	if( m_terrainAtlas.isLoading() )
+	{
+		bChanged = m_terrainAtlas.Update();
+		if( !m_terrainAtlas.isLoading() && !m_terrainAtlas.isValid() )
+		{//No se pudo crear el atlas, pedimos una textura por tipo
+			for( uint8 i=0; i<TT_NUM_OBJECTS; ++i )
+			{
+				m_pendingTextures[i] = g_TextureManager.LoadAsync( GetTerrainTextureName(i) );
+			}
+		}
+	}
+
+	for( uint8 i=0; i<TT_NUM_OBJECTS; ++i )
+	{
+		if( m_pendingTextures[i].isValid() && !m_pendingTextures[i].isPending() )
+		{//Si la carga falló el tipo se sigue imprimiendo con la textura provisional
+			if( m_pendingTextures[i].isReady() )
+			{
+				m_mapTextures[i] = m_pendingTextures[i];
+				bChanged = true;
+			}
+			m_pendingTextures[i].Release();
+		}
+	}
+
+	//Los chunks que se rasterizaron con la textura provisional deben rasterizarse de nuevo
+	if( bChanged )
+	{
+		m_chunkCache.Invalidate();
+	}
+}
+
+int32 geTiledMap::ComputeVisibleSpans(std::vector<geMapRowSpan>& spans) const
+{//Calcula los tiles visibles del área de impresión como rangos por fila
+	geMapView view;
+	view.startX = m_startX;
+	view.startY = m_startY;
+	view.endX = m_endX;
+	view.endY = m_endY;
+	view.defaceX = m_PreCalc_ScreenDefaceX;
+	view.defaceY = m_PreCalc_ScreenDefaceY;
+	view.mapWidth = m_mapWidth;
+	view.mapHeight = m_mapHeight;
+	view.tileShiftX = BITSFT_TILESIZE_X;
+	view.tileShiftY = BITSFT_TILESIZE_Y;
+#ifdef MAP_IS_ISOMETRIC
+	view.bIsometric = true;
+#else
+	view.bIsometric = false;
+#endif
+	return ComputeMapViewSpans(view, spans);
+}
+
+void geTiledMap::Render(geRenderQueue& queue)
 {
 	//Creamos variables temporales
 	int32 tmpX = 0;
 	int32 tmpY = 0;
-	int32 tmpTypeTile = 0;
 	SDL_Rect clipRect;
 
 	//Obtenemos los puntos de mapa inicial y final que debemos renderear según los puntos en la resolución
@@ -278,91 +1247,139 @@ void geTiledMap::Render()
 	getScreenToMapCoords(m_startX, m_startY, tileIniX, tileIniY);
 	getScreenToMapCoords(m_endX, m_endY, tileFinX, tileFinY);
 #endif
-	//Obtenidas ya las posiciones iniciales y finales, rendereamos las texturas
-	for(int32 iterX=tileIniX; iterX<=tileFinX; iterX++)
+	//Obtenemos los rangos exactos de tiles visibles de cada fila, así solo recorremos tiles que sí se imprimen
+	ComputeVisibleSpans(m_viewSpans);
+
+	//Con el cache de chunks basta una copia por chunk visible, solo imprimimos tile por tile si no está disponible
+	bool bChunksRendered = m_chunkCache.Render(queue, m_viewSpans);
+	for(SIZE_T iterSpan=0; !bChunksRendered && iterSpan<m_viewSpans.size(); iterSpan++)
 	{
-		for(int32 iterY=tileIniY; iterY<=tileFinY; iterY++)
+		const geMapRowSpan& span = m_viewSpans[iterSpan];
+		int32 iterY = span.y;
+
+		//Convertimos toda la fila a coordenadas de pantalla de una sola vez
+		int32 numTiles = span.finX-span.iniX+1;
+		m_batchMapX.resize(numTiles);
+		m_batchMapY.assign(numTiles, iterY);
+		m_batchScrX.resize(numTiles);
+		m_batchScrY.resize(numTiles);
+		for(int32 iterX=span.iniX; iterX<=span.finX; iterX++)
 		{
-			getMapToScreenCoords(iterX, iterY, tmpX, tmpY);
+			m_batchMapX[iterX-span.iniX] = iterX;
+		}
+		getMapToScreenCoords(&m_batchMapX[0], &m_batchMapY[0], &m_batchScrX[0], &m_batchScrY[0], numTiles);
 
-			//Revisamos si este tile debe imprimirse haciendo una eliminación temprana
-			if( tmpX > m_endX || tmpY > m_endY || (tmpX+TILESIZE_X) < m_startX || (tmpY+TILESIZE_X) < m_startY )
+		for(int32 iterX=span.iniX; iterX<=span.finX; iterX++)
+		{
+			//Los tiles de chunks que aún se están cargando no se imprimen
+			if( !isTileReady(iterX, iterY) )
 			{
 				continue;
 			}
 
-			tmpTypeTile = m_mapGrid[iterX][iterY].getType();
-			clipRect.x = (iterX<<BITSFT_TILESIZE_X) % m_mapTextures[tmpTypeTile].GetWidth();
-			clipRect.y = (iterY<<BITSFT_TILESIZE_Y) % m_mapTextures[tmpTypeTile].GetHeight();
-			clipRect.w = TILESIZE_X;
-			clipRect.h = TILESIZE_Y;
+			tmpX = m_batchScrX[iterX-span.iniX];
+			tmpY = m_batchScrY[iterX-span.iniX];
 
-			m_mapTextures[tmpTypeTile].Render(tmpX, tmpY, &clipRect);
+			//Los tiles consecutivos con la misma textura (todos si hay atlas) se unen en un solo lote
+			SDL_Texture* pTexture = getTerrainSource(m_typePlane[getTileIndex(iterX, iterY)], iterX, iterY, clipRect);
+			SDL_Rect dstRect = { tmpX, tmpY, TILESIZE_X, TILESIZE_Y };
+			queue.AddQuad(RL_TERRAIN, pTexture, clipRect, dstRect);
 		}
 	}
 
 	if( m_bShowGrid )
-	{//Si se pidió que imprimieramos el grid
-		//Establecemos el color para las líneas
-		SDL_SetRenderDrawColor(m_pRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
-		
-		for(int32 iterX=tileIniX; iterX<=tileFinX; iterX++)
+	{//Si se pidió que imprimieramos el grid, solo recalculamos las líneas si la cámara o el mapa cambiaron
+		geOverlayKey key = getOverlayKey(0);
+		if( !m_gridOverlay.isValid(key) )
 		{
-#ifdef MAP_IS_ISOMETRIC	//Sección para mapas isométricos
-			int32 tmpX2, tmpY2;
-			getMapToScreenCoords(iterX, tileIniY, tmpX, tmpY);
-			getMapToScreenCoords(iterX, tileFinY, tmpX2, tmpY2);
+			BuildGridOverlay(key, tileIniX, tileIniY, tileFinX, tileFinY);
+		}
+		m_gridOverlay.Submit(queue, RL_MAP_OVERLAY);
+	}
+}
+
+geOverlayKey geTiledMap::getOverlayKey(const uint32 contentVersion) const
+{//Todo lo que cambia la posición en pantalla de un tile
+	geOverlayKey key;
+	key.cameraX = m_PreCalc_ScreenDefaceX;
+	key.cameraY = m_PreCalc_ScreenDefaceY;
+	key.viewX0 = m_startX;
+	key.viewY0 = m_startY;
+	key.viewX1 = m_endX;
+	key.viewY1 = m_endY;
+	key.mapWidth = m_mapWidth;
+	key.mapHeight = m_mapHeight;
+	key.contentVersion = contentVersion;
+	return key;
+}
 
-			SDL_RenderDrawLine(m_pRenderer, tmpX+TILEHALFSIZE_X, tmpY, tmpX2, tmpY2+TILEHALFSIZE_Y);
+void geTiledMap::BuildGridOverlay(const geOverlayKey& key, const int32 tileIniX, const int32 tileIniY, const int32 tileFinX, const int32 tileFinY)
+{//Genera las líneas del grid como dos líneas continuas (una por eje) en zigzag
+	//NOTA: Cada línea del grid se recorre en sentido contrario a la anterior, así el tramo que las une queda sobre el borde del área cubierta
+	SDL_Color gridColor = { 0xFF, 0xFF, 0xFF, 0xFF };
+	int32 tmpX, tmpY, tmpX2, tmpY2;
+	std::vector<SDL_Point> points;
+	m_gridOverlay.Begin(key);
+
+	points.reserve( (Max(tileFinX-tileIniX, tileFinY-tileIniY)+1)*2 );
+	for(int32 iterX=tileIniX; iterX<=tileFinX; iterX++)
+	{
+		SDL_Point lineStart, lineEnd;
+#ifdef MAP_IS_ISOMETRIC	//Sección para mapas isométricos
+		getMapToScreenCoords(iterX, tileIniY, tmpX, tmpY);
+		getMapToScreenCoords(iterX, tileFinY, tmpX2, tmpY2);
+		lineStart.x = tmpX+TILEHALFSIZE_X;	lineStart.y = tmpY;
+		lineEnd.x = tmpX2;					lineEnd.y = tmpY2+TILEHALFSIZE_Y;
 #else	//En mapas cuadrados
-			getMapToScreenCoords(iterX, tileIniY, tmpX, tmpY);
-			SDL_RenderDrawLine(m_pRenderer, tmpX, tmpY, tmpX, m_endY);
+		getMapToScreenCoords(iterX, tileIniY, tmpX, tmpY);
+		lineStart.x = tmpX;	lineStart.y = tmpY;
+		lineEnd.x = tmpX;	lineEnd.y = m_endY;
 #endif
+		if( (iterX-tileIniX) & 1 )
+		{
+			points.push_back(lineEnd);
+			points.push_back(lineStart);
 		}
-
-		for(int32 iterY=tileIniY; iterY<=tileFinY; iterY++)
+		else
 		{
-#ifdef MAP_IS_ISOMETRIC	//Sección para mapas isométricos
-			int32 tmpX2, tmpY2;
-			getMapToScreenCoords(tileIniX, iterY, tmpX, tmpY);
-			getMapToScreenCoords(tileFinX, iterY, tmpX2, tmpY2);
+			points.push_back(lineStart);
+			points.push_back(lineEnd);
+		}
+	}
+	if( !points.empty() )
+	{
+		m_gridOverlay.AddLines(&points[0], (int32)points.size(), gridColor);
+	}
 
-			SDL_RenderDrawLine(m_pRenderer, tmpX, tmpY+TILEHALFSIZE_Y, tmpX2+TILEHALFSIZE_X, tmpY2);
+	points.clear();
+	for(int32 iterY=tileIniY; iterY<=tileFinY; iterY++)
+	{
+		SDL_Point lineStart, lineEnd;
+#ifdef MAP_IS_ISOMETRIC	//Sección para mapas isométricos
+		getMapToScreenCoords(tileIniX, iterY, tmpX, tmpY);
+		getMapToScreenCoords(tileFinX, iterY, tmpX2, tmpY2);
+		lineStart.x = tmpX;					lineStart.y = tmpY+TILEHALFSIZE_Y;
+		lineEnd.x = tmpX2+TILEHALFSIZE_X;	lineEnd.y = tmpY2;
 #else
-			getMapToScreenCoords(tileIniX, iterY, tmpX, tmpY);
-			SDL_RenderDrawLine(m_pRenderer, tmpX, tmpY, m_endX, tmpY);
+		getMapToScreenCoords(tileIniX, iterY, tmpX, tmpY);
+		lineStart.x = tmpX;		lineStart.y = tmpY;
+		lineEnd.x = m_endX;		lineEnd.y = tmpY;
 #endif
+		if( (iterY-tileIniY) & 1 )
+		{
+			points.push_back(lineEnd);
+			points.push_back(lineStart);
+		}
+		else
+		{
+			points.push_back(lineStart);
+			points.push_back(lineEnd);
 		}
 	}
-}
-
-/************************************************************************************************************************/
-/* Implementación de las funciones de la subclase geTiledMap::MapTile                                        			*/
-/************************************************************************************************************************/
-geTiledMap::MapTile::MapTile()
-{//Constructor Standard
-	m_idType = 1;
-	m_cost = 1;
-}
-
-geTiledMap::MapTile::MapTile(const int8 idType, const int8 cost)
-{//Constructor con parámetros
-	m_idType = idType;
-	m_cost = cost;
-}
-
-geTiledMap::MapTile::MapTile(const MapTile& copy)
-{//Constructor de copia
-	m_idType = copy.m_idType;
-	m_cost = copy.m_cost;
-}
-
-geTiledMap::MapTile &geTiledMap::MapTile::operator=(const MapTile& rhs)
-{
-	m_idType = rhs.m_idType;
-	m_cost = rhs.m_cost;
-
-	return (*this);
+	if( !points.empty() )
+	{
+		m_gridOverlay.AddLines(&points[0], (int32)points.size(), gridColor);
+	}
 }
 
 /************************************************************************************************************************/
@@ -371,7 +1388,7 @@ geTiledMap::MapTile &geTiledMap::MapTile::operator=(const MapTile& rhs)
 bool geTiledMap::LoadFromImageFile(SDL_Renderer* pRenderer, geString fileName)
 {
 	//Revisamos que esta función pueda ser llamada
-	if( m_mapGrid != NULL )
+	if( m_typePlane != NULL )
 	{//Este mapa ya fue creado anteriormente, destruimos los datos actuales y reinicializamos
 		//Destroy();
 	}
@@ -390,42 +1407,22 @@ bool geTiledMap::LoadFromImageFile(SDL_Renderer* pRenderer, geString fileName)
 	else
 	{//La superficie se cargó con éxito
 		//Obtenemos el tamaño de la imagen e inicializamos los objetos de la clase dependiendo de lo requerido
-		if(!Init(pRenderer, loadedSurface->w))	//TODO: Cambiar la inicialización para poder generar mapas con proporciones no cuadradas
+		if(!Init(pRenderer, loadedSurface->w, loadedSurface->h))
 		{//Ocurrió un error al inicializar la información del mapa
 			GEE_ERROR(TEXT("geTiledMap::LoadFromImageFile: Falló al inicializar la información del mapa "));
 			return false;
 		}
-		//Ahora hacemos un barrido por la imagen y establecemos los tipos de terreno según el color del pixel de la imagen
-		int32 NumBytesPerPixel = loadedSurface->pitch/loadedSurface->w;
-		BYTE* pPixeles = (BYTE*)loadedSurface->pixels;
-
-		for(int32 tmpY=0; tmpY<m_mapSize; tmpY++)
+		//Ahora hacemos un barrido por la imagen, chunk por chunk, y establecemos los tipos de terreno según el color del pixel de la imagen
+		for(int32 chunkY=0; chunkY<m_numChunksY; chunkY++)
 		{
-			for(int32 tmpX=0; tmpX<m_mapSize; tmpX++)
+			for(int32 chunkX=0; chunkX<m_numChunksX; chunkX++)
 			{
-				uint8 tipoTerreno = TT_OBSTACLE;	//Tipo Default
-				BYTE r = pPixeles[ (tmpY*loadedSurface->pitch)+(tmpX*NumBytesPerPixel)+2 ];
-				BYTE g = pPixeles[ (tmpY*loadedSurface->pitch)+(tmpX*NumBytesPerPixel)+1 ];
-				BYTE b = pPixeles[ (tmpY*loadedSurface->pitch)+(tmpX*NumBytesPerPixel)+0 ];
-
-				//Revisamos que color fue el encontrado y establecemos el valor en el mapa
-				if(r == 0x00 && g == 0x00 && b == 0xFF)
-				{//Esto es Agua
-					tipoTerreno = TT_WATER;
-				}
-				else if(r == 0x00 && g == 0xFF && b == 0x00)
-				{//Esto es Pasto
-					tipoTerreno = TT_WALKABLE;
-				}
-				else if(r == 0xFF && g == 0xFF && b == 0x00)
-				{//Esto es Marsh
-					tipoTerreno = TT_MARSH;
-				}
-
-				//Establece el tipo final
-				setType(tmpX, tmpY, tipoTerreno);
+				DecodeImageChunk(loadedSurface, chunkX, chunkY);
 			}
 		}
+
+		//Registramos el cambio del mapa completo
+		markDirty( geMapRegion(0, 0, m_mapWidth-1, m_mapHeight-1) );
 	}
 
 	//Get rid of old loaded surface
@@ -434,6 +1431,51 @@ bool geTiledMap::LoadFromImageFile(SDL_Renderer* pRenderer, geString fileName)
 	return true;
 }
 
+void geTiledMap::DecodeImageChunk(const SDL_Surface* pSurface, const int32 chunkX, const int32 chunkY)
+{//Hace un barrido por la sección de la imagen que corresponde al chunk y establece los tipos de terreno según el color del pixel
+	//NOTA: Esta función puede llamarse desde un hilo de carga, por lo que no debe tocar el renderer ni las texturas
+	GEE_ASSERT(pSurface);
+	GEE_ASSERT( (chunkX>=0) && (chunkX<m_numChunksX) && (chunkY>=0) && (chunkY<m_numChunksY) );
+
+	int32 NumBytesPerPixel = pSurface->pitch/pSurface->w;
+	const BYTE* pPixeles = (const BYTE*)pSurface->pixels;
+
+	//Calculamos el área del chunk limitándola al tamaño del mapa
+	int32 iniX = chunkX<<MAP_CHUNK_BITS;
+	int32 iniY = chunkY<<MAP_CHUNK_BITS;
+	int32 finX = Min(iniX+MAP_CHUNK_SIZE, m_mapWidth);
+	int32 finY = Min(iniY+MAP_CHUNK_SIZE, m_mapHeight);
+
+	for(int32 tmpY=iniY; tmpY<finY; tmpY++)
+	{
+		uint8* pTypeRow = &m_typePlane[getTileIndex(0, tmpY)];
+		for(int32 tmpX=iniX; tmpX<finX; tmpX++)
+		{
+			uint8 tipoTerreno = TT_OBSTACLE;	//Tipo Default
+			BYTE r = pPixeles[ (tmpY*pSurface->pitch)+(tmpX*NumBytesPerPixel)+2 ];
+			BYTE g = pPixeles[ (tmpY*pSurface->pitch)+(tmpX*NumBytesPerPixel)+1 ];
+			BYTE b = pPixeles[ (tmpY*pSurface->pitch)+(tmpX*NumBytesPerPixel)+0 ];
+
+			//Revisamos que color fue el encontrado y establecemos el valor en el mapa
+			if(r == 0x00 && g == 0x00 && b == 0xFF)
+			{//Esto es Agua
+				tipoTerreno = TT_WATER;
+			}
+			else if(r == 0x00 && g == 0xFF && b == 0x00)
+			{//Esto es Pasto
+				tipoTerreno = TT_WALKABLE;
+			}
+			else if(r == 0xFF && g == 0xFF && b == 0x00)
+			{//Esto es Marsh
+				tipoTerreno = TT_MARSH;
+			}
+
+			//Establece el tipo final
+			pTypeRow[tmpX] = tipoTerreno;
+		}
+	}
+}
+
 bool geTiledMap::SaveToImageFile(SDL_Renderer*, geString)
 {
 	return false;
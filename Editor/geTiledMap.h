@@ -7,6 +7,19 @@
 *********************************************************************/
 #pragma once
 
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include <SDL.h>
+#include "geMapViewSpans.h"
+#include "geRenderQueue.h"
+#include "geOverlayBatch.h"
+#include "geTexture.h"
+#include "geTextureLoader.h"
+#include "geTextureManager.h"
+#include "geTerrainAtlas.h"
+#include "geTerrainChunkCache.h"
+
 /************************************************************************************************************************/
 /* Definición de constantes                                             												*/
 /************************************************************************************************************************/
@@ -39,6 +52,20 @@
 	#define BITSFT_TILEHALFSIZE_Y 5
 #endif
 
+//Tamaño de los chunks del mapa (bloques de tiles que se cargan y procesan como una unidad)
+#define MAP_CHUNK_BITS 4
+#define MAP_CHUNK_SIZE (1<<MAP_CHUNK_BITS)
+#define MAP_CHUNK_MASK (MAP_CHUNK_SIZE-1)
+
+//Clearance máximo que se calcula por tile (limita el área que debe recalcularse despues de un cambio)
+#define MAP_MAX_CLEARANCE 16
+
+//Número de entradas que guarda el journal de cambios del mapa (debe ser potencia de 2)
+#define MAP_JOURNAL_SIZE 256
+
+//Color (ARGB) de la textura provisional con la que se imprime el terreno mientras se cargan sus imágenes
+#define MAP_PLACEHOLDER_COLOR 0xFF404040
+
 //Enumerador para los tipos de terreno
 enum eTerrainTypes
 {
@@ -49,52 +76,91 @@ enum eTerrainTypes
 	TT_NUM_OBJECTS
 };
 
+//Enumerador para las clases de movimiento de las unidades (cada clase tiene su propia tabla de costos por tipo de terreno)
+enum eMovementClass
+{
+	MC_INFANTRY = 0,
+	MC_VEHICLE,
+	MC_HOVER,
+	MC_NAVAL,
+	MC_NUM_CLASSES
+};
+
+//Costo que indica que una clase de movimiento no puede pasar por un terreno
+#define MAP_COST_IMPASSABLE 127
+
+//Valor de costo que indica que un tile no tiene un costo especial y usa el de la tabla de su terreno
+#define MAP_COST_NO_OVERRIDE 0
+
+/************************************************************************************************************************/
+/* Estructura que describe una región rectangular del mapa (coordenadas en tiles, los límites son inclusivos)			*/
+/************************************************************************************************************************/
+struct geMapRegion
+{
+	int32 minX, minY;
+	int32 maxX, maxY;
+
+	geMapRegion() : minX(0), minY(0), maxX(-1), maxY(-1) {}
+	geMapRegion(const int32 x0, const int32 y0, const int32 x1, const int32 y1) : minX(x0), minY(y0), maxX(x1), maxY(y1) {}
+
+	bool isEmpty() const { return (maxX < minX) || (maxY < minY); }
+	int32 getWidth() const { return maxX-minX+1; }
+	int32 getHeight() const { return maxY-minY+1; }
+
+	bool Intersects(const geMapRegion& rhs) const
+	{//Indica si dos regiones comparten al menos un tile
+		return (minX <= rhs.maxX) && (rhs.minX <= maxX) && (minY <= rhs.maxY) && (rhs.minY <= maxY);
+	}
+
+	bool Contains(const geMapRegion& rhs) const
+	{//Indica si la región enviada está completamente dentro de esta
+		return (minX <= rhs.minX) && (rhs.maxX <= maxX) && (minY <= rhs.minY) && (rhs.maxY <= maxY);
+	}
+
+	void Merge(const geMapRegion& rhs)
+	{//Extiende esta región para que contenga también a la región enviada
+		if( rhs.isEmpty() ) return;
+		if( isEmpty() ) { *this = rhs; return; }
+		minX = Min(minX, rhs.minX); minY = Min(minY, rhs.minY);
+		maxX = Max(maxX, rhs.maxX); maxY = Max(maxY, rhs.maxY);
+	}
+
+	void Expand(const int32 tiles)
+	{//Crece la región el número de tiles indicado hacia todos los lados
+		minX -= tiles; minY -= tiles;
+		maxX += tiles; maxY += tiles;
+	}
+
+	void Clip(const int32 width, const int32 height)
+	{//Limita la región al área de un mapa del tamaño indicado
+		minX = Max(minX, 0); minY = Max(minY, 0);
+		maxX = Min(maxX, width-1); maxY = Min(maxY, height-1);
+	}
+};
+
+/************************************************************************************************************************/
+/* Estructura con una copia de un bloque rectangular de tiles (usada para copiar y pegar secciones del mapa)				*/
+/************************************************************************************************************************/
+struct geMapBlock
+{
+	int32 width, height;				//Tamaño del bloque en tiles
+	std::vector<uint8> types;			//Tipos de terreno del bloque (filas contiguas de longitud width)
+	std::vector<int8> costs;			//Costos especiales del bloque, MAP_COST_NO_OVERRIDE si el tile usa el costo de su terreno (filas contiguas de longitud width)
+
+	geMapBlock() : width(0), height(0) {}
+};
+
 /************************************************************************************************************************/
 /* Declaración de la clase geTiledMap                                      												*/
 /************************************************************************************************************************/
 class geTiledMap
 {
-	/************************************************************************************************************************/
-	/* Definición de una clase para el manejo de tiles                         												*/
-	/************************************************************************************************************************/
-	class MapTile
-	{
-	public:
-		/************************************************************************************************************************/
-		/* Declaración de constructores y destructor		                       												*/
-		/************************************************************************************************************************/
-		MapTile(void);									//Constructor standard
-		MapTile(const int8 idType, const int8 cost);		//Constructor con parámetro de costo
-		MapTile(const MapTile& copy);					//Constructor copia
-		
-		/************************************************************************************************************************/
-		/* Declaración de operadores                                            												*/
-		/************************************************************************************************************************/
-		MapTile& operator=(const MapTile& rhs);
-
-		/************************************************************************************************************************/
-		/* Declaración de funciones de acceso                                   												*/
-		/************************************************************************************************************************/
-		FORCEINLINE uint8 getType() const { return m_idType; }
-		void setType(const int8 idType) { m_idType = idType; }
-
-		FORCEINLINE int8 getCost() const { return m_cost; }
-		void setCost(const int8 cost) { m_cost = cost; }
-
-		/************************************************************************************************************************/
-		/* Declaración de variables miembro de la clase                         												*/
-		/************************************************************************************************************************/
-	private:
-		uint8 m_idType;		//Id del tipo de tile que se est
-		int8 m_cost;		//Costo de este tile (De momento estamos usando 8 bits pero bien puede ser cualquier tipo de entero)
-	};
-
 	/************************************************************************************************************************/
 	/* Definición de Constructores y Destructores de la clase               												*/
 	/************************************************************************************************************************/
 public:
 	geTiledMap(void);											//Constructor standard
-	geTiledMap(SDL_Renderer* pRenderer, const int32 mapSize);	//Constructor con parámetros
+	geTiledMap(SDL_Renderer* pRenderer, const int32 mapWidth, const int32 mapHeight);	//Constructor con parámetros
 	~geTiledMap(void);											//Destructor
 
 	/************************************************************************************************************************/
@@ -102,24 +168,85 @@ public:
 	/************************************************************************************************************************/
 public:
 	//Inicialización y destrucción
-	bool Init(SDL_Renderer* pRenderer, const int32 mapSize);
+	bool Init(SDL_Renderer* pRenderer, const int32 mapWidth, const int32 mapHeight);	//pRenderer puede ser NULL para usar solo los datos del mapa (el mapa no podrá imprimirse)
 	void Destroy();
 
 	//Actualización de lógica y render
-	void Update(float deltaTime);
-	void Render();
+	void Update(float deltaTime);		//Registra los chunks cargados, recalcula los datos derivados y cambia la textura provisional del terreno por las imágenes que ya se subieron
+	void Render(geRenderQueue& queue);	//Agrega los comandos de dibujo del terreno y el grid (no llama a SDL)
+	bool isTerrainLoading() const;		//Las imágenes del terreno aún se están decodificando o subiendo (mientras tanto se imprime una textura provisional)
+
+	//Funciones de acceso a las dimensiones del mapa
+	int32 getMapWidth() const { return m_mapWidth; }
+	int32 getMapHeight() const { return m_mapHeight; }
+	int32 getMapStride() const { return 1<<m_strideShift; }			//Número de tiles por fila en memoria (potencia de 2 mayor o igual al ancho)
+	int32 getMapStrideShift() const { return m_strideShift; }		//Log2 del stride, para convertir coordenadas a índice con un shift
+
+	//Funciones de conversión entre coordenadas e índices de tile (el índice es válido para todos los planos del mapa)
+	FORCEINLINE int32 getTileIndex(const int32 x, const int32 y) const { return (y<<m_strideShift)+x; }
+	FORCEINLINE int32 getTileIndexX(const int32 index) const { return index & m_strideMask; }
+	FORCEINLINE int32 getTileIndexY(const int32 index) const { return index>>m_strideShift; }
+	FORCEINLINE bool isInside(const int32 x, const int32 y) const { return ((uint32)x < (uint32)m_mapWidth) && ((uint32)y < (uint32)m_mapHeight); }
 
-	int32 getMapSize() const { return m_mapSize; }
+	//Acceso de solo lectura a las filas de los planos (para los sistemas que recorren el mapa completo sin pagar un assert por tile)
+	FORCEINLINE const uint8* getTypeRow(const int32 y) const { return &m_typePlane[y<<m_strideShift]; }
+	void ReadCostOverrides(const int32 x, const int32 y, const int32 count, int8* pCosts) const;	//Copia los costos especiales de un tramo de fila (MAP_COST_NO_OVERRIDE donde no hay)
+
+	//Funciones de clearance por clase de movimiento (tamaño del cuadro más grande de tiles transitables para la clase cuya esquina superior izquierda es el tile, limitado a MAP_MAX_CLEARANCE)
+	FORCEINLINE uint8 getClearance(const eMovementClass mc, const int32 x, const int32 y) const { return getClearanceRow(mc, y)[x]; }
+	FORCEINLINE const uint8* getClearanceRow(const eMovementClass mc, const int32 y) const { return &m_clearancePlanes[((mc*m_mapHeight)+y)<<m_strideShift]; }
+
+	//Funciones de transitabilidad por clase de movimiento (un bit por tile, 64 tiles por palabra, los bits fuera del mapa son 0)
+	//Un tile es transitable si su costo para la clase no es MAP_COST_IMPASSABLE (tomando en cuenta los costos especiales)
+	FORCEINLINE bool isPassable(const eMovementClass mc, const int32 x, const int32 y) const { return ((getPassabilityRow(mc, y)[x>>6] >> (x&63)) & 1) != 0; }
+	FORCEINLINE const uint64* getPassabilityRow(const eMovementClass mc, const int32 y) const { return &m_passabilityPlanes[((mc*m_mapHeight)+y)*m_passabilityRowWords]; }
+	int32 getPassabilityRowWords() const { return m_passabilityRowWords; }	//Número de palabras de 64 bits por fila
 	
 	//Funciones de carga y salvado del mapa
 	bool LoadFromImageFile(SDL_Renderer* pRenderer, geString fileName);
 	bool SaveToImageFile(SDL_Renderer* pRenderer, geString fileName);
+	void DecodeImageChunk(const SDL_Surface* pSurface, const int32 chunkX, const int32 chunkY);	//Establece los tipos de terreno de un chunk a partir de los pixeles de una imagen
+
+	//Funciones de disponibilidad de chunks (permiten usar las partes ya cargadas de un mapa mientras se carga el resto)
+	int32 getNumChunksX() const { return m_numChunksX; }
+	int32 getNumChunksY() const { return m_numChunksY; }
+	bool isChunkReady(const int32 chunkX, const int32 chunkY) const { return m_chunkReady[(chunkY*m_numChunksX)+chunkX] != 0; }
+	bool isTileReady(const int32 x, const int32 y) const { return isChunkReady(x>>MAP_CHUNK_BITS, y>>MAP_CHUNK_BITS); }
+	bool isFullyLoaded() const { return m_numChunksReady == (m_numChunksX*m_numChunksY); }
+	bool isEditable() const { return isFullyLoaded(); }			//Las ediciones se rechazan mientras el hilo de carga sigue escribiendo tiles (la carga las sobreescribiría)
+	void publishChunk(const int32 chunkX, const int32 chunkY);	//Marca un chunk como listo para usarse (puede llamarse desde un hilo de carga)
+	void setAllChunksReady(const bool bReady);					//Marca todos los chunks como listos o pendientes de carga
 
-	int8 getCost(const int32 x, const int32 y) const;
-	void setCost(const int32 x, const int32 y, const int8 cost);
+	//Funciones del journal de cambios (permiten a los objetos derivados del mapa actualizarse solo en las regiones que cambiaron)
+	uint32 getVersion() const { return m_version; }				//Versión actual del mapa, aumenta con cada cambio y nunca regresa
+	uint32 getChunkVersion(const int32 chunkX, const int32 chunkY) const { return m_chunkVersion[(chunkY*m_numChunksX)+chunkX]; }	//Versión del último cambio hecho dentro del chunk
+	bool getDirtyRegionsSince(const uint32 sinceVersion, std::vector<geMapRegion>& regions) const;	//Agrega a la lista las regiones modificadas despues de la versión indicada, regresa false si el journal ya no cubre esa versión y debe reconstruirse todo
+	void markDirty(const geMapRegion& region);					//Registra un cambio en la región indicada (las funciones de edición del mapa lo llaman automáticamente)
+	void FlushDerivedPlanes();									//Recalcula la transitabilidad y el clearance de lo modificado desde la última llamada (Update() y el fin de cada edición lo llaman)
+
+	//Funciones de edición en bloque (cada operación escribe directamente sobre los planos y registra un solo cambio en el journal)
+	void FillRect(const geMapRegion& region, const uint8 idtype);		//Establece el tipo de terreno de todos los tiles de la región
+	void FillCostRect(const geMapRegion& region, const int8 cost);		//Establece el costo especial de todos los tiles de la región (MAP_COST_NO_OVERRIDE lo elimina)
+	void StampBrush(const int32 x, const int32 y, const uint8* pMask, const int32 maskWidth, const int32 maskHeight, const uint8 idtype);	//Establece el tipo de los tiles donde la máscara (centrada en x,y) sea distinta de 0
+	geMapRegion FloodFill(const int32 x, const int32 y, const uint8 idtype);	//Cambia el tipo de la zona conectada del mismo tipo que el tile inicial, regresa la región afectada
+	void CopyBlock(const geMapRegion& region, geMapBlock& block) const;		//Copia los tiles de la región al bloque indicado
+	void PasteBlock(const int32 x, const int32 y, const geMapBlock& block);	//Escribe el bloque en el mapa con su esquina superior izquierda en x,y
+
+	//Funciones de costos (el costo de un tile es el de la tabla de su terreno, a menos que tenga un costo especial)
+	int8 getCost(const int32 x, const int32 y, const eMovementClass mc = MC_INFANTRY) const;
+	void setCost(const int32 x, const int32 y, const int8 cost);		//Establece un costo especial para el tile (MAP_COST_NO_OVERRIDE lo elimina)
+	int8 getCostOverride(const int32 x, const int32 y) const;			//Regresa el costo especial del tile o MAP_COST_NO_OVERRIDE
+	FORCEINLINE bool hasCostOverride(const int32 x, const int32 y) const { int32 index = getTileIndex(x, y); return ((m_costOverrideBits[index>>6] >> (index&63)) & 1) != 0; }
+
+	int8 getTerrainCost(const eMovementClass mc, const uint8 idtype) const { return m_terrainCost[mc][idtype]; }
+	const int8* getTerrainCostTable(const eMovementClass mc) const { return m_terrainCost[mc]; }	//Tabla indexada por tipo de terreno (los walkers leen el tipo del tile y buscan aquí su costo)
+	void setTerrainCost(const eMovementClass mc, const uint8 idtype, const int8 cost);			//Cambia el costo de un terreno para todo el mapa (no cambia la versión del mapa, solo la de la tabla de la clase)
+	uint32 getCostVersion(const eMovementClass mc) const { return m_costVersion[mc]; }			//Versión de la tabla de costos de la clase (aumenta con cada cambio, para los objetos que dependen de los costos)
+	void setDefaultTerrainCosts();																//Establece la tabla de costos por default
 
 	int8 getType(const int32 x, const int y) const;
 	void setType(const int32 x, const int32 y, const uint8 idtype);
+	static FORCEINLINE uint8 ValidateType(const uint8 idtype) { return (idtype < TT_NUM_OBJECTS) ? idtype : (uint8)TT_OBSTACLE; }	//Los tipos desconocidos se guardan como obstáculo (las tablas por tipo solo tienen TT_NUM_OBJECTS entradas)
 
 	void setStart(const uint16 x, const uint16 y) { m_startX = x; m_startY = y; PreCalc(); }
 	void getStart(uint16 &x, uint16 &y) const { x = m_startX; y = m_startY; }
@@ -132,11 +259,11 @@ public:
 		m_PreCalc_MidResolutionX = (uint16)DivX2(m_endX-m_startX);
 		m_PreCalc_MidResolutionY = (uint16)DivX2(m_endY-m_startY);
 #ifdef MAP_IS_ISOMETRIC	//Estos cálculos aplican solo en el caso de un mapa isométrico
-		m_PreCalc_MaxCameraCoordX = DivX2(m_mapSize*TILESIZE_X);
+		m_PreCalc_MaxCameraCoordX = DivX2(m_mapWidth*TILESIZE_X);
 #else	//Estos cálculos aplican solo en el caso de un mapa cuadrado
-		m_PreCalc_MaxCameraCoordX = m_mapSize*TILESIZE_X;
+		m_PreCalc_MaxCameraCoordX = m_mapWidth*TILESIZE_X;
 #endif
-		m_PreCalc_MaxCameraCoordY = m_mapSize*TILESIZE_Y;
+		m_PreCalc_MaxCameraCoordY = m_mapHeight*TILESIZE_Y;
 	}
 
 	void moveCamera(const float dx, const float dy);	//Desplaza la posición de la cámara (defazamientos flotantes para poder manejar ligeros defazamientos y manejar una velocidad independiente al framerate)
@@ -146,13 +273,78 @@ public:
 
 	void getScreenToMapCoords(const int32 scrX, const int32 scrY, int32 &mapX, int32 &mapY);	//Convierte coordenadas de pantalla a coordenadas de mapa
 	void getMapToScreenCoords(const int32 mapX, const int32 mapY, int32 &scrX, int32 &scrY);	//Convierte coordenadas de mapa a coordenadas de pantalla
+
+	//Versiones en lote de las conversiones (8 puntos a la vez con AVX2 o 4 con SSE2 según el procesador, mismos resultados que las versiones de un punto)
+	void getScreenToMapCoords(const int32* pScrX, const int32* pScrY, int32* pMapX, int32* pMapY, const int32 count);
+	void getMapToScreenCoords(const int32* pMapX, const int32* pMapY, int32* pScrX, int32* pScrY, const int32 count);
+
+	int32 ComputeVisibleSpans(std::vector<geMapRowSpan>& spans) const;	//Llena la lista con los rangos de tiles visibles de cada fila en el área de impresión, regresa el número de tiles
+	geOverlayKey getOverlayKey(const uint32 contentVersion) const;		//Llave de cache de las líneas de depuración en pantalla con la cámara y el mapa actuales
+
+	void setShowGrid(const bool bShow) { m_bShowGrid = bShow; }
+	bool getShowGrid() const { return m_bShowGrid; }
+
+	SDL_Texture* getTerrainSource(const uint8 idtype, const int32 x, const int32 y, SDL_Rect& src)
+	{//Textura y región con la que se imprime el tile x,y de un tipo de terreno (del atlas si se pudo crear)
+		GEE_ASSERT(idtype < TT_NUM_OBJECTS);
+		if( m_terrainAtlas.isValid() )
+		{
+			m_terrainAtlas.getSource(idtype, x<<BITSFT_TILESIZE_X, y<<BITSFT_TILESIZE_Y, TILESIZE_X, TILESIZE_Y, src);
+			return m_terrainAtlas.getTexture();
+		}
+		src.x = (x<<BITSFT_TILESIZE_X) % m_mapTextures[idtype]->GetWidth();
+		src.y = (y<<BITSFT_TILESIZE_Y) % m_mapTextures[idtype]->GetHeight();
+		src.w = TILESIZE_X;
+		src.h = TILESIZE_Y;
+		return m_mapTextures[idtype]->GetSDLTexture();
+	}
+	geTerrainChunkCache& getChunkCache() { return m_chunkCache; }	//Cache de texturas de chunks del terreno
+
+private:
+	void UpdatePassability(const eMovementClass mc, const geMapRegion& region);	//Recalcula los bits de transitabilidad de una clase de movimiento dentro de la región
+	void UpdateClearance(const eMovementClass mc, const geMapRegion& region);	//Recalcula el clearance de una clase en los tiles que pueden depender de la región modificada
+	void UpdateDerivedPlanes(const geMapRegion& region);	//Recalcula la transitabilidad y el clearance de todas las clases dentro de la región
+	void setCostOverride(const int32 index, const int8 cost);	//Escribe o borra el costo especial de un tile (sin registrar el cambio)
+	void BuildGridOverlay(const geOverlayKey& key, const int32 tileIniX, const int32 tileIniY, const int32 tileFinX, const int32 tileFinY);	//Genera las líneas del grid del área visible
+	void CreatePlaceholderTexture();		//Crea (o toma del cache) la textura provisional del terreno
+	void UpdateTerrainTextures();			//Revisa las cargas asíncronas del atlas y de las texturas por tipo
 	/************************************************************************************************************************/
 	/* Definición de variables miembro                                      												*/
 	/************************************************************************************************************************/
 private:
 	//Datos del mapa
-	MapTile **m_mapGrid;				//Información del mapa
-	int32 m_mapSize;					//Tamaño del mapa
+	//NOTA: Cada dato del tile se guarda en un plano contiguo con filas de longitud potencia de 2, así el índice de un tile se calcula con un shift y sus coordenadas con un shift y una máscara
+	uint8 *m_typePlane;					//Plano con el tipo de terreno de cada tile
+	uint64 *m_costOverrideBits;			//Plano de bits que indica que tiles tienen un costo especial
+	std::map<int32, int8> m_costOverrides;	//Costos especiales indexados por índice de tile (son pocos, así que no se guarda un plano completo)
+	int8 m_terrainCost[MC_NUM_CLASSES][TT_NUM_OBJECTS];	//Tabla de costos por clase de movimiento y tipo de terreno
+	uint32 m_costVersion[MC_NUM_CLASSES];	//Versión de la tabla de costos de cada clase
+	uint8 *m_clearancePlanes;			//Planos con el clearance de cada tile, uno por clase de movimiento (se mantienen actualizados en las regiones que cambian)
+	uint64 *m_passabilityPlanes;		//Planos de bits de transitabilidad, uno por clase de movimiento (se mantienen actualizados en las regiones que cambian)
+	int32 m_passabilityRowWords;		//Número de palabras de 64 bits por fila en los planos de transitabilidad
+	int32 m_mapWidth;					//Ancho del mapa en tiles
+	int32 m_mapHeight;					//Alto del mapa en tiles
+	int32 m_strideShift;				//Log2 de la longitud de una fila en los planos
+	int32 m_strideMask;					//Máscara para obtener la coordenada X a partir de un índice
+
+	//Datos de disponibilidad de los chunks del mapa
+	volatile LONG *m_chunkReady;		//Bandera por chunk que indica si sus tiles ya pueden leerse (se escribe de forma atómica desde el hilo de carga)
+	volatile LONG m_numChunksReady;		//Número de chunks que ya están listos
+	int32 m_numChunksX, m_numChunksY;	//Número de chunks en cada eje
+	LONG m_numChunksJournaled;			//Número de chunks publicados cuyo cambio ya se registró en el journal
+
+	//Datos del journal de cambios
+	struct MapChange
+	{
+		uint32 version;					//Versión del mapa que generó este cambio
+		geMapRegion region;				//Región afectada
+	};
+	uint32 m_version;					//Versión actual del mapa
+	uint32 *m_chunkVersion;				//Versión del último cambio de cada chunk
+	MapChange m_journal[MAP_JOURNAL_SIZE];	//Buffer circular con los últimos cambios
+	uint32 m_journalCount;				//Número total de cambios escritos al journal (el índice de escritura es m_journalCount & (MAP_JOURNAL_SIZE-1))
+	uint32 m_journalBaseVersion;		//Versión más antigua que el journal todavía puede responder
+	geMapRegion m_pendingDerived;		//Región modificada cuyos datos derivados aún no se recalculan
 
 	//Variables de control de cámara
 	int32 m_iCameraX, m_iCameraY;		//Punto inicial de la cámara (en pixeles, no en tiles)
@@ -175,5 +367,13 @@ private:
 
 	//Variables para rendereo
 	SDL_Renderer *m_pRenderer;			//Renderer asociado con este objeto
-	geTexture *m_mapTextures;			//Texturas de mapas (de momento una textura de 512x512 para cada tipo, que se utilizará en pedazos de 32x32)
+	geTextureHandle m_mapTextures[TT_NUM_OBJECTS];	//Texturas de mapas (de momento una textura de 512x512 para cada tipo, que se utilizará en pedazos de 32x32), la provisional mientras no se suben
+	geTextureHandle m_pendingTextures[TT_NUM_OBJECTS];	//Cargas asíncronas de las texturas por tipo (solo si no se pudo crear el atlas)
+	geTextureHandle m_placeholderTexture;	//Textura provisional del tamaño de un tile
+	geTerrainAtlas m_terrainAtlas;		//Imágenes de todos los tipos de terreno en una sola textura (si no se pudo crear se usan m_mapTextures)
+	std::vector<int32> m_batchMapX, m_batchMapY;	//Coordenadas de mapa de una columna de tiles para convertirlas en lote durante el rendereo
+	std::vector<int32> m_batchScrX, m_batchScrY;	//Coordenadas de pantalla resultantes
+	std::vector<geMapRowSpan> m_viewSpans;			//Rangos de tiles visibles de cada fila en el último rendereo
+	geTerrainChunkCache m_chunkCache;				//Terreno pre-rendereado por chunk (si el renderer no soporta render targets se imprime tile por tile)
+	geOverlayBatch m_gridOverlay;					//Líneas del grid en pantalla (se regeneran solo si se mueve la cámara o cambia el mapa)
 };
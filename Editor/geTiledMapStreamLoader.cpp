@@ -0,0 +1,168 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geTiledMapStreamLoader.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geTiledMapStreamLoader
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geTiledMapStreamLoader.h"
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geTiledMapStreamLoader::geTiledMapStreamLoader(void)
+{//Constructor standard
+	m_pMap = NULL;
+	m_pRenderer = NULL;
+	m_pSurface = NULL;
+	m_state = LS_IDLE;
+	m_numChunksDone = 0;
+
+	//Creamos el evento de sincronización (con reinicio automático)
+	m_hGridReadyEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	GEE_ASSERT(m_hGridReadyEvent);
+}
+
+geTiledMapStreamLoader::~geTiledMapStreamLoader(void)
+{//Destructor
+	//El hilo de trabajo debe terminar antes de destruir los objetos que utiliza
+	Cancel();
+
+	if( m_hGridReadyEvent != NULL )
+	{
+		CloseHandle(m_hGridReadyEvent);
+		m_hGridReadyEvent = NULL;
+	}
+}
+
+bool geTiledMapStreamLoader::BeginLoad(geTiledMap* pMap, SDL_Renderer* pRenderer, const geString& fileName)
+{//Comienza la carga asíncrona del archivo de mapa
+	GEE_ASSERT(pMap);
+	GEE_ASSERT(pRenderer);
+
+	//Si había una carga en proceso la cancelamos primero
+	Cancel();
+
+	m_pMap = pMap;
+	m_pRenderer = pRenderer;
+	m_fileName = fileName;
+	m_numChunksDone = 0;
+	ResetEvent(m_hGridReadyEvent);
+	setState(LS_DECODING_IMAGE);
+
+	if( !Start() )
+	{//No pudimos crear el hilo de trabajo
+		GEE_WARNING(TEXT("geTiledMapStreamLoader::BeginLoad: Falló al crear el hilo de carga para ") + fileName);
+		setState(LS_FAILED);
+		return false;
+	}
+
+	return true;
+}
+
+void geTiledMapStreamLoader::Cancel()
+{//Detiene la carga actual
+	RequestStop();
+
+	//Despertamos al hilo en caso de que esté esperando al mapa y esperamos a que termine
+	SetEvent(m_hGridReadyEvent);
+	Join();
+
+	if( isLoading() )
+	{//La carga no terminó, así que la marcamos como fallida
+		//NOTA: Los chunks que no se publicaron quedan marcados como no listos, el mapa sigue siendo válido pero incompleto
+		setState(LS_FAILED);
+	}
+}
+
+bool geTiledMapStreamLoader::Update()
+{//Avanza la carga desde el hilo principal
+	bool bMapReinitialized = false;
+
+	if( m_state == LS_WAITING_FOR_GRID )
+	{//La imagen ya está decodificada, alojamos el mapa aquí ya que Init() carga texturas con el renderer
+		GEE_ASSERT(m_pSurface);
+		if( !m_pMap->Init(m_pRenderer, m_pSurface->w, m_pSurface->h) )
+		{//Ocurrió un error al inicializar la información del mapa
+			GEE_WARNING(TEXT("geTiledMapStreamLoader::Update: Falló al inicializar la información del mapa ") + m_fileName);
+			RequestStop();
+		}
+		else
+		{//El mapa está listo, todos sus chunks quedan pendientes hasta que el hilo de trabajo los publique
+			m_pMap->setAllChunksReady(false);
+			setState(LS_STREAMING_CHUNKS);
+			bMapReinitialized = true;
+		}
+
+		//Dejamos continuar al hilo de trabajo
+		SetEvent(m_hGridReadyEvent);
+	}
+
+	if( m_state == LS_FINISHED || m_state == LS_FAILED )
+	{//El hilo ya terminó su trabajo, liberamos su manejador
+		Join();
+	}
+
+	return bMapReinitialized;
+}
+
+float geTiledMapStreamLoader::getProgress() const
+{//Regresa el porcentaje de chunks publicados
+	if( m_state == LS_FINISHED )
+	{
+		return 1.0f;
+	}
+
+	if( m_state != LS_STREAMING_CHUNKS )
+	{
+		return 0.0f;
+	}
+
+	int32 numChunks = m_pMap->getNumChunksX()*m_pMap->getNumChunksY();
+	return numChunks > 0 ? (float)m_numChunksDone / (float)numChunks : 0.0f;
+}
+
+uint32 geTiledMapStreamLoader::Run()
+{//Función del hilo de trabajo
+	//Decodificamos la imagen completa (esta es la parte más costosa de la carga)
+#if PLATFORM_TCHAR_IS_1_BYTE == 1
+	m_pSurface = IMG_Load( m_fileName.c_str() );
+#else
+	m_pSurface = IMG_Load( ws2s(m_fileName).c_str() );
+#endif // PLATFORM_TCHAR_IS_1_BYTE == 1
+	if( m_pSurface == NULL )
+	{//Si falló en cargar la superficie
+		GEE_WARNING(TEXT("geTiledMapStreamLoader::Run: Falló al cargar el archivo ") + m_fileName);
+		setState(LS_FAILED);
+		return 1;
+	}
+
+	//Pedimos al hilo principal que aloje el mapa y esperamos a que termine
+	setState(LS_WAITING_FOR_GRID);
+	WaitForSingleObject(m_hGridReadyEvent, INFINITE);
+
+	if( !IsStopRequested() )
+	{//Llenamos los chunks en orden y los publicamos en cuanto terminan
+		for(int32 chunkY=0; chunkY<m_pMap->getNumChunksY() && !IsStopRequested(); chunkY++)
+		{
+			for(int32 chunkX=0; chunkX<m_pMap->getNumChunksX() && !IsStopRequested(); chunkX++)
+			{
+				m_pMap->DecodeImageChunk(m_pSurface, chunkX, chunkY);
+				m_pMap->publishChunk(chunkX, chunkY);
+				InterlockedIncrement(&m_numChunksDone);
+			}
+		}
+	}
+
+	//Nos deshacemos de la imagen decodificada
+	SDL_FreeSurface( m_pSurface );
+	m_pSurface = NULL;
+
+	setState(IsStopRequested() ? LS_FAILED : LS_FINISHED);
+	return 0;
+}
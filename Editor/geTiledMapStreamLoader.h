@@ -0,0 +1,76 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geTiledMapStreamLoader.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geTiledMapStreamLoader
+				Carga un mapa desde un archivo de imagen en un hilo
+				de trabajo, publicando cada chunk del mapa en cuanto
+				termina de decodificarse para que el render y el
+				pathfinding puedan usar la parte ya cargada
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geTiledMap.h"
+
+/************************************************************************************************************************/
+/* Declaración de la clase geTiledMapStreamLoader                       												*/
+/************************************************************************************************************************/
+class geTiledMapStreamLoader : public geThread
+{
+	/************************************************************************************************************************/
+	/* Tipo definido enumerador para reconocer los estados de la carga														*/
+	/************************************************************************************************************************/
+public:
+	typedef enum LOADSTATE
+	{
+		LS_IDLE,					//No hay ninguna carga en proceso
+		LS_DECODING_IMAGE,			//El hilo de trabajo está decodificando el archivo de imagen
+		LS_WAITING_FOR_GRID,		//La imagen fue decodificada y esperamos a que el hilo principal aloje el mapa
+		LS_STREAMING_CHUNKS,		//El hilo de trabajo está llenando y publicando los chunks del mapa
+		LS_FINISHED,				//Todos los chunks fueron publicados
+		LS_FAILED					//Ocurrió un error durante la carga
+	}LOADSTATETYPE;
+
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geTiledMapStreamLoader(void);				//Constructor standard
+	virtual ~geTiledMapStreamLoader(void);		//Destructor (cancela cualquier carga en proceso)
+
+	/************************************************************************************************************************/
+	/* Funciones de control de la carga                                     												*/
+	/************************************************************************************************************************/
+public:
+	bool BeginLoad(geTiledMap* pMap, SDL_Renderer* pRenderer, const geString& fileName);	//Comienza la carga asíncrona del archivo indicado sobre el mapa
+	void Cancel();																			//Detiene la carga actual y espera a que termine el hilo de trabajo
+	bool Update();																			//Debe llamarse cada ciclo desde el hilo principal, regresa true si el mapa fue reinicializado en esta llamada
+
+	LOADSTATETYPE getState() const { return (LOADSTATETYPE)m_state; }
+	bool isLoading() const { return m_state != LS_IDLE && m_state != LS_FINISHED && m_state != LS_FAILED; }
+	float getProgress() const;																//Regresa el porcentaje de chunks publicados [0..1]
+
+protected:
+	virtual uint32 Run();						//Función del hilo de trabajo
+
+private:
+	void setState(const LOADSTATETYPE state) { InterlockedExchange(&m_state, state); }
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	geTiledMap *m_pMap;							//Mapa que estamos llenando
+	SDL_Renderer *m_pRenderer;					//Renderer con el que se inicializa el mapa
+	geString m_fileName;						//Archivo que estamos cargando
+
+	SDL_Surface *m_pSurface;					//Imagen decodificada (pertenece al hilo de trabajo hasta que termina)
+	HANDLE m_hGridReadyEvent;					//Evento que indica al hilo de trabajo que el mapa ya fue alojado
+
+	volatile LONG m_state;						//Estado actual de la carga (LOADSTATETYPE)
+	volatile LONG m_numChunksDone;				//Número de chunks publicados hasta ahora
+};
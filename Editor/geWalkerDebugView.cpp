@@ -0,0 +1,212 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geWalkerDebugView.cpp
+	Author:		Samuel Prince
+
+	Purpose:	Implementación de la clase geWalkerDebugView
+*********************************************************************/
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras necesarias para la compilación                												*/
+/************************************************************************************************************************/
+#include "stdafx.h"
+#include "geWalkerDebugView.h"
+
+/************************************************************************************************************************/
+/* Colores de los estados                                               												*/
+/************************************************************************************************************************/
+static const SDL_Color s_stateColors[WTS_NUM_STATES] =
+{
+	{ 0x00, 0x00, 0x00, 0x00 },		//WTS_NONE (transparente, borra lo que había)
+	{ 0x40, 0x80, 0xFF, 0xA0 },		//WTS_OPEN
+	{ 0x80, 0x80, 0x80, 0xA0 },		//WTS_CLOSED
+	{ 0xFF, 0xFF, 0x00, 0xD0 }		//WTS_PATH
+};
+
+/************************************************************************************************************************/
+/* Implementación de funciones de la clase                              												*/
+/************************************************************************************************************************/
+geWalkerDebugView::geWalkerDebugView(void)
+{//Constructor standard
+	m_pRenderer = NULL;
+	m_pMap = NULL;
+	m_pTarget = NULL;
+	m_targetWidth = m_targetHeight = 0;
+	m_bSupported = false;
+	m_bValid = false;
+	m_pWalker = NULL;
+	m_numDrawnTiles = 0;
+}
+
+geWalkerDebugView::~geWalkerDebugView(void)
+{//Destructor
+	Destroy();
+}
+
+bool geWalkerDebugView::Init(SDL_Renderer* pRenderer, geTiledMap* pMap)
+{//Asocia la visualización a un renderer y un mapa
+	GEE_ASSERT(pRenderer && pMap);
+
+	Destroy();
+	m_pRenderer = pRenderer;
+	m_pMap = pMap;
+	m_bSupported = (SDL_RenderTargetSupported(pRenderer) == SDL_TRUE);
+	return true;
+}
+
+void geWalkerDebugView::Destroy()
+{//Libera la textura
+	if( m_pTarget != NULL )
+	{
+		SDL_DestroyTexture(m_pTarget);
+		m_pTarget = NULL;
+	}
+	m_targetWidth = m_targetHeight = 0;
+	m_bValid = false;
+	m_pWalker = NULL;
+	m_pMap = NULL;
+	m_pRenderer = NULL;
+	m_rasterQueue.Clear();
+}
+
+const SDL_Color& geWalkerDebugView::getStateColor(const uint8 state)
+{
+	GEE_ASSERT(state < WTS_NUM_STATES);
+	return s_stateColors[state];
+}
+
+bool geWalkerDebugView::CheckTarget()
+{//La textura cubre exactamente el área de impresión del mapa (el inicio y el fin son inclusivos)
+	uint16 startX, startY, endX, endY;
+	m_pMap->getStart(startX, startY);
+	m_pMap->getEnd(endX, endY);
+	int32 width = Max( (int32)endX-(int32)startX+1, 1 );
+	int32 height = Max( (int32)endY-(int32)startY+1, 1 );
+
+	if( m_pTarget != NULL && width == m_targetWidth && height == m_targetHeight )
+	{
+		return true;
+	}
+
+	if( m_pTarget != NULL )
+	{
+		SDL_DestroyTexture(m_pTarget);
+	}
+	m_bValid = false;
+	m_pTarget = SDL_CreateTexture(m_pRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+	if( m_pTarget == NULL )
+	{
+		GEE_WARNING( TEXT("No se pudo crear la textura de depuración del pathfinding! SDL Error: ") + s2gs(SDL_GetError()) );
+		m_targetWidth = m_targetHeight = 0;
+		m_bSupported = false;	//Seguimos dibujando todo cada cuadro
+		return false;
+	}
+
+	SDL_SetTextureBlendMode(m_pTarget, SDL_BLENDMODE_BLEND);
+	m_targetWidth = width;
+	m_targetHeight = height;
+	return true;
+}
+
+void geWalkerDebugView::AddTile(geRenderQueue& queue, const int32 x, const int32 y, const uint8 state, const int32 offsetX, const int32 offsetY, const bool bDrawNone)
+{//Un rectángulo de medio tile centrado en el tile (en los mapas isométricos cabe dentro del rombo sin tocar a los vecinos)
+	if( state == WTS_NONE && !bDrawNone )
+	{
+		return;
+	}
+
+	int32 scrX, scrY;
+	m_pMap->getMapToScreenCoords(x, y, scrX, scrY);
+
+	SDL_Rect rect;
+	rect.x = scrX + (TILEHALFSIZE_X>>1) - offsetX;
+	rect.y = scrY + (TILEHALFSIZE_Y>>1) - offsetY;
+	rect.w = TILEHALFSIZE_X;
+	rect.h = TILEHALFSIZE_Y;
+	if( &queue == &m_rasterQueue )
+	{//Dentro de la textura descartamos lo que queda fuera (se dibujará cuando la cámara lo muestre y se redibuje todo)
+		if( rect.x >= m_targetWidth || rect.y >= m_targetHeight || rect.x+rect.w <= 0 || rect.y+rect.h <= 0 )
+		{
+			return;
+		}
+	}
+
+	queue.AddRect(RL_DEBUG, rect, s_stateColors[state], true);
+	++m_numDrawnTiles;
+}
+
+void geWalkerDebugView::AddVisibleTiles(geRenderQueue& queue, geMapGridWalker* pWalker, const int32 offsetX, const int32 offsetY)
+{//Recorre los tiles visibles y agrega los que tienen estado
+	m_pMap->ComputeVisibleSpans(m_spans);
+	for( SIZE_T i=0; i<m_spans.size(); ++i )
+	{
+		const geMapRowSpan& span = m_spans[i];
+		for( int32 iterX=span.iniX; iterX<=span.finX; ++iterX )
+		{
+			AddTile(queue, iterX, span.y, pWalker->getTileState(m_pMap->getTileIndex(iterX, span.y)), offsetX, offsetY, false);
+		}
+	}
+}
+
+void geWalkerDebugView::Render(geRenderQueue& queue, geMapGridWalker* pWalker, const int32 tileBudget)
+{//Dibuja solo lo que cambió desde el cuadro anterior
+	m_numDrawnTiles = 0;
+	if( m_pMap == NULL || pWalker == NULL || !pWalker->hasTileStates() )
+	{
+		return;
+	}
+
+	uint16 startX, startY;
+	m_pMap->getStart(startX, startY);
+
+	if( !m_bSupported || !CheckTarget() )
+	{//Sin render targets dibujamos todos los tiles visibles directamente en la lista del cuadro
+		AddVisibleTiles(queue, pWalker, 0, 0);
+		pWalker->PopChangedTiles(m_changedTiles, pWalker->getNumChangedTiles());	//Los cambios ya están reflejados
+		return;
+	}
+
+	m_rasterQueue.Clear();
+	bool bClear = false;
+	geOverlayKey key = m_pMap->getOverlayKey(pWalker->getTileStatesSerial());
+	if( !m_bValid || pWalker != m_pWalker || key != m_key )
+	{//La cámara, el mapa o la búsqueda cambiaron, redibujamos todos los tiles visibles
+		pWalker->PopChangedTiles(m_changedTiles, pWalker->getNumChangedTiles());
+		AddVisibleTiles(m_rasterQueue, pWalker, startX, startY);
+		m_key = key;
+		m_pWalker = pWalker;
+		m_bValid = true;
+		bClear = true;
+	}
+	else
+	{//Solo los tiles que cambiaron (los que no alcanzan quedan en la lista del walker para el siguiente cuadro)
+		pWalker->PopChangedTiles(m_changedTiles, tileBudget);
+		for( SIZE_T i=0; i<m_changedTiles.size(); ++i )
+		{
+			int32 index = m_changedTiles[i];
+			AddTile(m_rasterQueue, m_pMap->getTileIndexX(index), m_pMap->getTileIndexY(index), pWalker->getTileState(index), startX, startY, true);
+		}
+	}
+
+	if( bClear || m_rasterQueue.getNumCommands() > 0 )
+	{//Escribimos los colores sin mezclar, así WTS_NONE borra el tile
+		SDL_Texture* pPrevTarget = SDL_GetRenderTarget(m_pRenderer);
+		SDL_BlendMode prevBlendMode;
+		SDL_GetRenderDrawBlendMode(m_pRenderer, &prevBlendMode);
+
+		SDL_SetRenderTarget(m_pRenderer, m_pTarget);
+		SDL_SetRenderDrawBlendMode(m_pRenderer, SDL_BLENDMODE_NONE);
+		if( bClear )
+		{
+			SDL_SetRenderDrawColor(m_pRenderer, 0, 0, 0, 0);
+			SDL_RenderClear(m_pRenderer);
+		}
+		m_rasterQueue.Submit(m_pRenderer);
+
+		SDL_SetRenderDrawBlendMode(m_pRenderer, prevBlendMode);
+		SDL_SetRenderTarget(m_pRenderer, pPrevTarget);
+	}
+
+	SDL_Rect dstRect = { startX, startY, m_targetWidth, m_targetHeight };
+	queue.AddCopy(RL_DEBUG, m_pTarget, NULL, dstRect);
+}
@@ -0,0 +1,77 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geWalkerDebugView.h
+	Author:		Samuel Prince
+
+	Purpose:	Declaración de la clase geWalkerDebugView
+				Visualización de los estados de los tiles de una
+				búsqueda (abiertos, cerrados y la ruta). Los tiles se
+				dibujan en una textura de render target del tamaño del
+				área de impresión que se conserva entre cuadros; cada
+				cuadro solo se dibujan los tiles que cambiaron de
+				estado, con un límite por cuadro, y la textura se
+				redibuja completa solo si se mueve la cámara, cambia el
+				mapa o se reinicia la búsqueda
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include "geMapGridWalker.h"
+
+/************************************************************************************************************************/
+/* Definición de constantes                                             												*/
+/************************************************************************************************************************/
+#define WALKER_DEBUG_TILES_PER_FRAME	4096	//Tiles cambiados que se dibujan por cuadro por default (el resto espera al siguiente)
+
+/************************************************************************************************************************/
+/* Declaración de la clase geWalkerDebugView                            												*/
+/************************************************************************************************************************/
+class geWalkerDebugView : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor                                             												*/
+	/************************************************************************************************************************/
+public:
+	geWalkerDebugView(void);					//Constructor standard
+	~geWalkerDebugView(void);					//Destructor
+
+	/************************************************************************************************************************/
+	/* Funciones de inicialización y rendereo                               												*/
+	/************************************************************************************************************************/
+public:
+	bool Init(SDL_Renderer* pRenderer, geTiledMap* pMap);
+	void Destroy();
+	void Invalidate() { m_bValid = false; }		//Obliga a redibujar todo (ej. el dispositivo perdió el contenido de los render targets)
+
+	void Render(geRenderQueue& queue, geMapGridWalker* pWalker, const int32 tileBudget = WALKER_DEBUG_TILES_PER_FRAME);	//Dibuja los cambios pendientes del walker y agrega la textura a la capa de depuración
+
+	int32 getNumDrawnTiles() const { return m_numDrawnTiles; }	//Tiles dibujados en el último cuadro
+	static const SDL_Color& getStateColor(const uint8 state);	//Color con el que se dibuja cada estado
+
+	/************************************************************************************************************************/
+	/* Funciones de ayuda internas                                          												*/
+	/************************************************************************************************************************/
+private:
+	bool CheckTarget();							//Crea la textura con el tamaño del área de impresión (regresa false si no se pudo)
+	void AddTile(geRenderQueue& queue, const int32 x, const int32 y, const uint8 state, const int32 offsetX, const int32 offsetY, const bool bDrawNone);	//Agrega el rectángulo que marca el estado del tile
+	void AddVisibleTiles(geRenderQueue& queue, geMapGridWalker* pWalker, const int32 offsetX, const int32 offsetY);	//Agrega todos los tiles visibles con estado
+
+	/************************************************************************************************************************/
+	/* Declaración de variables miembro de la clase                         												*/
+	/************************************************************************************************************************/
+private:
+	SDL_Renderer *m_pRenderer;					//Renderer con el que se crea la textura
+	geTiledMap *m_pMap;							//Mapa sobre el que se dibuja
+	SDL_Texture *m_pTarget;						//Textura con los tiles ya dibujados
+	int32 m_targetWidth, m_targetHeight;		//Tamaño de la textura
+	bool m_bSupported;							//El renderer soporta render targets (si no, cada cuadro se dibujan todos los tiles visibles)
+	bool m_bValid;								//La textura corresponde a m_key y m_pWalker
+	geOverlayKey m_key;							//Cámara, mapa y serie del plano de estados con los que se dibujó la textura
+	geMapGridWalker *m_pWalker;					//Walker que se dibujó en la textura
+	geRenderQueue m_rasterQueue;				//Comandos que se envían a la textura
+	std::vector<int32> m_changedTiles;			//Tiles sacados de la lista de cambios del walker
+	std::vector<geMapRowSpan> m_spans;			//Tiles visibles de cada fila
+	int32 m_numDrawnTiles;						//Tiles dibujados en el último cuadro
+};
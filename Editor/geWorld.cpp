@@ -20,6 +20,7 @@ geWorld::geWorld(void)
 	//Limpiamos las variables miembro
 	m_pTiledMap = NULL;
 	m_pRenderer = NULL;
+	m_activeWalker = NULL;
 	m_activeWalkerIndex = -1;	//Lo inicializamos en -1 indicando que es un índice inválido
 }
 
@@ -44,11 +45,28 @@ bool geWorld::Init(SDL_Renderer* pRenderer)
 	//Primero inicializamos el mapa (Creamos de momento un mapa vacio)
 	m_pTiledMap = GEE_NEW geTiledMap();
 	GEE_ASSERT(m_pTiledMap);
-	m_pTiledMap->Init(pRenderer, 256);
+	m_pTiledMap->Init(pRenderer, 256, 256);
 
-	//BORRAR: Asignamos puntos de prueba para ver que se esté imprimiendo todo el mapa
-	for(int i=0; i<10; i++)
-		m_pTiledMap->setType(i, 0, TT_WALKABLE);
+	//El historial de ediciones parte del estado inicial del mapa
+	m_editHistory.Attach(m_pTiledMap);
+
+	//Inicializamos la visibilidad (de momento solo existe el jugador local)
+	m_fogOfWar.Init(m_pTiledMap, 1);
+
+	//El minimapa muestra la niebla del jugador local
+	m_minimap.Init(pRenderer, m_pTiledMap, &m_fogOfWar, 0);
+
+	//Inicializamos los mapas de influencia (las capas las crea la IA)
+	m_influenceMap.Init(m_pTiledMap);
+
+	//Inicializamos el índice espacial de las unidades
+	m_spatialGrid.Init(m_pTiledMap);
+
+	//Los sistemas de unidades registran sus páginas de atlas y agregan sus sprites cada cuadro
+	m_spriteBatch.Init(m_pTiledMap);
+
+	//Inicializamos el cache de campos de distancia (los objetivos los registra la IA)
+	m_distanceFields.Init(m_pTiledMap);
 
 	//Creamos los algoritmos de pathfinding y los metemos a la lista de Walkers
 	m_walkersList.push_back( GEE_NEW geBreadthFirstSearchMapGridWalker(m_pTiledMap) );
@@ -62,12 +80,28 @@ bool geWorld::Init(SDL_Renderer* pRenderer)
 	//Establecemos el algoritmo que vamos a utilizar
 	setCurrentWalker(0);
 
+	//La visualización de las búsquedas dibuja sobre el área de impresión del mapa
+	m_walkerDebugView.Init(pRenderer, m_pTiledMap);
+
 	return true;
 }
 
 void geWorld::Destroy()
 {//
+	//Detenemos cualquier carga del mapa antes de destruir los objetos que utiliza
+	m_mapLoader.Cancel();
+	m_mapAnalysisWorker.Cancel();
+	m_editHistory.Attach(NULL);
+	m_minimap.Destroy();
+	m_fogOfWar.Destroy();
+	m_influenceMap.Destroy();
+	m_spriteBatch.Destroy();
+	m_spatialGrid.Destroy();
+	m_distanceFields.Destroy();
+	m_mapAnalysis.Destroy();
+
 	//Destruimos los sistemas de pathfinding
+	m_walkerDebugView.Destroy();
 	while(m_walkersList.size() > 0)
 	{
 		GEE_DELETE m_walkersList.back();
@@ -80,13 +114,97 @@ void geWorld::Destroy()
 
 void geWorld::Update(float deltaTime)
 {
+	//Avanzamos la carga asíncrona del mapa
+	bool bWasLoading = m_mapLoader.isLoading();
+	if( m_mapLoader.Update() )
+	{//El mapa fue reinicializado con un nuevo tamaño, reinicializamos los algoritmos que dependen de él
+		for(SIZE_T it=0; it<m_walkersList.size(); it++)
+		{
+			m_walkersList[it]->Init();
+		}
+
+		//Reestablecemos el área de impresión del mapa
+		UpdateResolutionData();
+	}
+
 	m_pTiledMap->Update(deltaTime);		//Actualizamos los datos del mapa
+	m_fogOfWar.Update();				//Actualizamos la visibilidad con los cambios del mapa y de los observadores
+	m_minimap.Update();					//Recalculamos los pixeles del minimapa bajo los cambios del mapa y de la visión
+	m_influenceMap.Update(INFLUENCE_DEFAULT_ROW_BUDGET);	//Avanzamos la propagación de la influencia con un límite de filas por ciclo
+	m_distanceFields.Update();			//Marcamos como obsoletos los campos de distancia que tocan los cambios del mapa
+	m_spatialGrid.Update();				//Ajustamos las celdas al mapa y reordenamos las unidades si se usa el modo ordenado
+
+	if( bWasLoading && !m_mapLoader.isLoading() )
+	{//La carga terminó, el mapa cargado es el punto de partida del historial de ediciones
+		m_editHistory.Reset();
+
+		//El análisis de regiones se lee del cache o se calcula en un hilo de trabajo, el análisis anterior ya no corresponde al mapa
+		m_mapAnalysis.Destroy();
+		if( m_mapLoader.getState() == geTiledMapStreamLoader::LS_FINISHED )
+		{
+			m_mapAnalysisWorker.Begin(m_pTiledMap, m_mapFileName + ANALYSIS_CACHE_EXTENSION);
+		}
+	}
+
+	m_mapAnalysisWorker.Publish(m_mapAnalysis);	//Tomamos el análisis cuando el hilo termina
+
+	//Si la tabla de costos de la clase analizada cambió, repetimos el análisis (si la transitabilidad no cambió se resuelve con el cache)
+	if( m_mapAnalysis.isValid() && !m_mapAnalysisWorker.isBusy() && !m_mapLoader.isLoading() &&
+		m_mapAnalysis.getCostVersion() != m_pTiledMap->getCostVersion(m_mapAnalysis.getMovementClass()) )
+	{
+		m_mapAnalysisWorker.Begin(m_pTiledMap, m_mapFileName + ANALYSIS_CACHE_EXTENSION, m_mapAnalysis.getMovementClass());
+	}
+}
+
+bool geWorld::StreamMapFromImageFile(const geString& fileName)
+{//Comienza la carga asíncrona de un mapa
+	GEE_ASSERT(m_pTiledMap);
+	m_mapAnalysisWorker.Cancel();		//El análisis en proceso es del mapa anterior
+	m_mapFileName = fileName;
+	return m_mapLoader.BeginLoad(m_pTiledMap, m_pRenderer, fileName);
+}
+
+void geWorld::FillMapRect(const geMapRegion& region, const uint8 idtype)
+{//Los cambios pendientes (ej. un trazo) y el relleno quedan como dos ediciones distintas
+	m_editHistory.CommitEdit();
+	m_pTiledMap->FillRect(region, idtype);
+	m_editHistory.CommitEdit();
+}
+
+void geWorld::StampMapBrush(const int32 x, const int32 y, const uint8* pMask, const int32 maskWidth, const int32 maskHeight, const uint8 idtype)
+{//Los estampados de un mismo trazo se acumulan en una sola edición hasta que se llame a EndMapEdit()
+	m_pTiledMap->StampBrush(x, y, pMask, maskWidth, maskHeight, idtype);
+}
+
+geMapRegion geWorld::FloodFillMap(const int32 x, const int32 y, const uint8 idtype)
+{
+	m_editHistory.CommitEdit();
+	geMapRegion region = m_pTiledMap->FloodFill(x, y, idtype);
+	m_editHistory.CommitEdit();
+	return region;
+}
+
+void geWorld::PasteMapBlock(const int32 x, const int32 y, const geMapBlock& block)
+{
+	m_editHistory.CommitEdit();
+	m_pTiledMap->PasteBlock(x, y, block);
+	m_editHistory.CommitEdit();
 }
 
-void geWorld::Render()
+void geWorld::Render(geRenderQueue& queue)
 {
 	//Imprimimos el mapa
-	m_pTiledMap->Render();
+	m_pTiledMap->Render(queue);
+
+	//Imprimimos las unidades de atrás hacia adelante (el lote se vacía para el siguiente cuadro)
+	m_spriteBatch.Submit(queue, RL_UNITS);
+
+	//Imprimimos la información de depuración del pathfinding activo
+	if( m_activeWalker != NULL )
+	{
+		m_walkerDebugView.Render(queue, m_activeWalker);	//Estados de los tiles (solo se dibujan los que cambiaron)
+		m_activeWalker->Render(queue);						//Inicio, fin y ruta
+	}
 }
 
 void geWorld::UpdateResolutionData()
@@ -22,10 +22,22 @@ private:
 	
 	//Variables de Mapa
 	geTiledMap *m_pTiledMap;						//Mapa asociado al mundo
+	geTiledMapStreamLoader m_mapLoader;				//Cargador asíncrono del mapa
+	geMapEditHistory m_editHistory;					//Historial de ediciones del mapa
+	geFogOfWar m_fogOfWar;							//Visibilidad de cada jugador sobre el mapa
+	geMinimap m_minimap;							//Imagen reducida del mapa con la niebla del jugador local
+	geInfluenceMap m_influenceMap;					//Mapas de influencia para la IA
+	geSpatialGrid m_spatialGrid;					//Índice espacial de las unidades para consultas de rango
+	geSpriteBatch m_spriteBatch;					//Sprites de las unidades del cuadro (se imprimen ordenados por profundidad)
+	geDistanceFieldCache m_distanceFields;			//Campos de distancia hacia objetivos frecuentes
+	geMapAnalysis m_mapAnalysis;					//Regiones y pasos estrechos del mapa (vacío hasta que el hilo de análisis publica su resultado)
+	geMapAnalysisWorker m_mapAnalysisWorker;		//Hilo que lee del cache o calcula el análisis del mapa cargado
+	geString m_mapFileName;							//Archivo del mapa que se está cargando (el cache del análisis se guarda junto a él)
 
 	//Variables de Pathfinding
 	std::vector<geMapGridWalker*> m_walkersList;	//Lista de Walkers capaces de hacer pathfinding (cada uno tiene un algoritmo diferente)
 	geMapGridWalker *m_activeWalker;				//Puntero al Walker activo (que algoritmo estamos usando para pathfinding)
+	geWalkerDebugView m_walkerDebugView;			//Visualización de los estados de los tiles de la búsqueda del Walker activo
 	int8 m_activeWalkerIndex;						//Indice en la lista perteneciente al algoritmo utilizado en este momento
 	
 	uint16 m_AppResolutionX;						//Resolución de la aplicación en X
@@ -45,12 +57,36 @@ public:
 	bool Init(SDL_Renderer* pRenderer);		//Inicialización de la clase
 	void Destroy();							//Destrucción de objetos de la clase
 	void Update(float deltaTime);			//Actualización
-	void Render();							//Impresión de objetos
+	void Render(geRenderQueue& queue);		//Impresión de objetos (agrega los comandos de dibujo a la lista)
 
 	/************************************************************************************************************************/
 	/* Accesores                                                            												*/
 	/************************************************************************************************************************/
 	geTiledMap* getTiledMap(){ return m_pTiledMap; }
+	geTiledMapStreamLoader* getMapLoader(){ return &m_mapLoader; }
+	geMapEditHistory* getEditHistory(){ return &m_editHistory; }
+	geFogOfWar* getFogOfWar(){ return &m_fogOfWar; }
+	geMinimap* getMinimap(){ return &m_minimap; }
+	geInfluenceMap* getInfluenceMap(){ return &m_influenceMap; }
+	geSpatialGrid* getSpatialGrid(){ return &m_spatialGrid; }
+	geSpriteBatch* getSpriteBatch(){ return &m_spriteBatch; }
+	geDistanceFieldCache* getDistanceFields(){ return &m_distanceFields; }
+	geMapAnalysis* getMapAnalysis(){ return &m_mapAnalysis; }
+	geWalkerDebugView* getWalkerDebugView(){ return &m_walkerDebugView; }
+
+	/************************************************************************************************************************/
+	/* Funciones de carga del mapa                                          												*/
+	/************************************************************************************************************************/
+	bool StreamMapFromImageFile(const geString& fileName);	//Comienza la carga del mapa en un hilo de trabajo (el mapa se va llenando por chunks)
+
+	/************************************************************************************************************************/
+	/* Funciones de edición del mapa (cada operación en bloque se guarda como una edición que se deshace por separado)		*/
+	/************************************************************************************************************************/
+	void EndMapEdit() { m_pTiledMap->FlushDerivedPlanes(); m_editHistory.CommitEdit(); }	//Cierra la edición en curso (ej. al soltar el botón al terminar un trazo del pincel)
+	void FillMapRect(const geMapRegion& region, const uint8 idtype);
+	void StampMapBrush(const int32 x, const int32 y, const uint8* pMask, const int32 maskWidth, const int32 maskHeight, const uint8 idtype);	//Un trazo puede estampar muchas veces, la edición se cierra con EndMapEdit()
+	geMapRegion FloodFillMap(const int32 x, const int32 y, const uint8 idtype);
+	void PasteMapBlock(const int32 x, const int32 y, const geMapBlock& block);
 
 	/************************************************************************************************************************/
 	/* Funciones de control de resolución de la aplicación																	*/
@@ -12,6 +12,8 @@
 /************************************************************************************************************************/
 #include "geCoreStd.h"		//Incluimos la librería de geCore
 
+//NOTA: Los proyectos que solo compilan los módulos del mapa (ej. Unit_Tests) definen GEE_EDITOR_MAP_MODULES para no depender de LUA, ToLua ni la interfaz
+#ifndef GEE_EDITOR_MAP_MODULES
 /************************************************************************************************************************/
 /* Incluimos las cabeceras necesarias para utilizar LUA																	*/
 /************************************************************************************************************************/
@@ -21,6 +23,7 @@
 /* Incluimos las cabeceras necesarias para utilizar ToLua																*/
 /************************************************************************************************************************/
 #include "tolua.h"
+#endif
 
 /************************************************************************************************************************/
 /* Incluimos los archivos de cabecera requeridos por la aplicación      												*/
@@ -32,23 +35,47 @@
 /************************************************************************************************************************/
 /* Incluimos cabeceras de los archivos específicos de la aplicación		  												*/
 /************************************************************************************************************************/
+#include "geRenderQueue.h"						//Lista de comandos de dibujo
+#include "geOverlayBatch.h"						//Líneas de depuración generadas una vez y reenviadas cada cuadro
 #include "geTexture.h"							//Clase de texturas SDL
+#include "geTextureLoader.h"						//Decodificación de imágenes en un hilo de trabajo
+#include "geTextureManager.h"					//Cache compartido de texturas
 
+#ifndef GEE_EDITOR_MAP_MODULES
 #include "geGUI.h"								//Manejo de la inteface gráfica de usuario
+#endif
+#include "geMapViewSpans.h"						//Cálculo de los tiles visibles por fila
+#include "geTerrainAtlas.h"						//Atlas con las imágenes del terreno
+#include "geTerrainChunkCache.h"					//Terreno pre-rendereado por chunk
 #include "geTiledMap.h"							//Manejo del mapa
+#include "geMapEditHistory.h"					//Historial de ediciones del mapa (deshacer y rehacer)
+#ifndef GEE_EDITOR_MAP_MODULES
+#include "geTiledMapStreamLoader.h"				//Carga asíncrona de mapas por chunks
+#include "geFogOfWar.h"							//Visibilidad por jugador (niebla de guerra)
+#include "geMinimap.h"							//Minimapa con actualización incremental
+#include "geInfluenceMap.h"						//Mapas de influencia para la IA
+#include "geSpatialGrid.h"						//Índice espacial de unidades
+#include "geSpriteBatch.h"						//Sprites de unidades ordenados por profundidad
+#include "geDistanceFieldCache.h"				//Campos de distancia hacia objetivos frecuentes
+#include "geMapAnalysis.h"						//Análisis de regiones y pasos estrechos del mapa
+#include "geMapAnalysisWorker.h"					//Análisis del mapa en un hilo de trabajo
 #include "geMapTileNode.h"						//Objetos de nodos del mapa para Pathfinding
 #include "geMapGridWalker.h"					//Clase base para algoritmos de Pathfinding
 #include "geBreadthFirstSearchMapGridWalker.h"	//Implementación de Breadth First Search para Pathfinding
+#include "geWalkerDebugView.h"					//Visualización incremental de las búsquedas de los walkers
 #include "geWorld.h"							//Al final incluimos mundo ya que depende de las cabeceras anteriores
+#endif
 
 /************************************************************************************************************************/
 /* Incluimos las librerías que deben ligarse                            												*/
 /************************************************************************************************************************/
-#pragma comment(lib, "AntTweakBar.lib")
-#pragma comment(lib, "TinyXml.lib")
 #pragma comment(lib, "geCore.lib")
 #pragma comment(lib, "SDL2.lib")
 #pragma comment(lib, "SDL2_image.lib")
+#ifndef GEE_EDITOR_MAP_MODULES
+#pragma comment(lib, "AntTweakBar.lib")
+#pragma comment(lib, "TinyXml.lib")
 #pragma comment(lib, "liblua.lib")
 #pragma comment(lib, "tolua.lib")
+#endif
 //#pragma comment(lib, "pthread.lib")
\ No newline at end of file
@@ -15,6 +15,10 @@
 #include <sstream>
 #include <chrono>
 #include <vld.h>
+#include "../Editor/geMapViewSpans.h"		//Módulos del editor que se prueban
+#include "../Editor/geTiledMap.h"
+#include "../Editor/geMapEditHistory.h"
+#include "../Editor/geMinimap.h"
 
 //Forward declarations
 void memtest1();
@@ -23,6 +27,11 @@ void memtest2();
 void dynmemtest1();
 void dynmemtest2();
 
+bool TestMapViewSpans();
+bool TestMapEditHistory();
+bool TestTerrainChunkCache();
+bool TestMinimapDownsample();
+
 unsigned char g_HugeMemoryChunk[4096][4096];
 
 float luisLog(const float &X, const int &presicion)
@@ -137,11 +146,311 @@ static __forceinline float WinInvSqrt( float F )
 	return 1.0f/sqrt(F);
 }
 
+bool TestMapViewSpans()
+{//Compara los rangos por fila de ComputeMapViewSpans contra la prueba tile por tile en vistas aleatorias
+	std::vector<geMapRowSpan> spans;
+	std::vector<uint8> visible;
+	srand(12345);
+
+	for( int32 test=0; test<2000; ++test )
+	{
+		geMapView view;
+		view.bIsometric = (test & 1) != 0;
+		view.tileShiftX = 6;
+		view.tileShiftY = view.bIsometric ? 5 : 6;
+		view.mapWidth = 1 + rand()%96;
+		view.mapHeight = 1 + rand()%96;
+		view.startX = rand()%256;
+		view.startY = rand()%256;
+		view.endX = view.startX + rand()%1280;
+		view.endY = view.startY + rand()%1024;
+		view.defaceX = (rand()%8192) - 4096;
+		view.defaceY = (rand()%8192) - 4096;
+
+		int32 numTiles = ComputeMapViewSpans(view, spans);
+
+		//Marcamos los tiles que cubren los rangos
+		visible.assign(view.mapWidth*view.mapHeight, 0);
+		int32 lastY = -1;
+		for( SIZE_T i=0; i<spans.size(); ++i )
+		{
+			if( spans[i].y <= lastY )
+			{//Las filas deben venir en orden y sin repetirse
+				std::cout << "ComputeMapViewSpans: filas desordenadas en la prueba " << test << std::endl;
+				return false;
+			}
+			lastY = spans[i].y;
+
+			for( int32 x=spans[i].iniX; x<=spans[i].finX; ++x )
+			{
+				visible[(spans[i].y*view.mapWidth)+x] = 1;
+			}
+		}
+
+		//Cada tile debe estar en un rango si y solo si la prueba directa dice que es visible
+		int32 numVisible = 0;
+		for( int32 y=0; y<view.mapHeight; ++y )
+		{
+			for( int32 x=0; x<view.mapWidth; ++x )
+			{
+				bool bVisible = isMapViewTileVisible(view, x, y);
+				numVisible += bVisible ? 1 : 0;
+				if( bVisible != (visible[(y*view.mapWidth)+x] != 0) )
+				{
+					std::cout << "ComputeMapViewSpans: el tile " << x << "," << y << " no coincide en la prueba " << test << std::endl;
+					return false;
+				}
+			}
+		}
+
+		if( numVisible != numTiles )
+		{
+			std::cout << "ComputeMapViewSpans: número de tiles incorrecto en la prueba " << test << std::endl;
+			return false;
+		}
+	}
+
+	std::cout << "ComputeMapViewSpans: OK" << std::endl;
+	return true;
+}
+
+bool TestMapEditHistory()
+{//Dos ediciones separadas por CommitEdit() deben deshacerse y rehacerse una por una
+	geTiledMap map;
+	map.Init(NULL, 32, 32);		//Sin renderer, todos los tiles comienzan como TT_WALKABLE
+	geMapEditHistory history;
+	history.Attach(&map);
+
+	map.FillRect(geMapRegion(0, 0, 3, 3), TT_WATER);
+	history.CommitEdit();
+	map.FillRect(geMapRegion(2, 2, 5, 5), TT_MARSH);
+	history.CommitEdit();
+
+	//La primera vez solo se deshace el segundo relleno (el tile 2,2 regresa al agua del primero)
+	if( !history.Undo() || map.getType(4, 4) != TT_WALKABLE || map.getType(2, 2) != TT_WATER || map.getType(0, 0) != TT_WATER )
+	{
+		std::cout << "geMapEditHistory: el primer Undo no regresó solo la última edición" << std::endl;
+		return false;
+	}
+
+	if( !history.Undo() || map.getType(0, 0) != TT_WALKABLE || map.getType(2, 2) != TT_WALKABLE || history.canUndo() )
+	{
+		std::cout << "geMapEditHistory: el segundo Undo no regresó la primera edición" << std::endl;
+		return false;
+	}
+
+	if( !history.Redo() || map.getType(0, 0) != TT_WATER || map.getType(4, 4) != TT_WALKABLE || !history.canRedo() )
+	{
+		std::cout << "geMapEditHistory: el Redo no rehízo solo la primera edición" << std::endl;
+		return false;
+	}
+
+	history.Attach(NULL);
+	std::cout << "geMapEditHistory: OK" << std::endl;
+	return true;
+}
+
+//Tolerancia por canal al comparar el terreno (la imagen del terreno tiene unos pocos pixeles semitransparentes en el borde del rombo, que con el cache se mezclan dos veces)
+#define CHUNK_CACHE_TEST_TOLERANCE 16
+
+static void RenderTerrainPixels(geTiledMap& map, SDL_Renderer* pRenderer, const int32 width, const int32 height, std::vector<uint32>& pixels)
+{//Imprime el terreno sobre fondo negro y lee los pixeles resultantes
+	SDL_SetRenderDrawColor(pRenderer, 0, 0, 0, 0xFF);
+	SDL_RenderClear(pRenderer);
+
+	geRenderQueue queue;
+	map.Render(queue);
+	queue.Submit(pRenderer);
+
+	pixels.resize(width*height);
+	SDL_RenderReadPixels(pRenderer, NULL, SDL_PIXELFORMAT_ARGB8888, &pixels[0], width*sizeof(uint32));
+}
+
+static bool CheckTerrainChunkCacheFrame(geTiledMap& map, SDL_Renderer* pRenderer, const int32 width, const int32 height, const char* pStep, const int32 expectedRasterized)
+{//Imprime un cuadro con el cache y otro tile por tile, los pixeles deben coincidir y el cache solo debe rasterizar los chunks esperados
+	std::vector<uint32> cached, direct;
+	geTerrainChunkCache& cache = map.getChunkCache();
+
+	RenderTerrainPixels(map, pRenderer, width, height, cached);
+	int32 numRasterized = cache.getNumRasterized();
+
+	cache.setEnabled(false);
+	RenderTerrainPixels(map, pRenderer, width, height, direct);
+	cache.setEnabled(true);
+
+	if( numRasterized != expectedRasterized )
+	{
+		std::cout << "geTerrainChunkCache: se rasterizaron " << numRasterized << " chunks en lugar de " << expectedRasterized << " (" << pStep << ")" << std::endl;
+		return false;
+	}
+
+	for( SIZE_T i=0; i<cached.size(); ++i )
+	{
+		for( int32 shift=0; shift<32; shift+=8 )
+		{
+			int32 diff = (int32)((cached[i]>>shift) & 0xFF) - (int32)((direct[i]>>shift) & 0xFF);
+			if( diff > CHUNK_CACHE_TEST_TOLERANCE || diff < -CHUNK_CACHE_TEST_TOLERANCE )
+			{
+				std::cout << "geTerrainChunkCache: el pixel " << (i%width) << "," << (i/width) << " no coincide con el impreso tile por tile (" << pStep << ")" << std::endl;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool TestTerrainChunkCache()
+{//El terreno impreso con el cache de chunks debe verse igual que el impreso tile por tile, también despues de editar y de perder los render targets
+	//Un mapa de 2x2 chunks cabe completo en la superficie con la cámara en el origen (el tile 0,0 queda al centro), así los chunks se imprimen en el mismo orden que los tiles
+	const int32 mapSize = 2*MAP_CHUNK_SIZE;
+	const int32 width = (2*mapSize+2)*TILEHALFSIZE_X;
+	const int32 height = width;
+
+	SDL_Surface* pSurface = SDL_CreateRGBSurface(0, width, height, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+	SDL_Renderer* pRenderer = (pSurface != NULL) ? SDL_CreateSoftwareRenderer(pSurface) : NULL;
+	if( pRenderer == NULL )
+	{
+		std::cout << "geTerrainChunkCache: no se pudo crear el renderer por software: " << SDL_GetError() << std::endl;
+		if( pSurface != NULL )
+		{
+			SDL_FreeSurface(pSurface);
+		}
+		return false;
+	}
+	g_TextureManager.Init(pRenderer);
+
+	bool bPassed = true;
+	{//El mapa debe destruirse antes que el cache de texturas
+		geTiledMap map;
+		map.Init(pRenderer, mapSize, mapSize);
+		map.setStart(0, 0);
+		map.setEnd(width, height);
+		map.moveCamera(0, 0);
+
+		//Las imágenes del terreno se decodifican en un hilo de trabajo, esperamos a que se suban igual que lo haría el ciclo principal del editor
+		for( int32 wait=0; wait<5000 && map.isTerrainLoading(); ++wait )
+		{
+			g_TextureManager.UpdateUploads();
+			map.Update(0.f);
+			SDL_Delay(1);
+		}
+
+		//Además de la textura provisional debe haber al menos otra en el cache (el atlas o las texturas por tipo)
+		if( map.isTerrainLoading() || g_TextureManager.getNumTextures() < 2 || !map.getChunkCache().isEnabled() )
+		{//Las texturas del terreno se buscan relativas al directorio de trabajo (Bin)
+			std::cout << "geTerrainChunkCache: no se cargaron las texturas del terreno o el renderer no soporta render targets" << std::endl;
+			bPassed = false;
+		}
+		else
+		{
+			map.FillRect(geMapRegion(3, 3, 20, 9), TT_WATER);
+			map.FillRect(geMapRegion(10, 14, mapSize-4, mapSize-2), TT_MARSH);
+			map.Update(0.f);
+
+			//El primer cuadro rasteriza todos los chunks y el siguiente ya no rasteriza nada
+			bPassed = CheckTerrainChunkCacheFrame(map, pRenderer, width, height, "primer cuadro", 4) &&
+					  CheckTerrainChunkCacheFrame(map, pRenderer, width, height, "sin cambios", 0);
+
+			//Editar un tile solo debe volver a rasterizar su chunk
+			map.setType(MAP_CHUNK_SIZE+4, 5, TT_OBSTACLE);
+			bPassed = bPassed && CheckTerrainChunkCacheFrame(map, pRenderer, width, height, "edición", 1);
+
+			//Lo mismo que hace el editor con SDL_RENDER_TARGETS_RESET: todos los chunks se rasterizan de nuevo
+			map.getChunkCache().Invalidate();
+			bPassed = bPassed && CheckTerrainChunkCacheFrame(map, pRenderer, width, height, "render targets perdidos", 4);
+		}
+	}
+
+	g_TextureManager.Destroy();
+	SDL_DestroyRenderer(pRenderer);
+	SDL_FreeSurface(pSurface);
+
+	if( bPassed )
+	{
+		std::cout << "geTerrainChunkCache: OK" << std::endl;
+	}
+	return bPassed;
+}
+
+static bool CompareMinimaps(const geMinimap& simd, const geMinimap& scalar)
+{//Las dos imágenes deben ser idénticas byte por byte
+	SIZE_T bytes = simd.getWidth()*simd.getHeight()*sizeof(uint32);
+	return	simd.getWidth() == scalar.getWidth() && simd.getHeight() == scalar.getHeight() &&
+			memcmp(simd.getTerrainPixels(), scalar.getTerrainPixels(), bytes) == 0 &&
+			memcmp(simd.getPixels(), scalar.getPixels(), bytes) == 0;
+}
+
+bool TestMinimapDownsample()
+{//El filtro de caja en SSE2 debe dar exactamente lo mismo que el de referencia, también con bloques incompletos en las orillas
+	struct MinimapCase
+	{
+		int32 mapWidth, mapHeight, shift;
+	};
+	const MinimapCase cases[] =
+	{
+		{ 37, 23, 2 }, { 50, 17, 3 }, { 33, 65, 4 }, { 5, 3, 2 }, { 7, 9, 0 }, { 129, 31, 1 }, { 64, 64, 4 }
+	};
+	srand(54321);
+
+	for( SIZE_T test=0; test<sizeof(cases)/sizeof(cases[0]); ++test )
+	{
+		const MinimapCase& c = cases[test];
+		geTiledMap map;
+		map.Init(NULL, c.mapWidth, c.mapHeight);
+		for( int32 y=0; y<c.mapHeight; ++y )
+		{
+			for( int32 x=0; x<c.mapWidth; ++x )
+			{
+				map.setType(x, y, (uint8)(rand()%TT_NUM_OBJECTS));
+			}
+		}
+		map.Update(0.f);
+
+		//Ambos filtros leen el mismo mapa
+		geMinimap simd, scalar;
+		simd.Init(NULL, &map, NULL, 0, c.shift);
+		scalar.Init(NULL, &map, NULL, 0, c.shift);
+		simd.Rebuild(true);
+		scalar.Rebuild(false);
+		if( !CompareMinimaps(simd, scalar) )
+		{
+			std::cout << "geMinimap: la imagen completa en SSE2 no coincide con la de referencia en la prueba " << test << std::endl;
+			return false;
+		}
+
+		//Una edición que empieza y termina a mitad de bloque solo recalcula en SSE2 los pixeles que toca
+		map.FillRect(geMapRegion(c.mapWidth/3, c.mapHeight/4, (c.mapWidth*2)/3, c.mapHeight-2), TT_MARSH);
+		map.Update(0.f);
+		simd.Update();
+		scalar.Rebuild(false);
+		if( !CompareMinimaps(simd, scalar) )
+		{
+			std::cout << "geMinimap: la región actualizada en SSE2 no coincide con la de referencia en la prueba " << test << std::endl;
+			return false;
+		}
+	}
+
+	std::cout << "geMinimap: OK" << std::endl;
+	return true;
+}
+
 #define NUM_ITERACIONES_SQRT 13107200*4
 float matriz_sqrts[NUM_ITERACIONES_SQRT];
 
 int32 _tmain(int32, TCHAR**)
 {
+	//Si falla alguna prueba salimos con un código distinto de 0 (sin correr las mediciones ni esperar al usuario)
+	bool bPassed = TestMapViewSpans();
+	bPassed = TestMapEditHistory() && bPassed;
+	bPassed = TestTerrainChunkCache() && bPassed;
+	bPassed = TestMinimapDownsample() && bPassed;
+	if( !bPassed )
+	{
+		std::cout << "Fallaron las pruebas" << std::endl;
+		return 1;
+	}
+
 	memtest1();
 	memtest2();
 
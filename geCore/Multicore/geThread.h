@@ -0,0 +1,95 @@
+/********************************************************************
+	Created:	2026/10/19
+	Filename:	geThread.h
+	Author:		Samuel Prince
+
+	Purpose:	Define una clase base para crear hilos de trabajo
+				Las clases derivadas implementan Run() con el
+				trabajo que debe hacerse fuera del hilo principal
+*********************************************************************/
+#pragma once
+
+/************************************************************************************************************************/
+/* Inclusión de cabeceras requeridas                                    												*/
+/************************************************************************************************************************/
+#include <process.h>
+
+/************************************************************************************************************************/
+/* Declaración de la clase geThread (este tipo de objetos no debe ser copiable)											*/
+/************************************************************************************************************************/
+class geThread : public GEE_noncopyable
+{
+	/************************************************************************************************************************/
+	/* Constructor y destructor virtual                                     												*/
+	/************************************************************************************************************************/
+public:
+	geThread()
+	{//Constructor
+		m_hThread = NULL;
+		m_threadID = 0;
+		m_bStopRequested = 0;
+	}
+
+	virtual ~geThread()
+	{//Destructor (el hilo debe haber terminado antes de destruir el objeto)
+		Join();
+	}
+
+	/************************************************************************************************************************/
+	/* Funciones de control del hilo                                        												*/
+	/************************************************************************************************************************/
+public:
+	bool Start()
+	{//Crea el hilo y comienza a ejecutar Run() en él
+		if( m_hThread != NULL )
+		{//Este hilo ya está corriendo
+			return false;
+		}
+
+		InterlockedExchange(&m_bStopRequested, 0);
+
+		//Utilizamos _beginthreadex en lugar de CreateThread para que la librería de C inicialice sus datos por hilo
+		m_hThread = (HANDLE)_beginthreadex(NULL, 0, &geThread::ThreadProc, this, 0, &m_threadID);
+		return m_hThread != NULL;
+	}
+
+	void RequestStop()
+	{//Pide al hilo que termine (Run() debe revisar IsStopRequested() periódicamente)
+		InterlockedExchange(&m_bStopRequested, 1);
+	}
+
+	void Join()
+	{//Espera a que el hilo termine y libera su manejador
+		if( m_hThread != NULL )
+		{
+			WaitForSingleObject(m_hThread, INFINITE);
+			CloseHandle(m_hThread);
+			m_hThread = NULL;
+			m_threadID = 0;
+		}
+	}
+
+	bool IsRunning() const
+	{//Indica si el hilo fue creado y aún no termina su ejecución
+		return (m_hThread != NULL) && (WaitForSingleObject(m_hThread, 0) == WAIT_TIMEOUT);
+	}
+
+	bool IsStopRequested() const { return m_bStopRequested != 0; }
+
+protected:
+	virtual uint32 Run() = 0;	//Función que se ejecuta en el hilo de trabajo
+
+private:
+	static unsigned __stdcall ThreadProc(void* pParam)
+	{//Punto de entrada del hilo, solo redirige a la función virtual
+		return static_cast<geThread*>(pParam)->Run();
+	}
+
+	/************************************************************************************************************************/
+	/* Declaración de las variables de la clase                             												*/
+	/************************************************************************************************************************/
+private:
+	HANDLE m_hThread;					//Manejador del hilo
+	unsigned m_threadID;				//Identificador del hilo
+	volatile LONG m_bStopRequested;		//Bandera para pedir al hilo que termine
+};
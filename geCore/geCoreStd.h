@@ -126,6 +126,10 @@ using fastdelegate::MakeDelegate;
 #include "Utilities/BasicTypes.h"		//Incluimos las clases de tipos básicos
 #include "Utilities/String.h"			//Incluimos las clases de ayuda para manejo de Strings
 
+//Clases de ayuda para programación multithread
+#include "Multicore/CriticalSection.h"	//Secciones críticas y queue concurrente
+#include "Multicore/geThread.h"			//Clase base para hilos de trabajo
+
 //Clases matemáticas
 #include "Math/geFloat32.h"				//Definimos un tipo flotante de 32 bits
 #include "Math/geFloat16.h"				//Definimos un tipo flotante de 16 bits